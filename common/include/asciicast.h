@@ -0,0 +1,109 @@
+/**************************************************************************************************/
+/**
+ * @file asciicast.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Streaming asciicast v2 recorder shared by the cube, shape and dino renderers.
+ *
+ *        Frames are delta-encoded against the last recorded frame on the render thread and pushed
+ *        into a lock-free single-producer/single-consumer ring. A background writer thread turns
+ *        them into asciicast events and writes them to disk in large batches. When the ring is
+ *        full the frame is dropped instead of blocking the render loop.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef ASCIICAST_H
+#define ASCIICAST_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef struct asciicast_recorder asciicast_recorder;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    asciicast_recorder_open
+ * @brief   Creates the cast file, writes the asciicast v2 header and starts the writer thread.
+ *
+ * @param   file_path       Path of the .cast file to create (truncated if it exists)
+ * @param   frame_width     Number of columns in every frame that will be pushed
+ * @param   frame_height    Number of rows in every frame that will be pushed
+ *
+ * @return  asciicast_recorder*  The recorder, or NULL if the file or thread could not be created
+ */
+/**************************************************************************************************/
+asciicast_recorder *asciicast_recorder_open(const char *file_path, int frame_width,
+                                            int frame_height);
+
+/**************************************************************************************************/
+/**
+ * @name    asciicast_recorder_push_frame
+ * @brief   Delta-encodes a frame against the last recorded one and queues it for the writer.
+ *
+ *          Never blocks. If the writer has fallen behind and the ring cannot hold the encoded
+ *          frame, the frame is dropped and the next one is encoded against the last frame that
+ *          was actually queued, so playback stays consistent.
+ *
+ * @param   recorder        Recorder returned by asciicast_recorder_open (NULL is ignored)
+ * @param   frame           frame_height rows of frame_width characters, row-major and contiguous
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void asciicast_recorder_push_frame(asciicast_recorder *recorder, const char *frame);
+
+/**************************************************************************************************/
+/**
+ * @name    asciicast_recorder_dropped_frames
+ * @brief   Returns how many frames were dropped because the writer thread fell behind.
+ *
+ * @param   recorder
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+uint64_t asciicast_recorder_dropped_frames(const asciicast_recorder *recorder);
+
+/**************************************************************************************************/
+/**
+ * @name    asciicast_recorder_recorded_frames
+ * @brief   Returns how many frames were queued for writing.
+ *
+ * @param   recorder
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+uint64_t asciicast_recorder_recorded_frames(const asciicast_recorder *recorder);
+
+/**************************************************************************************************/
+/**
+ * @name    asciicast_recorder_close
+ * @brief   Drains every queued frame to disk, stops the writer thread and closes the file.
+ *
+ * @param   recorder        Recorder to close (NULL is ignored)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void asciicast_recorder_close(asciicast_recorder *recorder);
+
+#endif // ASCIICAST_H
+
+// End of asciicast.h
@@ -0,0 +1,483 @@
+/**************************************************************************************************/
+/**
+ * @file asciicast.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Streaming asciicast v2 recorder with delta frames and a background writer thread.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "asciicast.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define ASCIICAST_RING_CAPACITY             (1u << 20)  // Must be a power of two
+#define ASCIICAST_WRITE_BATCH_BYTES         (64 * 1024)
+#define ASCIICAST_MINIMUM_WRITE_CAPACITY    (256 * 1024)
+#define ASCIICAST_WRITER_IDLE_NANOSECONDS   10000000L
+
+// Rewriting up to this many unchanged cells is cheaper than a cursor move escape sequence
+#define ASCIICAST_MAXIMUM_REWRITE_GAP       8
+#define ASCIICAST_CURSOR_MOVE_MAX_BYTES     16
+
+// Every payload byte expands to at most six bytes ("\u001b") when escaped as a JSON string
+#define ASCIICAST_JSON_ESCAPE_MAX_EXPANSION 6
+#define ASCIICAST_EVENT_OVERHEAD_BYTES      64
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef struct
+{
+    uint64_t timestamp_nanoseconds;
+    uint32_t payload_length;
+    uint32_t reserved;
+} asciicast_ring_record_header;
+
+struct asciicast_recorder
+{
+    int file_descriptor;
+    int frame_width;
+    int frame_height;
+    struct timespec start_time;
+
+    // Owned by the render (producer) thread
+    char *previous_frame;
+    char *encode_buffer;
+    size_t encode_capacity;
+    bool first_frame_pending;
+
+    // Shared between the producer and the writer thread
+    unsigned char *ring;
+    _Atomic uint64_t ring_head;
+    _Atomic uint64_t ring_tail;
+    _Atomic bool writer_running;
+    _Atomic uint64_t dropped_frames;
+    _Atomic uint64_t recorded_frames;
+    pthread_t writer_thread;
+
+    // Owned by the writer thread
+    char *write_buffer;
+    size_t write_length;
+    size_t write_capacity;
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    encode_frame_delta
+ * @brief   Writes the escape sequences that turn the previously recorded frame into the current
+ *          one: only changed cells are written, short unchanged gaps are rewritten instead of
+ *          moving the cursor.
+ *
+ * @param   recorder
+ * @param   frame
+ *
+ * @return  size_t  Number of bytes written to the recorder's encode buffer
+ */
+/**************************************************************************************************/
+static size_t encode_frame_delta(asciicast_recorder *recorder, const char *frame);
+
+/**************************************************************************************************/
+/**
+ * @name    ring_copy_in, ring_copy_out
+ * @brief   Copies bytes into or out of the ring at a monotonically increasing position, splitting
+ *          the copy in two when it crosses the end of the ring.
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void ring_copy_in(asciicast_recorder *recorder, uint64_t position, const void *source,
+                         size_t length);
+static void ring_copy_out(const asciicast_recorder *recorder, uint64_t position, void *destination,
+                          size_t length);
+
+/**************************************************************************************************/
+/**
+ * @name    flush_write_buffer
+ * @brief   Writes the batched events to the cast file with as few write(2) calls as possible.
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void flush_write_buffer(asciicast_recorder *recorder);
+
+/**************************************************************************************************/
+/**
+ * @name    drain_ring
+ * @brief   Converts every queued frame into an asciicast "o" event in the write buffer.
+ *
+ * @return  size_t  Number of frames drained
+ */
+/**************************************************************************************************/
+static size_t drain_ring(asciicast_recorder *recorder);
+
+/**************************************************************************************************/
+/**
+ * @name    writer_thread_main
+ * @brief   Background thread that drains the ring and batches events to disk until the recorder
+ *          is closed.
+ *
+ * @return  void*
+ */
+/**************************************************************************************************/
+static void *writer_thread_main(void *argument);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static size_t encode_frame_delta(asciicast_recorder *recorder, const char *frame)
+{
+    char *output = recorder->encode_buffer;
+    size_t length = 0;
+    int cursor_row = -1;
+    int cursor_column = -1;
+
+    if (recorder->first_frame_pending)
+    {
+        memcpy(output, "\033[H\033[2J", 7);
+        length = 7;
+    }
+
+    for (int row = 0; row < recorder->frame_height; row++)
+    {
+        const char *previous_row = recorder->previous_frame + row * recorder->frame_width;
+        const char *current_row = frame + row * recorder->frame_width;
+
+        for (int column = 0; column < recorder->frame_width; column++)
+        {
+            if (current_row[column] == previous_row[column])
+            {
+                continue;
+            }
+
+            int gap = column - cursor_column;
+
+            if (cursor_row == row && gap >= 0 && gap <= ASCIICAST_MAXIMUM_REWRITE_GAP)
+            {
+                memcpy(output + length, current_row + cursor_column, gap);
+                length += gap;
+            }
+            else
+            {
+                length += snprintf(output + length, ASCIICAST_CURSOR_MOVE_MAX_BYTES, "\033[%d;%dH",
+                                   row + 1, column + 1);
+            }
+
+            output[length++] = current_row[column];
+            cursor_row = row;
+            cursor_column = column + 1;
+        }
+    }
+
+    return length;
+}
+
+static void ring_copy_in(asciicast_recorder *recorder, uint64_t position, const void *source,
+                         size_t length)
+{
+    size_t offset = position & (ASCIICAST_RING_CAPACITY - 1);
+    size_t first_part = ASCIICAST_RING_CAPACITY - offset;
+
+    if (first_part >= length)
+    {
+        memcpy(recorder->ring + offset, source, length);
+        return;
+    }
+
+    memcpy(recorder->ring + offset, source, first_part);
+    memcpy(recorder->ring, (const unsigned char *)source + first_part, length - first_part);
+}
+
+static void ring_copy_out(const asciicast_recorder *recorder, uint64_t position, void *destination,
+                          size_t length)
+{
+    size_t offset = position & (ASCIICAST_RING_CAPACITY - 1);
+    size_t first_part = ASCIICAST_RING_CAPACITY - offset;
+
+    if (first_part >= length)
+    {
+        memcpy(destination, recorder->ring + offset, length);
+        return;
+    }
+
+    memcpy(destination, recorder->ring + offset, first_part);
+    memcpy((unsigned char *)destination + first_part, recorder->ring, length - first_part);
+}
+
+static void flush_write_buffer(asciicast_recorder *recorder)
+{
+    size_t written = 0;
+
+    while (written < recorder->write_length)
+    {
+        ssize_t result = write(recorder->file_descriptor, recorder->write_buffer + written,
+                               recorder->write_length - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break; // Disk errors lose the batch rather than stalling the recorder
+        }
+        written += (size_t)result;
+    }
+
+    recorder->write_length = 0;
+}
+
+static size_t drain_ring(asciicast_recorder *recorder)
+{
+    uint64_t head = atomic_load_explicit(&recorder->ring_head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&recorder->ring_tail, memory_order_relaxed);
+    size_t drained_frames = 0;
+
+    while (tail != head)
+    {
+        asciicast_ring_record_header header;
+        ring_copy_out(recorder, tail, &header, sizeof(header));
+
+        size_t worst_case_length = (size_t)header.payload_length * ASCIICAST_JSON_ESCAPE_MAX_EXPANSION
+                                   + ASCIICAST_EVENT_OVERHEAD_BYTES;
+        if (recorder->write_length + worst_case_length > recorder->write_capacity)
+        {
+            flush_write_buffer(recorder);
+        }
+
+        char *output = recorder->write_buffer + recorder->write_length;
+        size_t length = snprintf(output, ASCIICAST_EVENT_OVERHEAD_BYTES, "[%.6f, \"o\", \"",
+                                 header.timestamp_nanoseconds / 1e9);
+
+        uint64_t payload_position = tail + sizeof(header);
+        for (uint32_t i = 0; i < header.payload_length; i++)
+        {
+            unsigned char byte = recorder->ring[(payload_position + i) & (ASCIICAST_RING_CAPACITY - 1)];
+
+            if (byte == '"' || byte == '\\')
+            {
+                output[length++] = '\\';
+                output[length++] = (char)byte;
+            }
+            else if (byte < 0x20)
+            {
+                length += sprintf(output + length, "\\u%04x", byte);
+            }
+            else
+            {
+                output[length++] = (char)byte;
+            }
+        }
+
+        memcpy(output + length, "\"]\n", 3);
+        recorder->write_length += length + 3;
+
+        tail = payload_position + header.payload_length;
+        atomic_store_explicit(&recorder->ring_tail, tail, memory_order_release);
+        drained_frames++;
+
+        if (recorder->write_length >= ASCIICAST_WRITE_BATCH_BYTES)
+        {
+            flush_write_buffer(recorder);
+        }
+    }
+
+    return drained_frames;
+}
+
+static void *writer_thread_main(void *argument)
+{
+    asciicast_recorder *recorder = argument;
+    struct timespec idle_time = { .tv_sec = 0, .tv_nsec = ASCIICAST_WRITER_IDLE_NANOSECONDS };
+
+    while (1)
+    {
+        bool stopping = !atomic_load_explicit(&recorder->writer_running, memory_order_acquire);
+
+        if (drain_ring(recorder) > 0)
+        {
+            continue;
+        }
+
+        if (recorder->write_length > 0)
+        {
+            flush_write_buffer(recorder);
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+
+        nanosleep(&idle_time, NULL);
+    }
+
+    return NULL;
+}
+
+asciicast_recorder *asciicast_recorder_open(const char *file_path, int frame_width,
+                                            int frame_height)
+{
+    asciicast_recorder *recorder = calloc(1, sizeof(*recorder));
+    if (recorder == NULL)
+    {
+        return NULL;
+    }
+
+    size_t frame_size = (size_t)frame_width * frame_height;
+    size_t cursor_moves_per_row = frame_width / (ASCIICAST_MAXIMUM_REWRITE_GAP + 1) + 1;
+
+    recorder->frame_width = frame_width;
+    recorder->frame_height = frame_height;
+    recorder->first_frame_pending = true;
+    recorder->encode_capacity = frame_size + 16 +
+                                frame_height * cursor_moves_per_row * ASCIICAST_CURSOR_MOVE_MAX_BYTES;
+    recorder->write_capacity = recorder->encode_capacity * ASCIICAST_JSON_ESCAPE_MAX_EXPANSION +
+                               ASCIICAST_EVENT_OVERHEAD_BYTES;
+    if (recorder->write_capacity < ASCIICAST_MINIMUM_WRITE_CAPACITY)
+    {
+        recorder->write_capacity = ASCIICAST_MINIMUM_WRITE_CAPACITY;
+    }
+
+    recorder->previous_frame = malloc(frame_size);
+    recorder->encode_buffer = malloc(recorder->encode_capacity);
+    recorder->write_buffer = malloc(recorder->write_capacity);
+    recorder->ring = malloc(ASCIICAST_RING_CAPACITY);
+    recorder->file_descriptor = open(file_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (recorder->previous_frame == NULL || recorder->encode_buffer == NULL ||
+        recorder->write_buffer == NULL || recorder->ring == NULL || recorder->file_descriptor < 0)
+    {
+        goto open_failed;
+    }
+
+    // Playback starts from an empty terminal, so the first frame is encoded against blanks
+    memset(recorder->previous_frame, ' ', frame_size);
+
+    recorder->write_length = snprintf(recorder->write_buffer, recorder->write_capacity,
+                                      "{\"version\": 2, \"width\": %d, \"height\": %d, "
+                                      "\"timestamp\": %ld}\n",
+                                      frame_width, frame_height, (long)time(NULL));
+    flush_write_buffer(recorder);
+
+    clock_gettime(CLOCK_MONOTONIC, &recorder->start_time);
+    atomic_store(&recorder->writer_running, true);
+
+    if (pthread_create(&recorder->writer_thread, NULL, writer_thread_main, recorder) != 0)
+    {
+        goto open_failed;
+    }
+
+    return recorder;
+
+open_failed:
+    if (recorder->file_descriptor >= 0)
+    {
+        close(recorder->file_descriptor);
+    }
+    free(recorder->previous_frame);
+    free(recorder->encode_buffer);
+    free(recorder->write_buffer);
+    free(recorder->ring);
+    free(recorder);
+    return NULL;
+}
+
+void asciicast_recorder_push_frame(asciicast_recorder *recorder, const char *frame)
+{
+    if (recorder == NULL)
+    {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    size_t payload_length = encode_frame_delta(recorder, frame);
+    if (payload_length == 0)
+    {
+        return; // Identical frame, nothing to play back
+    }
+
+    asciicast_ring_record_header header = {
+        .timestamp_nanoseconds = (uint64_t)(now.tv_sec - recorder->start_time.tv_sec) * 1000000000ull +
+                                 (uint64_t)(now.tv_nsec - recorder->start_time.tv_nsec),
+        .payload_length = (uint32_t)payload_length,
+        .reserved = 0
+    };
+    size_t record_length = sizeof(header) + payload_length;
+
+    uint64_t head = atomic_load_explicit(&recorder->ring_head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&recorder->ring_tail, memory_order_acquire);
+
+    if (ASCIICAST_RING_CAPACITY - (head - tail) < record_length)
+    {
+        atomic_fetch_add_explicit(&recorder->dropped_frames, 1, memory_order_relaxed);
+        return;
+    }
+
+    ring_copy_in(recorder, head, &header, sizeof(header));
+    ring_copy_in(recorder, head + sizeof(header), recorder->encode_buffer, payload_length);
+    atomic_store_explicit(&recorder->ring_head, head + record_length, memory_order_release);
+
+    memcpy(recorder->previous_frame, frame, (size_t)recorder->frame_width * recorder->frame_height);
+    recorder->first_frame_pending = false;
+    atomic_fetch_add_explicit(&recorder->recorded_frames, 1, memory_order_relaxed);
+}
+
+uint64_t asciicast_recorder_dropped_frames(const asciicast_recorder *recorder)
+{
+    return recorder == NULL ? 0 : atomic_load(&recorder->dropped_frames);
+}
+
+uint64_t asciicast_recorder_recorded_frames(const asciicast_recorder *recorder)
+{
+    return recorder == NULL ? 0 : atomic_load(&recorder->recorded_frames);
+}
+
+void asciicast_recorder_close(asciicast_recorder *recorder)
+{
+    if (recorder == NULL)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&recorder->writer_running, false, memory_order_release);
+    pthread_join(recorder->writer_thread, NULL);
+
+    close(recorder->file_descriptor);
+    free(recorder->previous_frame);
+    free(recorder->encode_buffer);
+    free(recorder->write_buffer);
+    free(recorder->ring);
+    free(recorder);
+}
+
+// End of asciicast.c
@@ -20,14 +20,20 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <signal.h>
 #include <math.h>
 
+#include "asciicast.h"
+#include "orientation.h"
+
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
 /*------------------------------------------------------------------------------------------------*/
 
 #define DISPLAY_WIDTH 90   // Adjust to match your terminal width
 #define DISPLAY_HEIGHT 44
+#define RECORDED_WIDTH (DISPLAY_WIDTH - 1)   // Column 0 is printed as the newline
+#define RECORDED_HEIGHT (DISPLAY_HEIGHT + 1) // Below the line the first newline leaves blank
 
 /*------------------------------------------------------------------------------------------------*/
 /* GLOBAL VARIABLES                                                                               */
@@ -36,10 +42,11 @@
 float cube_width = 20;
 
 float cube_position_x, cube_position_y, cube_position_z;
-float rotation_angle_A, rotation_angle_B, rotation_angle_C;
+Orientation cube_orientation;
 float z_depth_buffer[DISPLAY_WIDTH * DISPLAY_HEIGHT];
 
 char display_frame_buffer[DISPLAY_WIDTH * DISPLAY_HEIGHT];
+char recorded_frame_buffer[RECORDED_WIDTH * RECORDED_HEIGHT];
 int display_background_ascii_character = ' ';
 int display_view_distance = 100;
 float display_field_of_view = 50;
@@ -53,6 +60,8 @@ float inverse_z;
 int buffers_index;
 int cube_x_coordinate_3d_projected, cube_y_coordinate_3d_projected;
 
+volatile sig_atomic_t terminate_requested = 0;
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION PROTOTYPES                                                                            */
 /*------------------------------------------------------------------------------------------------*/
@@ -60,8 +69,8 @@ int cube_x_coordinate_3d_projected, cube_y_coordinate_3d_projected;
 /**************************************************************************************************/
 /**
  * @name calculate_x_rotation, calculate_y_rotation, calculate_z_rotation
- * @brief Calculates the rotated coordinates of a point in 3D space based on
- *        rotation angles A, B, and C.
+ * @brief Calculates the rotated coordinates of a point in 3D space using the rotation matrix
+ *        of cube_orientation, refreshed once per frame.
  *
  * @param cube_i
  * @param cube_j
@@ -118,33 +127,38 @@ void calculate_cube_display_output();
 void calculate_surface_render(float cube_x, float cube_y, float cube_z,
                               int ascii_character);
 
+/**************************************************************************************************/
+/**
+ * @name handle_termination_signal
+ * @brief Requests the render loop to stop so recordings can be flushed before exiting.
+ *
+ * @param signal_number
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void handle_termination_signal(int signal_number);
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION DEFINITIONS                                                                           */
 /*------------------------------------------------------------------------------------------------*/
 
 float calculate_x_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_j * sin(rotation_angle_A) * sin(rotation_angle_B) * cos(rotation_angle_C) -
-           cube_k * cos(rotation_angle_A) * sin(rotation_angle_B) * cos(rotation_angle_C) +
-           cube_j * cos(rotation_angle_A) * sin(rotation_angle_C) +
-           cube_k * sin(rotation_angle_A) * sin(rotation_angle_C) +
-           cube_i * cos(rotation_angle_B) * cos(rotation_angle_C);
+    const float *matrix_row = cube_orientation.rotation_matrix[0];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 float calculate_y_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_j * cos(rotation_angle_A) * cos(rotation_angle_C) +
-           cube_k * sin(rotation_angle_A) * cos(rotation_angle_C) -
-           cube_j * sin(rotation_angle_A) * sin(rotation_angle_B) * sin(rotation_angle_C) +
-           cube_k * cos(rotation_angle_A) * sin(rotation_angle_B) * sin(rotation_angle_C) -
-           cube_i * cos(rotation_angle_B) * sin(rotation_angle_C);
+    const float *matrix_row = cube_orientation.rotation_matrix[1];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 float calculate_z_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_k * cos(rotation_angle_A) * cos(rotation_angle_B) -
-           cube_j * sin(rotation_angle_A) * cos(rotation_angle_B) +
-           cube_i * sin(rotation_angle_B);
+    const float *matrix_row = cube_orientation.rotation_matrix[2];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 int calculate_x_coordinate_3d_projection(float temporary_inverse_z, float temporary_cube_x)
@@ -210,10 +224,37 @@ void calculate_surface_render(float cube_x, float cube_y, float cube_z, int asci
         }
   }
 }
-int main() {
+
+void handle_termination_signal(int signal_number)
+{
+    (void)signal_number;
+    terminate_requested = 1;
+}
+
+int main(int argc, char *argv[]) {
+    asciicast_recorder *recorder = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recorder = asciicast_recorder_open(argv[++i], RECORDED_WIDTH, RECORDED_HEIGHT);
+            if (recorder == NULL)
+            {
+                perror("Unable to start recording");
+                return 1;
+            }
+        }
+    }
+
+    signal(SIGINT, handle_termination_signal);
+    signal(SIGTERM, handle_termination_signal);
+
+    initialize_orientation(&cube_orientation, 0.05f, 0.05f, 0.01f);
+
     printf("\x1b[2J");  // Clear screen
 
-    while(1)
+    while(!terminate_requested)
     {
         // Set memory for buffers:
         // - memset function takes in the following parameters:
@@ -229,6 +270,7 @@ int main() {
         // Here, we set the z-depth buffer to 0
         memset(z_depth_buffer, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT * 4);
 
+        update_orientation_matrix(&cube_orientation);
         calculate_cube_display_output();
 
         printf("\x1b[H");  // Reset cursor to top-left position
@@ -238,11 +280,29 @@ int main() {
             putchar(k % DISPLAY_WIDTH ? display_frame_buffer[k] : 10);
         }
 
-        rotation_angle_A += 0.05;
-        rotation_angle_B += 0.05;
-        rotation_angle_C += 0.01;
+        // Record what the terminal shows: a blank first line, then every column but the one
+        // printed as the newline
+        if (recorder != NULL) {
+            memset(recorded_frame_buffer, ' ', RECORDED_WIDTH);
+            for (int row = 0; row < DISPLAY_HEIGHT; row++) {
+                memcpy(&recorded_frame_buffer[(row + 1) * RECORDED_WIDTH],
+                       &display_frame_buffer[row * DISPLAY_WIDTH + 1], RECORDED_WIDTH);
+            }
+            asciicast_recorder_push_frame(recorder, recorded_frame_buffer);
+        }
+
+        step_orientation(&cube_orientation);
 
         usleep(30000);  // Sleep for 60 milliseconds
     }
-    return 0; // Program should never reach here
+
+    if (recorder != NULL)
+    {
+        fprintf(stderr, "Recorded %llu frames, dropped %llu\n",
+                (unsigned long long)asciicast_recorder_recorded_frames(recorder),
+                (unsigned long long)asciicast_recorder_dropped_frames(recorder));
+        asciicast_recorder_close(recorder);
+    }
+
+    return 0;
 }
\ No newline at end of file
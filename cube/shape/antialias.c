@@ -0,0 +1,151 @@
+/**************************************************************************************************/
+/**
+ * @file antialias.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Supersampled coverage buffer and its vectorized resolve to a glyph density ramp
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "antialias.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define COVERAGE_VECTOR_BYTES 16
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// GCC/Clang vector extensions: lowered to SSE2/AVX on x86 and NEON on ARM
+typedef uint8_t coverage_byte_vector __attribute__((vector_size(COVERAGE_VECTOR_BYTES)));
+typedef uint16_t coverage_short_vector __attribute__((vector_size(COVERAGE_VECTOR_BYTES)));
+typedef uint32_t coverage_word_vector __attribute__((vector_size(COVERAGE_VECTOR_BYTES)));
+typedef uint8_t coverage_half_byte_vector __attribute__((vector_size(COVERAGE_VECTOR_BYTES / 2)));
+typedef uint8_t coverage_quarter_byte_vector __attribute__((vector_size(COVERAGE_VECTOR_BYTES / 4)));
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+int create_coverage_buffer(CoverageBuffer *coverage, int width, int height, int factor)
+{
+    memset(coverage, 0, sizeof(*coverage));
+
+    if (factor != 2 && factor != 4)
+    {
+        return -1;
+    }
+
+    coverage->width = width;
+    coverage->height = height;
+    coverage->factor = factor;
+    coverage->stride = (width * factor + COVERAGE_VECTOR_BYTES - 1) / COVERAGE_VECTOR_BYTES *
+                       COVERAGE_VECTOR_BYTES;
+    coverage->maximum_sample_value = 255 / (factor * factor);
+
+    coverage->samples = aligned_alloc(COVERAGE_VECTOR_BYTES,
+                                      (size_t)coverage->stride * height * factor);
+    coverage->cell_sums = malloc(coverage->stride / factor);
+    if (coverage->samples == NULL || coverage->cell_sums == NULL)
+    {
+        destroy_coverage_buffer(coverage);
+        return -1;
+    }
+
+    const char *ramp = COVERAGE_LUMINANCE_RAMP;
+    int ramp_last_index = (int)strlen(ramp) - 1;
+    int full_cell_sum = coverage->maximum_sample_value * factor * factor;
+
+    for (int sum = 0; sum < 256; sum++)
+    {
+        int ramp_index = (sum * ramp_last_index + full_cell_sum / 2) / full_cell_sum;
+        if (ramp_index > ramp_last_index)
+        {
+            ramp_index = ramp_last_index;
+        }
+        // Any coverage at all shows at least the faintest glyph so thin edges do not vanish
+        if (sum > 0 && ramp_index == 0)
+        {
+            ramp_index = 1;
+        }
+        coverage->glyph_lookup[sum] = ramp[ramp_index];
+    }
+
+    return 0;
+}
+
+void destroy_coverage_buffer(CoverageBuffer *coverage)
+{
+    free(coverage->samples);
+    free(coverage->cell_sums);
+    coverage->samples = NULL;
+    coverage->cell_sums = NULL;
+}
+
+void resolve_coverage_to_glyphs(CoverageBuffer *coverage, char *frame)
+{
+    const int factor = coverage->factor;
+    const int stride = coverage->stride;
+    const int cells_per_vector = COVERAGE_VECTOR_BYTES / factor;
+
+    for (int row = 0; row < coverage->height; row++)
+    {
+        const uint8_t *sample_rows = coverage->samples + (size_t)row * factor * stride;
+        uint8_t *cell_sums = coverage->cell_sums;
+
+        for (int offset = 0; offset < stride; offset += COVERAGE_VECTOR_BYTES)
+        {
+            coverage_byte_vector column_sums;
+            memcpy(&column_sums, sample_rows + offset, sizeof(column_sums));
+
+            for (int sample_row = 1; sample_row < factor; sample_row++)
+            {
+                coverage_byte_vector samples;
+                memcpy(&samples, sample_rows + sample_row * stride + offset, sizeof(samples));
+                column_sums += samples;
+            }
+
+            if (factor == 2)
+            {
+                coverage_short_vector pairs = (coverage_short_vector)column_sums;
+                pairs = (pairs & 0x00ff) + (pairs >> 8);
+
+                coverage_half_byte_vector cells = __builtin_convertvector(pairs,
+                                                                          coverage_half_byte_vector);
+                memcpy(cell_sums, &cells, sizeof(cells));
+            }
+            else
+            {
+                coverage_word_vector quads = (coverage_word_vector)column_sums;
+                quads = (quads & 0x00ff00ff) + ((quads >> 8) & 0x00ff00ff);
+                quads = (quads & 0x0000ffff) + (quads >> 16);
+
+                coverage_quarter_byte_vector cells = __builtin_convertvector(quads,
+                                                                             coverage_quarter_byte_vector);
+                memcpy(cell_sums, &cells, sizeof(cells));
+            }
+
+            cell_sums += cells_per_vector;
+        }
+
+        char *frame_row = frame + row * coverage->width;
+        for (int column = 0; column < coverage->width; column++)
+        {
+            frame_row[column] = coverage->glyph_lookup[coverage->cell_sums[column]];
+        }
+    }
+}
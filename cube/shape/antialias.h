@@ -0,0 +1,91 @@
+/**************************************************************************************************/
+/**
+ * @file antialias.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Supersampled coverage buffer and its vectorized resolve to a glyph density ramp
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef ANTIALIAS_H
+#define ANTIALIAS_H
+
+#include <stdint.h>
+
+/*------------------------------------------------------------------------------------------------*/
+/* COVERAGE BUFFER                                                                                */
+/*------------------------------------------------------------------------------------------------*/
+
+// Glyphs used to display resolved coverage, from empty to fully covered
+#define COVERAGE_LUMINANCE_RAMP " .:-=+*#%@"
+
+/**
+ * Sub-cell coverage buffer
+ * - samples: (height * factor) rows of stride bytes, each byte is one sub-cell's luminance
+ * - factor: sub-cells per cell along each axis (2 or 4)
+ * - stride: bytes per sample row, width * factor rounded up to the vector width
+ * - maximum_sample_value: largest value a sub-cell may hold so a full cell sum fits in a byte
+ * - cell_sums: scratch row holding the box-filtered sum of every cell in one display row
+ * - glyph_lookup: maps a cell sum to the glyph shown for it
+ */
+typedef struct {
+    uint8_t *samples;
+    int width;
+    int height;
+    int factor;
+    int stride;
+    int maximum_sample_value;
+    uint8_t *cell_sums;
+    char glyph_lookup[256];
+} CoverageBuffer;
+
+/**************************************************************************************************/
+/**
+ * @name create_coverage_buffer
+ * @brief Allocates a coverage buffer for a width x height display sampled factor x factor times
+ *        per cell, and builds its luminance ramp lookup table.
+ *
+ * @param coverage
+ * @param width
+ * @param height
+ * @param factor    Supersampling factor per axis, must be 2 or 4
+ *
+ * @return int  0 on success, -1 on an unsupported factor or allocation failure
+ */
+/**************************************************************************************************/
+int create_coverage_buffer(CoverageBuffer *coverage, int width, int height, int factor);
+
+/**************************************************************************************************/
+/**
+ * @name destroy_coverage_buffer
+ * @brief Releases the memory owned by a coverage buffer.
+ *
+ * @param coverage
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void destroy_coverage_buffer(CoverageBuffer *coverage);
+
+/**************************************************************************************************/
+/**
+ * @name resolve_coverage_to_glyphs
+ * @brief Box-filters every factor x factor block of sub-cells to one cell and maps the sum to a
+ *        glyph. Each display row is resolved in one vectorized pass over its contiguous sample
+ *        rows: sample rows are added with byte vectors, then adjacent bytes are folded together
+ *        inside wider lanes.
+ *
+ * @param coverage
+ * @param frame     width * height characters receiving the resolved glyphs
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void resolve_coverage_to_glyphs(CoverageBuffer *coverage, char *frame);
+
+#endif // ANTIALIAS_H
@@ -0,0 +1,238 @@
+/**************************************************************************************************/
+/**
+ * @file face_pattern.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Mip chain construction and level of detail selection for face patterns
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "shape.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+// Glyphs ordered from least to most ink, used to estimate how dark each character looks
+#define GLYPH_DENSITY_RAMP " .'`^\",:;Il!i><~+_-?][}{1)(|\\/tfjrxnuvczXYUJCLQ0OZmwqpdbkhao*#MW&8%B@$"
+#define GLYPH_DENSITY_UNKNOWN 0.5f
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+static float glyph_density_table[256];
+static int glyph_density_table_ready = 0;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name initialize_glyph_density_table
+ * @brief Fills the glyph density lookup table from GLYPH_DENSITY_RAMP.
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+static void initialize_glyph_density_table(void);
+
+/**************************************************************************************************/
+/**
+ * @name reduce_mip_level
+ * @brief Builds one mip level from the level above it with the glyph-density-aware 2x2 reduction.
+ *
+ * @param source
+ * @param destination_glyphs
+ * @param destination
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+static void reduce_mip_level(const FacePatternMipLevel *source, char *destination_glyphs,
+                             FacePatternMipLevel *destination);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void initialize_glyph_density_table(void)
+{
+    const char *ramp = GLYPH_DENSITY_RAMP;
+    int ramp_length = (int)strlen(ramp);
+
+    for (int glyph = 0; glyph < 256; glyph++)
+    {
+        glyph_density_table[glyph] = GLYPH_DENSITY_UNKNOWN;
+    }
+
+    for (int i = 0; i < ramp_length; i++)
+    {
+        glyph_density_table[(unsigned char)ramp[i]] = (float)i / (ramp_length - 1);
+    }
+
+    glyph_density_table_ready = 1;
+}
+
+static void reduce_mip_level(const FacePatternMipLevel *source, char *destination_glyphs,
+                             FacePatternMipLevel *destination)
+{
+    destination->width = (source->width + 1) / 2;
+    destination->height = (source->height + 1) / 2;
+    destination->glyphs = destination_glyphs;
+
+    for (int y = 0; y < destination->height; y++)
+    {
+        for (int x = 0; x < destination->width; x++)
+        {
+            char block_glyphs[4];
+            int block_size = 0;
+            float average_density = 0.0f;
+
+            for (int block_y = 2 * y; block_y < 2 * y + 2 && block_y < source->height; block_y++)
+            {
+                for (int block_x = 2 * x; block_x < 2 * x + 2 && block_x < source->width; block_x++)
+                {
+                    char glyph = source->glyphs[block_y * source->width + block_x];
+                    block_glyphs[block_size++] = glyph;
+                    average_density += glyph_density_table[(unsigned char)glyph];
+                }
+            }
+            average_density /= block_size;
+
+            char closest_glyph = block_glyphs[0];
+            float closest_distance = 2.0f;
+
+            for (int i = 0; i < block_size; i++)
+            {
+                float distance = fabsf(glyph_density_table[(unsigned char)block_glyphs[i]] -
+                                       average_density);
+                if (distance < closest_distance)
+                {
+                    closest_distance = distance;
+                    closest_glyph = block_glyphs[i];
+                }
+            }
+
+            destination_glyphs[y * destination->width + x] = closest_glyph;
+        }
+    }
+}
+
+int build_face_pattern_mip_chain(FacePattern *face)
+{
+    face->mip_level_count = 0;
+    face->mip_storage = NULL;
+
+    if (face->pattern == NULL)
+    {
+        return 0; // Solid faces sample the default character, nothing to build
+    }
+
+    if (!glyph_density_table_ready)
+    {
+        initialize_glyph_density_table();
+    }
+
+    size_t total_glyphs = 0;
+    int level_width = face->width;
+    int level_height = face->height;
+    int level_count = 0;
+
+    while (level_count < FACE_PATTERN_MAX_MIP_LEVELS)
+    {
+        total_glyphs += (size_t)level_width * level_height;
+        level_count++;
+
+        if (level_width == 1 && level_height == 1)
+        {
+            break;
+        }
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+
+    face->mip_storage = malloc(total_glyphs);
+    if (face->mip_storage == NULL)
+    {
+        return -1;
+    }
+
+    char *level_glyphs = face->mip_storage;
+    for (int y = 0; y < face->height; y++)
+    {
+        memcpy(level_glyphs + y * face->width, face->pattern[y], face->width);
+    }
+    face->mip_levels[0].glyphs = level_glyphs;
+    face->mip_levels[0].width = face->width;
+    face->mip_levels[0].height = face->height;
+
+    for (int level = 1; level < level_count; level++)
+    {
+        const FacePatternMipLevel *source = &face->mip_levels[level - 1];
+        level_glyphs += (size_t)source->width * source->height;
+        reduce_mip_level(source, level_glyphs, &face->mip_levels[level]);
+    }
+
+    face->mip_level_count = level_count;
+    return 0;
+}
+
+float get_glyph_density(char glyph)
+{
+    if (!glyph_density_table_ready)
+    {
+        initialize_glyph_density_table();
+    }
+
+    return glyph_density_table[(unsigned char)glyph];
+}
+
+void free_face_pattern_mip_chain(FacePattern *face)
+{
+    free(face->mip_storage);
+    face->mip_storage = NULL;
+    face->mip_level_count = 0;
+}
+
+int select_face_mip_level(const FacePattern *face, float projected_u_cells,
+                          float projected_v_cells)
+{
+    if (face->mip_level_count <= 1)
+    {
+        return 0;
+    }
+
+    if (projected_u_cells < 1.0f) projected_u_cells = 1.0f;
+    if (projected_v_cells < 1.0f) projected_v_cells = 1.0f;
+
+    float texels_per_cell_u = face->width / projected_u_cells;
+    float texels_per_cell_v = face->height / projected_v_cells;
+    float texels_per_cell = texels_per_cell_u > texels_per_cell_v ? texels_per_cell_u
+                                                                  : texels_per_cell_v;
+
+    if (texels_per_cell <= 1.0f)
+    {
+        return 0;
+    }
+
+    int level = (int)log2f(texels_per_cell);
+    if (level >= face->mip_level_count)
+    {
+        level = face->mip_level_count - 1;
+    }
+    return level;
+}
@@ -19,10 +19,17 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <signal.h>
+#include <time.h>
 #include <math.h>
+#include <termios.h>
 #include "shape.h"
 #include "shapes_config.h"
+#include "antialias.h"
+#include "orientation.h"
+#include "asciicast.h"
 
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
@@ -30,6 +37,14 @@
 
 #define DISPLAY_WIDTH 90   // Adjust to match your terminal width
 #define DISPLAY_HEIGHT 44
+#define RECORDED_WIDTH (DISPLAY_WIDTH - 1)   // Column 0 is printed as the newline
+#define RECORDED_HEIGHT (DISPLAY_HEIGHT + 1) // Below the line the first newline leaves blank
+
+// Object-space samples taken per projected screen cell along each face axis
+#define FACE_SAMPLES_PER_CELL 2.5f
+
+// Rotation applied per key press in interactive mode, in radians
+#define INTERACTIVE_ROTATION_STEP 0.1f
 
 /*------------------------------------------------------------------------------------------------*/
 /* GLOBAL VARIABLES                                                                               */
@@ -37,10 +52,11 @@
 
 ShapeConfig *current_shape;  // Pointer to the current shape configuration
 
-float rotation_angle_A, rotation_angle_B, rotation_angle_C;
+Orientation shape_orientation;
 float z_depth_buffer[DISPLAY_WIDTH * DISPLAY_HEIGHT];
 
 char display_frame_buffer[DISPLAY_WIDTH * DISPLAY_HEIGHT];
+char recorded_frame_buffer[RECORDED_WIDTH * RECORDED_HEIGHT];
 int display_background_ascii_character = ' ';
 int display_view_distance = 100;
 float display_field_of_view = 50;
@@ -53,6 +69,49 @@ float inverse_z;
 int buffers_index;
 int x_coordinate_3d_projected, y_coordinate_3d_projected;
 
+volatile sig_atomic_t terminate_requested = 0;
+
+struct termios original_terminal_mode;
+int interactive_rotation_enabled = 0;
+
+/**
+ * Per-frame sampling plan for one face
+ * - mip_level: pattern level matching the face's projected size
+ * - u_sample_count, v_sample_count: number of sample intervals along the face's u and v axes
+ * - u_step, v_step: object-space distance between samples, chosen so both edges are sampled
+ */
+typedef struct {
+    int mip_level;
+    int u_sample_count;
+    int v_sample_count;
+    float u_step;
+    float v_step;
+} FaceSampling;
+
+/**
+ * Orientation of each face in object space, in the same order as ShapeConfig faces
+ * - origin: corner where u = 0 and v = 0, in units of the shape's half sizes
+ * - u_axis, v_axis: directions of increasing u and v
+ * - normal: outward facing normal
+ * - default_character: glyph used when the face has no pattern
+ */
+typedef struct {
+    float origin[3];
+    float u_axis[3];
+    float v_axis[3];
+    float normal[3];
+    char default_character;
+} FaceFrame;
+
+static const FaceFrame face_frames[6] = {
+    { { -1, -1, -1 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, '@' },  // Front
+    { {  1, -1, -1 }, { 0, 0, 1 }, { 0, 1, 0 }, { 1, 0, 0 },  '$' },  // Right
+    { { -1, -1, -1 }, { 0, 0, 1 }, { 0, 1, 0 }, { -1, 0, 0 }, '~' },  // Left
+    { { -1, -1,  1 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 },  '#' },  // Back
+    { { -1, -1, -1 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, -1, 0 }, ';' },  // Bottom
+    { { -1,  1, -1 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 },  '+' }   // Top
+};
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION PROTOTYPES                                                                            */
 /*------------------------------------------------------------------------------------------------*/
@@ -60,8 +119,8 @@ int x_coordinate_3d_projected, y_coordinate_3d_projected;
 /**************************************************************************************************/
 /**
  * @name calculate_x_rotation, calculate_y_rotation, calculate_z_rotation
- * @brief Calculates the rotated coordinates of a point in 3D space based on
- *        rotation angles A, B, and C.
+ * @brief Calculates the rotated coordinates of a point in 3D space using the rotation matrix
+ *        of shape_orientation, refreshed once per frame.
  *
  * @param cube_i
  * @param cube_j
@@ -118,33 +177,145 @@ void calculate_shape_display_output();
 void calculate_surface_render(float cube_x, float cube_y, float cube_z,
                               int ascii_character);
 
+/**************************************************************************************************/
+/**
+ * @name project_point_to_screen
+ * @brief Rotates and projects a point in object space to fractional screen coordinates relative
+ *        to the centre of the display.
+ *
+ * @param x
+ * @param y
+ * @param z
+ * @param screen_x
+ * @param screen_y
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void project_point_to_screen(float x, float y, float z, float *screen_x, float *screen_y);
+
+/**************************************************************************************************/
+/**
+ * @name select_face_sampling
+ * @brief Measures how large a face is on screen this frame from its four corners, then picks the
+ *        mip level to sample and an object-space step so that roughly FACE_SAMPLES_PER_CELL
+ *        samples land in each covered cell. Small faces therefore read a smaller pattern level
+ *        and take fewer samples.
+ *
+ * @param face
+ * @param origin_corner     Corner at (u = 0, v = 0)
+ * @param u_corner          Corner at (u = 1, v = 0)
+ * @param v_corner          Corner at (u = 0, v = 1)
+ * @param uv_corner         Corner at (u = 1, v = 1)
+ * @param u_extent          Object-space length of the face along u
+ * @param v_extent          Object-space length of the face along v
+ *
+ * @return FaceSampling
+ */
+/**************************************************************************************************/
+FaceSampling select_face_sampling(const FacePattern *face, const float origin_corner[3],
+                                  const float u_corner[3], const float v_corner[3],
+                                  const float uv_corner[3], float u_extent, float v_extent);
+
+/**************************************************************************************************/
+/**
+ * @name calculate_antialiased_display_output
+ * @brief Antialiased alternative to calculate_shape_display_output. Every front-facing face is
+ *        rasterized at sub-cell resolution into the coverage buffer: each sub-cell casts a ray,
+ *        intersects the face plane to get perspective-correct (u, v) and stores the density of
+ *        the pattern glyph found there. The buffer is then box-filtered into the display frame.
+ *
+ * @param coverage
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void calculate_antialiased_display_output(CoverageBuffer *coverage);
+
+/**************************************************************************************************/
+/**
+ * @name calculate_display_frame
+ * @brief Renders one frame into the display frame buffer, antialiased when a coverage buffer is
+ *        given and point sampled otherwise.
+ *
+ * @param coverage  Coverage buffer for the antialiased mode, or NULL
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void calculate_display_frame(CoverageBuffer *coverage);
+
+/**************************************************************************************************/
+/**
+ * @name run_benchmark
+ * @brief Renders frames back to back without terminal output or sleeping and prints the average
+ *        frame time, so the point sampled and antialiased modes can be compared.
+ *
+ * @param frame_count
+ * @param coverage  Coverage buffer for the antialiased mode, or NULL
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void run_benchmark(int frame_count, CoverageBuffer *coverage);
+
+/**************************************************************************************************/
+/**
+ * @name handle_termination_signal
+ * @brief Requests the render loop to stop so recordings can be flushed before exiting.
+ *
+ * @param signal_number
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void handle_termination_signal(int signal_number);
+
+/**************************************************************************************************/
+/**
+ * @name enable_interactive_rotation, restore_terminal_mode
+ * @brief Switches the terminal to non-canonical, non-blocking input so rotation keys can be read
+ *        each frame, and restores the original mode on exit. Does nothing if stdin is not a
+ *        terminal.
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void enable_interactive_rotation();
+void restore_terminal_mode();
+
+/**************************************************************************************************/
+/**
+ * @name apply_interactive_rotation
+ * @brief Reads pending key presses and rotates shape_orientation about the screen axes:
+ *        w/s tilt about the horizontal axis, a/d turn about the vertical axis and q/e roll about
+ *        the view axis.
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void apply_interactive_rotation();
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION DEFINITIONS                                                                           */
 /*------------------------------------------------------------------------------------------------*/
 
 float calculate_x_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_j * sin(rotation_angle_A) * sin(rotation_angle_B) * cos(rotation_angle_C) -
-           cube_k * cos(rotation_angle_A) * sin(rotation_angle_B) * cos(rotation_angle_C) +
-           cube_j * cos(rotation_angle_A) * sin(rotation_angle_C) +
-           cube_k * sin(rotation_angle_A) * sin(rotation_angle_C) +
-           cube_i * cos(rotation_angle_B) * cos(rotation_angle_C);
+    const float *matrix_row = shape_orientation.rotation_matrix[0];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 float calculate_y_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_j * cos(rotation_angle_A) * cos(rotation_angle_C) +
-           cube_k * sin(rotation_angle_A) * cos(rotation_angle_C) -
-           cube_j * sin(rotation_angle_A) * sin(rotation_angle_B) * sin(rotation_angle_C) +
-           cube_k * cos(rotation_angle_A) * sin(rotation_angle_B) * sin(rotation_angle_C) -
-           cube_i * cos(rotation_angle_B) * sin(rotation_angle_C);
+    const float *matrix_row = shape_orientation.rotation_matrix[1];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 float calculate_z_rotation(float cube_i, float cube_j, float cube_k)
 {
-    return cube_k * cos(rotation_angle_A) * cos(rotation_angle_B) -
-           cube_j * sin(rotation_angle_A) * cos(rotation_angle_B) +
-           cube_i * sin(rotation_angle_B);
+    const float *matrix_row = shape_orientation.rotation_matrix[2];
+    return matrix_row[0] * cube_i + matrix_row[1] * cube_j + matrix_row[2] * cube_k;
 }
 
 int calculate_x_coordinate_3d_projection(float temporary_inverse_z, float temporary_x)
@@ -161,78 +332,186 @@ int calculate_y_coordinate_3d_projection(float temporary_inverse_z, float tempor
                 + display_y_offset);
 }
 
+void project_point_to_screen(float x, float y, float z, float *screen_x, float *screen_y)
+{
+    float rotated_x = calculate_x_rotation(x, y, z);
+    float rotated_y = calculate_y_rotation(x, y, z);
+    float rotated_z = calculate_z_rotation(x, y, z) + display_view_distance;
+    float point_inverse_z = 1 / rotated_z;
+
+    *screen_x = display_field_of_view * point_inverse_z * rotated_x * display_aspect_ratio;
+    *screen_y = display_field_of_view * point_inverse_z * rotated_y;
+}
+
+FaceSampling select_face_sampling(const FacePattern *face, const float origin_corner[3],
+                                  const float u_corner[3], const float v_corner[3],
+                                  const float uv_corner[3], float u_extent, float v_extent)
+{
+    float screen_x[4], screen_y[4];
+    const float *corners[4] = { origin_corner, u_corner, v_corner, uv_corner };
+
+    for (int i = 0; i < 4; i++)
+    {
+        project_point_to_screen(corners[i][0], corners[i][1], corners[i][2],
+                                &screen_x[i], &screen_y[i]);
+    }
+
+    // Perspective makes opposite edges differ, so use the longer of each pair
+    float u_cells = fmaxf(hypotf(screen_x[1] - screen_x[0], screen_y[1] - screen_y[0]),
+                          hypotf(screen_x[3] - screen_x[2], screen_y[3] - screen_y[2]));
+    float v_cells = fmaxf(hypotf(screen_x[2] - screen_x[0], screen_y[2] - screen_y[0]),
+                          hypotf(screen_x[3] - screen_x[1], screen_y[3] - screen_y[1]));
+
+    // Never sample more densely than the configured display density
+    float u_samples = fminf(u_cells * FACE_SAMPLES_PER_CELL, u_extent / display_density);
+    float v_samples = fminf(v_cells * FACE_SAMPLES_PER_CELL, v_extent / display_density);
+
+    FaceSampling sampling;
+    sampling.mip_level = select_face_mip_level(face, u_cells, v_cells);
+    sampling.u_sample_count = u_samples < 1.0f ? 1 : (int)ceilf(u_samples);
+    sampling.v_sample_count = v_samples < 1.0f ? 1 : (int)ceilf(v_samples);
+    sampling.u_step = u_extent / sampling.u_sample_count;
+    sampling.v_step = v_extent / sampling.v_sample_count;
+
+    return sampling;
+}
+
 void calculate_shape_display_output()
 {
     ShapeDimensions *dim = &current_shape->dimensions;
+    float x_half = dim->x_half_size;
+    float y_half = dim->y_half_size;
+    float z_half = dim->z_half_size;
+    FaceSampling sampling;
 
     // Front face (z = -z_half_size)
-    for (float x = -dim->x_half_size; x < dim->x_half_size; x += display_density)
+    sampling = select_face_sampling(&current_shape->faces[0],
+                                    (float[3]){-x_half, -y_half, -z_half},
+                                    (float[3]){x_half, -y_half, -z_half},
+                                    (float[3]){-x_half, y_half, -z_half},
+                                    (float[3]){x_half, y_half, -z_half},
+                                    2.0f * x_half, 2.0f * y_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float y = -dim->y_half_size; y < dim->y_half_size; y += display_density)
+        float x = -x_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float y = -y_half + v_index * sampling.v_step;
             float u = (x + dim->x_half_size) / (2.0f * dim->x_half_size);
             float v = (y + dim->y_half_size) / (2.0f * dim->y_half_size);
-            char ch = get_face_character(&current_shape->faces[0], u, v, '@');
+            char ch = get_face_character_from_level(&current_shape->faces[0],
+                                                    sampling.mip_level, u, v, '@');
             calculate_surface_render(x, y, -dim->z_half_size, ch);
         }
     }
 
     // Right face (x = +x_half_size)
-    for (float z = -dim->z_half_size; z < dim->z_half_size; z += display_density)
+    sampling = select_face_sampling(&current_shape->faces[1],
+                                    (float[3]){x_half, -y_half, -z_half},
+                                    (float[3]){x_half, -y_half, z_half},
+                                    (float[3]){x_half, y_half, -z_half},
+                                    (float[3]){x_half, y_half, z_half},
+                                    2.0f * z_half, 2.0f * y_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float y = -dim->y_half_size; y < dim->y_half_size; y += display_density)
+        float z = -z_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float y = -y_half + v_index * sampling.v_step;
             float u = (z + dim->z_half_size) / (2.0f * dim->z_half_size);
             float v = (y + dim->y_half_size) / (2.0f * dim->y_half_size);
-            char ch = get_face_character(&current_shape->faces[1], u, v, '$');
+            char ch = get_face_character_from_level(&current_shape->faces[1],
+                                                    sampling.mip_level, u, v, '$');
             calculate_surface_render(dim->x_half_size, y, z, ch);
         }
     }
 
     // Left face (x = -x_half_size)
-    for (float z = -dim->z_half_size; z < dim->z_half_size; z += display_density)
+    sampling = select_face_sampling(&current_shape->faces[2],
+                                    (float[3]){-x_half, -y_half, z_half},
+                                    (float[3]){-x_half, -y_half, -z_half},
+                                    (float[3]){-x_half, y_half, z_half},
+                                    (float[3]){-x_half, y_half, -z_half},
+                                    2.0f * z_half, 2.0f * y_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float y = -dim->y_half_size; y < dim->y_half_size; y += display_density)
+        float z = -z_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float y = -y_half + v_index * sampling.v_step;
             float u = (-z + dim->z_half_size) / (2.0f * dim->z_half_size);
             float v = (y + dim->y_half_size) / (2.0f * dim->y_half_size);
-            char ch = get_face_character(&current_shape->faces[2], u, v, '~');
+            char ch = get_face_character_from_level(&current_shape->faces[2],
+                                                    sampling.mip_level, u, v, '~');
             calculate_surface_render(-dim->x_half_size, y, -z, ch);
         }
     }
 
     // Back face (z = +z_half_size)
-    for (float x = -dim->x_half_size; x < dim->x_half_size; x += display_density)
+    sampling = select_face_sampling(&current_shape->faces[3],
+                                    (float[3]){x_half, -y_half, z_half},
+                                    (float[3]){-x_half, -y_half, z_half},
+                                    (float[3]){x_half, y_half, z_half},
+                                    (float[3]){-x_half, y_half, z_half},
+                                    2.0f * x_half, 2.0f * y_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float y = -dim->y_half_size; y < dim->y_half_size; y += display_density)
+        float x = -x_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float y = -y_half + v_index * sampling.v_step;
             float u = (-x + dim->x_half_size) / (2.0f * dim->x_half_size);
             float v = (y + dim->y_half_size) / (2.0f * dim->y_half_size);
-            char ch = get_face_character(&current_shape->faces[3], u, v, '#');
+            char ch = get_face_character_from_level(&current_shape->faces[3],
+                                                    sampling.mip_level, u, v, '#');
             calculate_surface_render(-x, y, dim->z_half_size, ch);
         }
     }
 
     // Bottom face (y = -y_half_size)
-    for (float x = -dim->x_half_size; x < dim->x_half_size; x += display_density)
+    sampling = select_face_sampling(&current_shape->faces[4],
+                                    (float[3]){-x_half, -y_half, z_half},
+                                    (float[3]){x_half, -y_half, z_half},
+                                    (float[3]){-x_half, -y_half, -z_half},
+                                    (float[3]){x_half, -y_half, -z_half},
+                                    2.0f * x_half, 2.0f * z_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float z = -dim->z_half_size; z < dim->z_half_size; z += display_density)
+        float x = -x_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float z = -z_half + v_index * sampling.v_step;
             float u = (x + dim->x_half_size) / (2.0f * dim->x_half_size);
             float v = (-z + dim->z_half_size) / (2.0f * dim->z_half_size);
-            char ch = get_face_character(&current_shape->faces[4], u, v, ';');
+            char ch = get_face_character_from_level(&current_shape->faces[4],
+                                                    sampling.mip_level, u, v, ';');
             calculate_surface_render(x, -dim->y_half_size, -z, ch);
         }
     }
 
     // Top face (y = +y_half_size)
-    for (float x = -dim->x_half_size; x < dim->x_half_size; x += display_density)
+    sampling = select_face_sampling(&current_shape->faces[5],
+                                    (float[3]){-x_half, y_half, -z_half},
+                                    (float[3]){x_half, y_half, -z_half},
+                                    (float[3]){-x_half, y_half, z_half},
+                                    (float[3]){x_half, y_half, z_half},
+                                    2.0f * x_half, 2.0f * z_half);
+    for (int u_index = 0; u_index <= sampling.u_sample_count; u_index++)
     {
-        for (float z = -dim->z_half_size; z < dim->z_half_size; z += display_density)
+        float x = -x_half + u_index * sampling.u_step;
+
+        for (int v_index = 0; v_index <= sampling.v_sample_count; v_index++)
         {
+            float z = -z_half + v_index * sampling.v_step;
             float u = (x + dim->x_half_size) / (2.0f * dim->x_half_size);
             float v = (z + dim->z_half_size) / (2.0f * dim->z_half_size);
-            char ch = get_face_character(&current_shape->faces[5], u, v, '+');
+            char ch = get_face_character_from_level(&current_shape->faces[5],
+                                                    sampling.mip_level, u, v, '+');
             calculate_surface_render(x, dim->y_half_size, z, ch);
         }
     }
@@ -257,29 +536,299 @@ void calculate_surface_render(float x, float y, float z, int ascii_character) {
         }
   }
 }
-int main() {
+
+void calculate_antialiased_display_output(CoverageBuffer *coverage)
+{
+    const float half_sizes[3] = { current_shape->dimensions.x_half_size,
+                                  current_shape->dimensions.y_half_size,
+                                  current_shape->dimensions.z_half_size };
+    const int factor = coverage->factor;
+    const int sample_columns = DISPLAY_WIDTH * factor;
+    const int sample_rows = DISPLAY_HEIGHT * factor;
+    const float screen_center_x = DISPLAY_WIDTH / 2 - display_x_offset;
+    const float screen_center_y = DISPLAY_HEIGHT / 2 + display_y_offset;
+    const float x_scale = display_field_of_view * display_aspect_ratio;
+    float (*rotation_matrix)[3] = shape_orientation.rotation_matrix;
+
+    memset(coverage->samples, 0, (size_t)coverage->stride * sample_rows);
+
+    for (int face_index = 0; face_index < 6; face_index++)
+    {
+        const FaceFrame *frame = &face_frames[face_index];
+        const FacePattern *face = &current_shape->faces[face_index];
+        float origin[3], u_edge[3], v_edge[3], normal[3];
+
+        for (int row = 0; row < 3; row++)
+        {
+            origin[row] = 0;
+            u_edge[row] = 0;
+            v_edge[row] = 0;
+            normal[row] = 0;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                origin[row] += rotation_matrix[row][axis] * frame->origin[axis] * half_sizes[axis];
+                u_edge[row] += rotation_matrix[row][axis] * frame->u_axis[axis] * 2 * half_sizes[axis];
+                v_edge[row] += rotation_matrix[row][axis] * frame->v_axis[axis] * 2 * half_sizes[axis];
+                normal[row] += rotation_matrix[row][axis] * frame->normal[axis];
+            }
+        }
+        origin[2] += display_view_distance;
+
+        // The camera sits at the origin, so a face is visible when its normal points back at it
+        float plane_distance = normal[0] * origin[0] + normal[1] * origin[1] + normal[2] * origin[2];
+        if (plane_distance >= 0)
+        {
+            continue;
+        }
+
+        float corner_x[4], corner_y[4];
+        for (int corner = 0; corner < 4; corner++)
+        {
+            float point[3];
+            for (int row = 0; row < 3; row++)
+            {
+                point[row] = origin[row] + (corner & 1) * u_edge[row] + (corner >> 1) * v_edge[row];
+            }
+            corner_x[corner] = (screen_center_x + x_scale * point[0] / point[2]) * factor;
+            corner_y[corner] = (screen_center_y + display_field_of_view * point[1] / point[2]) * factor;
+        }
+
+        float minimum_x = fminf(fminf(corner_x[0], corner_x[1]), fminf(corner_x[2], corner_x[3]));
+        float maximum_x = fmaxf(fmaxf(corner_x[0], corner_x[1]), fmaxf(corner_x[2], corner_x[3]));
+        float minimum_y = fminf(fminf(corner_y[0], corner_y[1]), fminf(corner_y[2], corner_y[3]));
+        float maximum_y = fmaxf(fmaxf(corner_y[0], corner_y[1]), fmaxf(corner_y[2], corner_y[3]));
+
+        int first_column = minimum_x < 0 ? 0 : (int)minimum_x;
+        int last_column = maximum_x >= sample_columns ? sample_columns - 1 : (int)maximum_x;
+        int first_row = minimum_y < 0 ? 0 : (int)minimum_y;
+        int last_row = maximum_y >= sample_rows ? sample_rows - 1 : (int)maximum_y;
+
+        // Each sub-cell is one sample, so pick the pattern level for the sub-cell resolution
+        int mip_level = select_face_mip_level(face,
+                                              hypotf(corner_x[1] - corner_x[0], corner_y[1] - corner_y[0]),
+                                              hypotf(corner_x[2] - corner_x[0], corner_y[2] - corner_y[0]));
+        uint8_t solid_value = (uint8_t)(get_glyph_density(frame->default_character) *
+                                        coverage->maximum_sample_value + 0.5f);
+
+        float u_edge_inverse_length = 1.0f / (u_edge[0] * u_edge[0] + u_edge[1] * u_edge[1] +
+                                              u_edge[2] * u_edge[2]);
+        float v_edge_inverse_length = 1.0f / (v_edge[0] * v_edge[0] + v_edge[1] * v_edge[1] +
+                                              v_edge[2] * v_edge[2]);
+        float origin_dot_u = origin[0] * u_edge[0] + origin[1] * u_edge[1] + origin[2] * u_edge[2];
+        float origin_dot_v = origin[0] * v_edge[0] + origin[1] * v_edge[1] + origin[2] * v_edge[2];
+
+        for (int sample_row = first_row; sample_row <= last_row; sample_row++)
+        {
+            uint8_t *samples = coverage->samples + (size_t)sample_row * coverage->stride;
+
+            // Ray direction (ray_x, ray_y, 1) through the sub-cell centre; ray_x steps linearly
+            float ray_y = ((sample_row + 0.5f) / factor - screen_center_y) / display_field_of_view;
+            float ray_x_start = ((first_column + 0.5f) / factor - screen_center_x) / x_scale;
+            float ray_x_step = 1.0f / (factor * x_scale);
+
+            float normal_dot_ray = normal[0] * ray_x_start + normal[1] * ray_y + normal[2];
+            float u_dot_ray = u_edge[0] * ray_x_start + u_edge[1] * ray_y + u_edge[2];
+            float v_dot_ray = v_edge[0] * ray_x_start + v_edge[1] * ray_y + v_edge[2];
+
+            for (int sample_column = first_column; sample_column <= last_column; sample_column++)
+            {
+                float hit_distance = plane_distance / normal_dot_ray;
+                float u = (hit_distance * u_dot_ray - origin_dot_u) * u_edge_inverse_length;
+                float v = (hit_distance * v_dot_ray - origin_dot_v) * v_edge_inverse_length;
+
+                if (u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f)
+                {
+                    uint8_t value = solid_value;
+                    if (face->mip_level_count > 0)
+                    {
+                        char glyph = get_face_character_from_level(face, mip_level, u, v, ' ');
+                        value = (uint8_t)(get_glyph_density(glyph) *
+                                          coverage->maximum_sample_value + 0.5f);
+                    }
+                    samples[sample_column] = value;
+                }
+
+                normal_dot_ray += normal[0] * ray_x_step;
+                u_dot_ray += u_edge[0] * ray_x_step;
+                v_dot_ray += v_edge[0] * ray_x_step;
+            }
+        }
+    }
+
+    resolve_coverage_to_glyphs(coverage, display_frame_buffer);
+}
+
+void calculate_display_frame(CoverageBuffer *coverage)
+{
+    if (coverage != NULL)
+    {
+        calculate_antialiased_display_output(coverage);
+        return;
+    }
+
+    // Set memory for buffers:
+    // - memset function takes in the following parameters:
+    //   1. Pointer to the block of memory to fill
+    //   2. Value to be set
+    //   3. Number of bytes to be set to the value
+
+    // Here, we set the display frame buffer to the background ASCII character
+    memset(display_frame_buffer,
+           display_background_ascii_character,
+           DISPLAY_WIDTH * DISPLAY_HEIGHT);
+
+    // Here, we set the z-depth buffer to 0
+    memset(z_depth_buffer, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT * 4);
+
+    calculate_shape_display_output();
+}
+
+void run_benchmark(int frame_count, CoverageBuffer *coverage)
+{
+    struct timespec start_time, end_time;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        update_orientation_matrix(&shape_orientation);
+        calculate_display_frame(coverage);
+        step_orientation(&shape_orientation);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    double elapsed_microseconds = (end_time.tv_sec - start_time.tv_sec) * 1e6 +
+                                  (end_time.tv_nsec - start_time.tv_nsec) / 1e3;
+
+    printf("%s: %d frames, %.1f us/frame\n",
+           coverage != NULL ? (coverage->factor == 4 ? "antialias 4x4" : "antialias 2x2")
+                            : "point sampled",
+           frame_count, elapsed_microseconds / frame_count);
+}
+
+void handle_termination_signal(int signal_number)
+{
+    (void)signal_number;
+    terminate_requested = 1;
+}
+
+void enable_interactive_rotation()
+{
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &original_terminal_mode) != 0)
+    {
+        return;
+    }
+
+    struct termios interactive_mode = original_terminal_mode;
+    interactive_mode.c_lflag &= ~(ICANON | ECHO);
+    interactive_mode.c_cc[VMIN] = 0;   // read() returns immediately when no key is pending
+    interactive_mode.c_cc[VTIME] = 0;
+
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &interactive_mode) == 0)
+    {
+        interactive_rotation_enabled = 1;
+    }
+}
+
+void restore_terminal_mode()
+{
+    if (interactive_rotation_enabled)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &original_terminal_mode);
+        interactive_rotation_enabled = 0;
+    }
+}
+
+void apply_interactive_rotation()
+{
+    char key;
+
+    if (!interactive_rotation_enabled)
+    {
+        return;
+    }
+
+    while (read(STDIN_FILENO, &key, 1) == 1)
+    {
+        switch (key)
+        {
+            case 'w': rotate_orientation(&shape_orientation, 1, 0, 0, INTERACTIVE_ROTATION_STEP);  break;
+            case 's': rotate_orientation(&shape_orientation, 1, 0, 0, -INTERACTIVE_ROTATION_STEP); break;
+            case 'a': rotate_orientation(&shape_orientation, 0, 1, 0, INTERACTIVE_ROTATION_STEP);  break;
+            case 'd': rotate_orientation(&shape_orientation, 0, 1, 0, -INTERACTIVE_ROTATION_STEP); break;
+            case 'q': rotate_orientation(&shape_orientation, 0, 0, 1, INTERACTIVE_ROTATION_STEP);  break;
+            case 'e': rotate_orientation(&shape_orientation, 0, 0, 1, -INTERACTIVE_ROTATION_STEP); break;
+            default: break;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    asciicast_recorder *recorder = NULL;
+    CoverageBuffer coverage;
+    int antialias_factor = 0;
+    int benchmark_frames = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--antialias") == 0 && i + 1 < argc)
+        {
+            antialias_factor = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+        {
+            benchmark_frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recorder = asciicast_recorder_open(argv[++i], RECORDED_WIDTH, RECORDED_HEIGHT);
+            if (recorder == NULL)
+            {
+                perror("Unable to start recording");
+                return 1;
+            }
+        }
+    }
+
+    signal(SIGINT, handle_termination_signal);
+    signal(SIGTERM, handle_termination_signal);
+
+    initialize_orientation(&shape_orientation, 0.05f, 0.05f, 0.01f);
+
     // Initialize with pizza box - change to &regular_cube or &rectangular_box to see different shapes
     current_shape = &pizza_box;
 
-    printf("\x1b[2J");  // Clear screen
-
-    while(1)
+    for (int face = 0; face < 6; face++)
     {
-        // Set memory for buffers:
-        // - memset function takes in the following parameters:
-        //   1. Pointer to the block of memory to fill
-        //   2. Value to be set
-        //   3. Number of bytes to be set to the value
+        if (build_face_pattern_mip_chain(&current_shape->faces[face]) != 0)
+        {
+            perror("Unable to build face pattern mip chain");
+            return 1;
+        }
+    }
 
-        // Here, we set the display frame buffer to the background ASCII character
-        memset(display_frame_buffer,
-               display_background_ascii_character,
-               DISPLAY_WIDTH * DISPLAY_HEIGHT);
+    if (antialias_factor > 0 &&
+        create_coverage_buffer(&coverage, DISPLAY_WIDTH, DISPLAY_HEIGHT, antialias_factor) != 0)
+    {
+        fprintf(stderr, "Antialias factor must be 2 or 4\n");
+        return 1;
+    }
 
-        // Here, we set the z-depth buffer to 0
-        memset(z_depth_buffer, 0, DISPLAY_WIDTH * DISPLAY_HEIGHT * 4);
+    if (benchmark_frames > 0)
+    {
+        run_benchmark(benchmark_frames, antialias_factor > 0 ? &coverage : NULL);
+        terminate_requested = 1;
+    }
+    else
+    {
+        enable_interactive_rotation();
+        printf("\x1b[2J");  // Clear screen
+    }
 
-        calculate_shape_display_output();
+    while(!terminate_requested)
+    {
+        apply_interactive_rotation();
+        update_orientation_matrix(&shape_orientation);
+        calculate_display_frame(antialias_factor > 0 ? &coverage : NULL);
 
         printf("\x1b[H");  // Reset cursor to top-left position
 
@@ -288,11 +837,41 @@ int main() {
             putchar(k % DISPLAY_WIDTH ? display_frame_buffer[k] : 10);
         }
 
-        rotation_angle_A += 0.05;
-        rotation_angle_B += 0.05;
-        rotation_angle_C += 0.01;
+        // Record what the terminal shows: a blank first line, then every column but the one
+        // printed as the newline
+        if (recorder != NULL) {
+            memset(recorded_frame_buffer, ' ', RECORDED_WIDTH);
+            for (int row = 0; row < DISPLAY_HEIGHT; row++) {
+                memcpy(&recorded_frame_buffer[(row + 1) * RECORDED_WIDTH],
+                       &display_frame_buffer[row * DISPLAY_WIDTH + 1], RECORDED_WIDTH);
+            }
+            asciicast_recorder_push_frame(recorder, recorded_frame_buffer);
+        }
+
+        step_orientation(&shape_orientation);
 
         usleep(30000);  // Sleep for 60 milliseconds
     }
-    return 0; // Program should never reach here
+
+    restore_terminal_mode();
+
+    if (recorder != NULL)
+    {
+        fprintf(stderr, "Recorded %llu frames, dropped %llu\n",
+                (unsigned long long)asciicast_recorder_recorded_frames(recorder),
+                (unsigned long long)asciicast_recorder_dropped_frames(recorder));
+        asciicast_recorder_close(recorder);
+    }
+
+    if (antialias_factor > 0)
+    {
+        destroy_coverage_buffer(&coverage);
+    }
+
+    for (int face = 0; face < 6; face++)
+    {
+        free_face_pattern_mip_chain(&current_shape->faces[face]);
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -21,16 +21,37 @@
 /* SHAPE CONFIGURATION                                                                            */
 /*------------------------------------------------------------------------------------------------*/
 
+#define FACE_PATTERN_MAX_MIP_LEVELS 8
+
+/**
+ * One level of a face pattern's mip chain
+ * - glyphs: width * height characters stored row-major in one contiguous block
+ * - width: number of columns at this level
+ * - height: number of rows at this level
+ */
+typedef struct {
+    const char *glyphs;
+    int width;
+    int height;
+} FacePatternMipLevel;
+
 /**
  * Face pattern structure
  * - pattern: 2D array of characters to display on the face
  * - width: number of columns in the pattern
  * - height: number of rows in the pattern
+ * - mip_levels: downsampled copies of the pattern, level 0 is full resolution and each level
+ *   halves both dimensions (filled in by build_face_pattern_mip_chain, leave unset in configs)
+ * - mip_level_count: number of valid entries in mip_levels, 0 for solid faces
+ * - mip_storage: single allocation backing every level's glyphs
  */
 typedef struct {
     const char **pattern;
     int width;
     int height;
+    FacePatternMipLevel mip_levels[FACE_PATTERN_MAX_MIP_LEVELS];
+    int mip_level_count;
+    char *mip_storage;
 } FacePattern;
 
 /**
@@ -99,4 +120,87 @@ static inline char get_face_character(const FacePattern *face, float u, float v,
     return face->pattern[y][x];
 }
 
+/**
+ * Get a character from one level of a face pattern's mip chain at normalized coordinates
+ * Falls back to the default character for solid faces (no mip chain)
+ */
+static inline char get_face_character_from_level(const FacePattern *face, int mip_level, float u,
+                                                 float v, char default_char)
+{
+    if (face->mip_level_count == 0) {
+        return default_char;
+    }
+
+    const FacePatternMipLevel *level = &face->mip_levels[mip_level];
+
+    int x = (int)(u * (level->width - 1));
+    int y = (int)(v * (level->height - 1));
+
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x >= level->width) x = level->width - 1;
+    if (y >= level->height) y = level->height - 1;
+
+    return level->glyphs[y * level->width + x];
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/* MIP CHAIN FUNCTIONS                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name build_face_pattern_mip_chain
+ * @brief Preprocesses a face pattern into a chain of downsampled glyph grids. Each level halves
+ *        the previous one; every 2x2 block is reduced to the glyph in the block whose visual
+ *        density is closest to the block's average density, so the pattern keeps its own
+ *        alphabet while small faces stop flickering between unrelated glyphs.
+ *
+ * @param face
+ *
+ * @return int  0 on success, -1 if the chain could not be allocated
+ */
+/**************************************************************************************************/
+int build_face_pattern_mip_chain(FacePattern *face);
+
+/**************************************************************************************************/
+/**
+ * @name free_face_pattern_mip_chain
+ * @brief Releases the storage allocated by build_face_pattern_mip_chain.
+ *
+ * @param face
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void free_face_pattern_mip_chain(FacePattern *face);
+
+/**************************************************************************************************/
+/**
+ * @name get_glyph_density
+ * @brief Returns how much ink a glyph shows, from 0.0 (space) to 1.0 (densest glyph).
+ *
+ * @param glyph
+ *
+ * @return float
+ */
+/**************************************************************************************************/
+float get_glyph_density(char glyph);
+
+/**************************************************************************************************/
+/**
+ * @name select_face_mip_level
+ * @brief Picks the mip level whose resolution best matches the face's projected size, where
+ *        one pattern texel covers at least one screen cell along both axes.
+ *
+ * @param face
+ * @param projected_u_cells  Length of the face's u edge on screen, in cells
+ * @param projected_v_cells  Length of the face's v edge on screen, in cells
+ *
+ * @return int
+ */
+/**************************************************************************************************/
+int select_face_mip_level(const FacePattern *face, float projected_u_cells,
+                          float projected_v_cells);
+
 #endif // SHAPE_H
@@ -0,0 +1,132 @@
+/**************************************************************************************************/
+/**
+ * @file orientation_stability.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Long-run stability test for the incremental quaternion orientation: steps it as many
+ *        frames as the renderers would in years and checks that the quaternion stays unit
+ *        length and its matrix stays a rotation.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "orientation.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define STABILITY_STEPS             100000000L  // 10^8 frames, over a year at 30 frames a second
+#define STABILITY_MATRIX_INTERVAL   1000        // Steps between rotation matrix checks
+#define STABILITY_NORM_TOLERANCE    1e-5
+#define STABILITY_MATRIX_TOLERANCE  1e-5
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name get_norm_error
+ * @brief Returns how far the quaternion's length is from 1.
+ *
+ * @param orientation
+ *
+ * @return double   ||q| - 1|
+ */
+/**************************************************************************************************/
+static double get_norm_error(const Orientation *orientation);
+
+/**************************************************************************************************/
+/**
+ * @name get_orthogonality_error
+ * @brief Returns the largest element of R R^T - I for the orientation's rotation matrix.
+ *
+ * @param orientation
+ *
+ * @return double
+ */
+/**************************************************************************************************/
+static double get_orthogonality_error(const Orientation *orientation);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static double get_norm_error(const Orientation *orientation)
+{
+    const Quaternion *q = &orientation->rotation;
+
+    return fabs(sqrt((double)q->w * q->w + (double)q->x * q->x + (double)q->y * q->y +
+                     (double)q->z * q->z) - 1.0);
+}
+
+static double get_orthogonality_error(const Orientation *orientation)
+{
+    double error = 0.0;
+
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            double product = 0.0;
+
+            for (int k = 0; k < 3; k++)
+            {
+                product += (double)orientation->rotation_matrix[row][k] *
+                           orientation->rotation_matrix[column][k];
+            }
+            error = fmax(error, fabs(product - (row == column ? 1.0 : 0.0)));
+        }
+    }
+
+    return error;
+}
+
+int main(void)
+{
+    Orientation orientation;
+    double max_norm_error = 0.0;
+    double max_orthogonality_error = 0.0;
+
+    // The increments both renderers use
+    initialize_orientation(&orientation, 0.05f, 0.05f, 0.01f);
+
+    for (long step = 1; step <= STABILITY_STEPS; step++)
+    {
+        step_orientation(&orientation);
+
+        max_norm_error = fmax(max_norm_error, get_norm_error(&orientation));
+
+        if (step % STABILITY_MATRIX_INTERVAL == 0)
+        {
+            update_orientation_matrix(&orientation);
+            max_orthogonality_error = fmax(max_orthogonality_error,
+                                           get_orthogonality_error(&orientation));
+        }
+    }
+
+    printf("After %ld steps: max ||q| - 1| = %.3g, max |R R^T - I| = %.3g\n", STABILITY_STEPS,
+           max_norm_error, max_orthogonality_error);
+
+    if (max_norm_error > STABILITY_NORM_TOLERANCE ||
+        max_orthogonality_error > STABILITY_MATRIX_TOLERANCE)
+    {
+        fprintf(stderr, "Orientation drifted beyond tolerance %g / %g\n",
+                STABILITY_NORM_TOLERANCE, STABILITY_MATRIX_TOLERANCE);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -25,18 +25,42 @@
 #include <time.h>
 #include <math.h>
 #include <stdbool.h>
+#include <poll.h>
+#include <signal.h>
 
-#include "textures.h"
-#include "sprites.h"
-#include "background.h"
+#include "texture_cache.h"
+#include "batch.h"
+#include "game.h"
+#include "histogram.h"
+#include "input_log.h"
+#include "input_queue.h"
+#include "perf_hud.h"
 #include "terminal.h"
 #include "render.h"
+#include "spectator.h"
+#include "presenter.h"
 
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
 /*------------------------------------------------------------------------------------------------*/
 
+#define NANOSECONDS_PER_SECOND          1000000000LL
+#define NANOSECONDS_PER_MILLISECOND     1000000LL
 
+// The simulation always advances in 40 ms ticks, the pace the game was tuned at
+#define SIMULATION_TICK_NANOSECONDS     (NANOSECONDS_PER_SECOND / 25)
+
+// Frames are rendered up to 60 times per second, interpolated between ticks
+#define RENDER_FRAME_NANOSECONDS        (NANOSECONDS_PER_SECOND / 60)
+
+// After a stall (e.g. a suspended terminal) at most this many ticks are caught up
+#define MAX_CATCH_UP_TICKS              5
+
+#define BENCHMARK_DEFAULT_SEED          1       // Reproducible benchmarks unless --seed is given
+#define BENCHMARK_INTERPOLATION         0.5f    // Frames land between ticks, as in real play
+
+#define FRAME_HASH_OFFSET_BASIS         0xcbf29ce484222325ULL   // 64-bit FNV-1a
+#define FRAME_HASH_PRIME                0x100000001b3ULL
 
 /*------------------------------------------------------------------------------------------------*/
 /* GLOBAL VARIABLES                                                                               */
@@ -51,57 +75,687 @@
 // While function prototypes are not required for this file, I am writing these prototypes for
 // clarity and explanation of the purpose of each function for my own learning.
 
+/**************************************************************************************************/
+/**
+ * @name    sleep_until
+ * @brief   Sleeps until a CLOCK_MONOTONIC deadline, returning at once if it has passed.
+ *
+ * @param   deadline    In nanoseconds
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void sleep_until(int64_t deadline);
+
+/**************************************************************************************************/
+/**
+ * @name    hash_bytes
+ * @brief   Folds bytes (a composed frame, encoded output) into a running 64-bit FNV-1a hash.
+ *
+ * @param   hash
+ * @param   bytes
+ * @param   length
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+static uint64_t hash_bytes(uint64_t hash, const void *bytes, size_t length);
+
+/**************************************************************************************************/
+/**
+ * @name    run_replay
+ * @brief   Re-runs a recorded session headlessly, as fast as the CPU allows. The logged keys are
+ *          applied at the ticks they were recorded at, and every tick's frame is composed and
+ *          hashed, so two replays of one log print the same hash exactly when they behave the
+ *          same.
+ *
+ * @param   path    Input log written with --record-input
+ *
+ * @return  int     Process exit status
+ */
+/**************************************************************************************************/
+static int run_replay(const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    run_benchmark
+ * @brief   Runs frames back to back with no pacing and no terminal. Each frame runs one
+ *          simulation tick, composes the frame and encodes its delta into the presenter's buffer
+ *          without writing it. The three steps are timed separately. Collisions are ignored so
+ *          every run covers the same number of frames.
+ *
+ *          The frame hash covers every composed frame and the output hash every encoded delta,
+ *          so a change to the blitter, compositor or presenter can be checked for identical
+ *          output as well as for speed.
+ *
+ * @param   frame_count
+ * @param   seed
+ * @param   particle_counts     Particles of each kind
+ *
+ * @return  int     Process exit status
+ */
+/**************************************************************************************************/
+static int run_benchmark(long frame_count, uint64_t seed,
+                         const int particle_counts[PARTICLE_KIND_COUNT]);
+
+/**************************************************************************************************/
+/**
+ * @name    set_particle_counts
+ * @brief   Replaces a game's particles with the given number of each kind.
+ *
+ * @param   game
+ * @param   seed
+ * @param   particle_counts     Particles of each kind
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+static int set_particle_counts(dino_game *game, uint64_t seed,
+                               const int particle_counts[PARTICLE_KIND_COUNT]);
+
+/**************************************************************************************************/
+/**
+ * @name    run_batch_simulation
+ * @brief   Plays a batch of autoplayed games with run_batch and prints how long they survived.
+ *
+ * @param   options
+ *
+ * @return  int     Process exit status
+ */
+/**************************************************************************************************/
+static int run_batch_simulation(const batch_options *options);
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION DEFINITIONS                                                                           */
 /*------------------------------------------------------------------------------------------------*/
 
-int main() {
-    srand(time(NULL)); // Seed random number generator
+static void sleep_until(int64_t deadline)
+{
+    int64_t remaining = deadline - get_monotonic_nanoseconds();
+
+    if (remaining > 0)
+    {
+        struct timespec duration = {
+            .tv_sec = (time_t)(remaining / NANOSECONDS_PER_SECOND),
+            .tv_nsec = (long)(remaining % NANOSECONDS_PER_SECOND)
+        };
+        nanosleep(&duration, NULL);
+    }
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void *bytes, size_t length)
+{
+    const unsigned char *data = bytes;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * FRAME_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+static int run_replay(const char *path)
+{
+    input_replay replay;
+
+    if (load_input_replay(&replay, path) != 0)
+    {
+        fprintf(stderr, "Unable to read input log %s\n", path);
+        return 1;
+    }
+
+    static dino_game game;
+
+    if (initialize_game(&game, replay.seed, GAME_DEFAULT_SCROLL_SPEED) != 0)
+    {
+        perror("Unable to create the game");
+        free_input_replay(&replay);
+        return 1;
+    }
+
+    char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
+    uint64_t frame_hash = FRAME_HASH_OFFSET_BASIS;
+    bool quit = false;
+    int64_t start_time = get_monotonic_nanoseconds();
+
+    // A log without a final quit event (e.g. the game was killed) ends after its last event
+    while (!game.game_over && !quit && replay.next_event < replay.event_count)
+    {
+        bool jump = false;
+
+        for (; replay.next_event < replay.event_count &&
+               replay.events[replay.next_event].tick == game.tick; replay.next_event++)
+        {
+            if (replay.events[replay.next_event].key == INPUT_KEY_JUMP)
+            {
+                jump = true;
+            }
+            else if (replay.events[replay.next_event].key == INPUT_KEY_QUIT)
+            {
+                quit = true;
+            }
+        }
+        if (quit)
+        {
+            break;
+        }
+
+        advance_game(&game, jump);
+
+        compose_frame(frame, &game.character, &game.background, &game.obstacles, 0.0f, NULL);
+        frame_hash = hash_bytes(frame_hash, frame, sizeof(frame));
+    }
+
+    int64_t elapsed = get_monotonic_nanoseconds() - start_time;
+
+    printf("Replayed %u ticks from seed %llu in %.3f ms (%s)\n", game.tick,
+           (unsigned long long)replay.seed, (double)elapsed / NANOSECONDS_PER_MILLISECOND,
+           game.game_over ? "hit an obstacle" : "quit");
+    printf("Frame hash %016llx\n", (unsigned long long)frame_hash);
+
+    free_game(&game);
+    free_input_replay(&replay);
+
+    return 0;
+}
+
+static int run_benchmark(long frame_count, uint64_t seed,
+                         const int particle_counts[PARTICLE_KIND_COUNT])
+{
+    static dino_game game;
+    static frame_presenter presenter;
+
+    if (initialize_game(&game, seed, GAME_DEFAULT_SCROLL_SPEED) != 0 ||
+        set_particle_counts(&game, seed, particle_counts) != 0)
+    {
+        perror("Unable to create the game");
+        return 1;
+    }
+    initialize_presenter(&presenter, RENDER_CONTROLS_TEXT);
+
+    char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
+    uint64_t frame_hash = FRAME_HASH_OFFSET_BASIS;
+    uint64_t output_hash = FRAME_HASH_OFFSET_BASIS;
+    uint64_t output_bytes = 0;
+    int64_t simulate_time = 0;
+    int64_t compose_time = 0;
+    int64_t encode_time = 0;
+    compose_stats overdraw = { 0 };
+
+    for (long i = 0; i < frame_count; i++)
+    {
+        int64_t start_time = get_monotonic_nanoseconds();
+        advance_game(&game, false);
+        int64_t simulated_time = get_monotonic_nanoseconds();
+        compose_frame(frame, &game.character, &game.background, &game.obstacles,
+                      BENCHMARK_INTERPOLATION, &overdraw);
+        int64_t composed_time = get_monotonic_nanoseconds();
+        size_t length = encode_frame_delta(&presenter,
+                                           (const char (*)[TERMINAL_DISPLAY_WIDTH])frame);
+        int64_t encoded_time = get_monotonic_nanoseconds();
+
+        simulate_time += simulated_time - start_time;
+        compose_time += composed_time - simulated_time;
+        encode_time += encoded_time - composed_time;
+
+        frame_hash = hash_bytes(frame_hash, frame, sizeof(frame));
+        output_hash = hash_bytes(output_hash, presenter.output, length);
+        output_bytes += length;
+    }
+
+    double frames = frame_count > 0 ? (double)frame_count : 1.0;
+
+    printf("Benchmarked %ld frames from seed %llu with %d dust, %d rain, %d snow particles\n",
+           frame_count, (unsigned long long)seed, particle_counts[PARTICLE_DUST],
+           particle_counts[PARTICLE_RAIN], particle_counts[PARTICLE_SNOW]);
+    printf("  simulate %10.1f ns/frame\n", (double)simulate_time / frames);
+    printf("  compose  %10.1f ns/frame\n", (double)compose_time / frames);
+    printf("  encode   %10.1f ns/frame, %.1f bytes/frame\n", (double)encode_time / frames,
+           (double)output_bytes / frames);
+    printf("  overdraw %10.2f writes/cell, %.1f hidden cells skipped/frame\n",
+           (double)overdraw.cells_written / (frames * TERMINAL_DISPLAY_WIDTH *
+                                             TERMINAL_DISPLAY_HEIGHT),
+           (double)overdraw.cells_hidden / frames);
+    printf("Frame hash  %016llx\n", (unsigned long long)frame_hash);
+    printf("Output hash %016llx\n", (unsigned long long)output_hash);
+
+    free_game(&game);
+
+    return 0;
+}
+
+static int set_particle_counts(dino_game *game, uint64_t seed,
+                               const int particle_counts[PARTICLE_KIND_COUNT])
+{
+    free_particles(&game->background.particles);
+    return initialize_particles(&game->background.particles, seed, particle_counts);
+}
+
+static int run_batch_simulation(const batch_options *options)
+{
+    batch_game_result *results = calloc((size_t)(options->game_count > 0 ? options->game_count : 1),
+                                        sizeof(batch_game_result));
+    batch_statistics statistics;
+
+    if (results == NULL || run_batch(options, results, &statistics) != 0)
+    {
+        perror("Unable to run the batch");
+        free(results);
+        return 1;
+    }
+
+    double games = options->game_count > 0 ? (double)options->game_count : 1.0;
+    double seconds = (double)statistics.elapsed_nanoseconds / NANOSECONDS_PER_SECOND;
+
+    printf("Simulated %d games from seed %llu at speed %.2f on %d threads in %.1f ms\n",
+           options->game_count, (unsigned long long)options->seed, options->scroll_speed,
+           options->thread_count,
+           (double)statistics.elapsed_nanoseconds / NANOSECONDS_PER_MILLISECOND);
+    printf("  autoplayer: lead %d, reaction 0-%d ticks, %d%% missed\n", options->autoplayer_lead,
+           options->autoplayer_reaction_ticks, options->autoplayer_miss_percent);
+    printf("  ticks survived: mean %.1f, min %u, median %u, max %u\n",
+           (double)statistics.total_ticks / games, statistics.min_ticks,
+           statistics.median_ticks, statistics.max_ticks);
+    printf("  crashed: %d (%.1f%%), reached the %u tick limit: %d\n", statistics.crashed_games,
+           100.0 * statistics.crashed_games / games, options->max_ticks,
+           options->game_count - statistics.crashed_games);
+    printf("  throughput: %.2f M ticks/s, %llu steals\n",
+           seconds > 0 ? (double)statistics.total_ticks / seconds / 1e6 : 0.0,
+           (unsigned long long)statistics.steals);
+
+    free(results);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    asciicast_recorder *recorder = NULL;
+    const char *input_log_path = NULL;
+    const char *replay_path = NULL;
+    const char *atlas_path = NULL;
+    const char *serve_path = NULL;
+    long benchmark_frames = -1;
+    int particle_counts[PARTICLE_KIND_COUNT] = { [PARTICLE_DUST] = PARTICLE_DEFAULT_DUST };
+    batch_options batch = {
+        .game_count = 0,
+        .thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN),
+        .scroll_speed = GAME_DEFAULT_SCROLL_SPEED,
+        .max_ticks = BATCH_DEFAULT_MAX_TICKS,
+        .autoplayer_lead = BATCH_DEFAULT_AUTOPLAYER_LEAD,
+        .autoplayer_reaction_ticks = BATCH_DEFAULT_REACTION_TICKS,
+        .autoplayer_miss_percent = BATCH_DEFAULT_MISS_PERCENT
+    };
+    bool seed_given = false;
+    uint64_t seed = (uint64_t)time(NULL);
+
+    load_textures();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            recorder = asciicast_recorder_open(argv[++i], TERMINAL_DISPLAY_WIDTH,
+                                               TERMINAL_DISPLAY_HEIGHT);
+            if (recorder == NULL)
+            {
+                perror("Unable to start recording");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--record-input") == 0 && i + 1 < argc)
+        {
+            input_log_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replay_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--atlas") == 0 && i + 1 < argc)
+        {
+            atlas_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+        {
+            serve_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--export-atlas") == 0 && i + 1 < argc)
+        {
+            int status = export_texture_atlas(argv[++i]);
+            if (status != 0)
+            {
+                perror("Unable to export the texture atlas");
+            }
+            asciicast_recorder_close(recorder);
+            unload_textures();
+            return status != 0;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], NULL, 0);
+            seed_given = true;
+        }
+        else if (strcmp(argv[i], "--dust") == 0 && i + 1 < argc)
+        {
+            particle_counts[PARTICLE_DUST] = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--rain") == 0 && i + 1 < argc)
+        {
+            particle_counts[PARTICLE_RAIN] = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--snow") == 0 && i + 1 < argc)
+        {
+            particle_counts[PARTICLE_SNOW] = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+        {
+            benchmark_frames = strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+        {
+            batch.game_count = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            batch.thread_count = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            batch.scroll_speed = strtof(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc)
+        {
+            batch.max_ticks = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--lead") == 0 && i + 1 < argc)
+        {
+            batch.autoplayer_lead = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--reaction") == 0 && i + 1 < argc)
+        {
+            batch.autoplayer_reaction_ticks = (int)strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--miss") == 0 && i + 1 < argc)
+        {
+            batch.autoplayer_miss_percent = (int)strtol(argv[++i], NULL, 10);
+        }
+    }
+
+    if (atlas_path != NULL && load_texture_atlas(atlas_path) != 0)
+    {
+        fprintf(stderr, "Unable to load texture atlas %s, using built-in textures\n", atlas_path);
+    }
+
+    if (batch.game_count > 0)
+    {
+        batch.seed = seed_given ? seed : BATCH_DEFAULT_SEED;
+        if (batch.thread_count < 1)
+        {
+            batch.thread_count = 1;
+        }
+        else if (batch.thread_count > BATCH_MAX_THREADS)
+        {
+            batch.thread_count = BATCH_MAX_THREADS;
+        }
+        if (batch.autoplayer_reaction_ticks < 0)
+        {
+            batch.autoplayer_reaction_ticks = 0;
+        }
+
+        int status = run_batch_simulation(&batch);
+        asciicast_recorder_close(recorder);
+        unload_textures();
+        return status;
+    }
+
+    if (benchmark_frames >= 0)
+    {
+        int status = run_benchmark(benchmark_frames, seed_given ? seed : BENCHMARK_DEFAULT_SEED,
+                                   particle_counts);
+        asciicast_recorder_close(recorder);
+        unload_textures();
+        return status;
+    }
+
+    if (replay_path != NULL)
+    {
+        int status = run_replay(replay_path);
+        asciicast_recorder_close(recorder);
+        unload_textures();
+        return status;
+    }
+
+    dino_game game;
+    frame_presenter presenter;
+    perf_hud hud;
+    static spectator_server spectators;    // Too large for the stack with its frame ring
+    bool serving = false;
+    input_log log = { .file = NULL };
+
+    if (initialize_game(&game, seed, GAME_DEFAULT_SCROLL_SPEED) != 0 ||
+        set_particle_counts(&game, seed, particle_counts) != 0)
+    {
+        perror("Unable to create the game");
+        return 1;
+    }
+    if (input_log_path != NULL && open_input_log(&log, input_log_path, seed) != 0)
+    {
+        perror("Unable to start the input log");
+        return 1;
+    }
+    initialize_presenter(&presenter, RENDER_CONTROLS_TEXT);
+
+    // Only the live game is timed; the clock reads cost nothing next to a frame's terminal write
+    initialize_perf_hud(&hud);
+    game.hud = &hud;
+
+    // Only the live game generates ahead; headless runs are faster generating on demand
+    if (start_world_generator(&game.world) != 0)
+    {
+        perror("Unable to start the world generator");
+    }
+
+    // Only the live game reloads textures; headless runs keep the atlas they started with
+    if (atlas_path != NULL && start_texture_watcher(atlas_path) != 0)
+    {
+        perror("Unable to watch the texture atlas");
+    }
 
-    sprite character;
-    background_system background;
+    if (serve_path != NULL)
+    {
+        // A viewer hanging up mid-write must not kill the game
+        signal(SIGPIPE, SIG_IGN);
+        serving = start_spectator_server(&spectators, serve_path) == 0;
+        if (!serving)
+        {
+            perror("Unable to serve spectators");
+        }
+    }
 
-    initialize_sprite(&character);
-    initialize_background(&background);
+    input_queue *keyboard = aligned_alloc(INPUT_QUEUE_CACHE_LINE, sizeof(input_queue));
+    if (keyboard == NULL)
+    {
+        perror("Unable to create the input queue");
+        return 1;
+    }
 
     enable_raw_mode();
     enter_alternate_screen();
 
+    if (start_input_thread(keyboard, STDIN_FILENO) != 0)
+    {
+        disable_raw_mode();
+        perror("Unable to start the input thread");
+        return 1;
+    }
+
     bool terminate_execution = false;
     int frame_count = 0;
-    float display_scroll_speed = 1.5;
+
+    // Key to the tick that applied it, and key to the first frame presented after that tick
+    histogram tick_latency;
+    histogram frame_latency;
+    int64_t unpresented_keys[INPUT_QUEUE_CAPACITY];
+    int unpresented_key_count = 0;
+    reset_histogram(&tick_latency);
+    reset_histogram(&frame_latency);
+
+    int64_t previous_time = get_monotonic_nanoseconds();
+    int64_t next_frame_time = previous_time;
+    int64_t accumulated_time = 0;
 
     while(!terminate_execution)
     {
-        char keyboard_input;
+        int64_t current_time = get_monotonic_nanoseconds();
+        accumulated_time += current_time - previous_time;
+        previous_time = current_time;
+
+        if (accumulated_time > MAX_CATCH_UP_TICKS * SIMULATION_TICK_NANOSECONDS)
+        {
+            accumulated_time = MAX_CATCH_UP_TICKS * SIMULATION_TICK_NANOSECONDS;
+        }
+
+        // Run every whole tick that is due. The simulation only sees ticks and the keys pressed
+        // before each tick ended, never the frame rate, so it plays out the same however fast
+        // frames are rendered and however late the keys are read.
+        int64_t tick_end_time = current_time - accumulated_time + SIMULATION_TICK_NANOSECONDS;
 
-        if (read(STDIN_FILENO, &keyboard_input, 1) == 1)
+        while (accumulated_time >= SIMULATION_TICK_NANOSECONDS)
         {
-            if (keyboard_input == ' ')
+            bool jump_requested = false;
+            timed_input key;
+
+            while (!terminate_execution && take_input_before(keyboard, tick_end_time, &key))
             {
-                sprite_jump(&character);
+                if (key.key == INPUT_KEY_QUIT)
+                {
+                    terminate_execution = true;
+                }
+                else if (key.key == INPUT_KEY_PERF_HUD)
+                {
+                    hud.visible = !hud.visible;
+                }
+                else
+                {
+                    jump_requested = true;
+                    record_histogram(&tick_latency, current_time - key.timestamp);
+                    if (unpresented_key_count < INPUT_QUEUE_CAPACITY)
+                    {
+                        unpresented_keys[unpresented_key_count++] = key.timestamp;
+                    }
+                }
             }
 
-            else if (keyboard_input == 'q' || keyboard_input == 'Q')
+            if (terminate_execution)
+            {
+                break;
+            }
+
+            if (jump_requested)
+            {
+                write_input_event(&log, game.tick, INPUT_KEY_JUMP);
+            }
+
+            if (advance_game(&game, jump_requested))
             {
                 terminate_execution = true;
+                break;
             }
+
+            accumulated_time -= SIMULATION_TICK_NANOSECONDS;
+            tick_end_time += SIMULATION_TICK_NANOSECONDS;
         }
 
-        update_sprite_position(&character);
-        update_background(&background, display_scroll_speed);
+        // A tick that applied a key is shown straight away rather than at the next frame slot
+        if (current_time >= next_frame_time || unpresented_key_count > 0)
+        {
+            // The strips hold copies of the old art, so they are redrawn from the new textures
+            if (refresh_textures())
+            {
+                redraw_background_strips(&game.background);
+            }
 
-        render(&character, &background);
+            float interpolation = (float)accumulated_time / SIMULATION_TICK_NANOSECONDS;
+            render(&game.character, &game.background, &game.obstacles, interpolation, &presenter,
+                   recorder, &hud, serving ? &spectators : NULL);
+
+            int64_t presented_time = get_monotonic_nanoseconds();
+            record_perf_frame(&hud, presented_time, presenter.output_length);
+            for (int i = 0; i < unpresented_key_count; i++)
+            {
+                record_histogram(&frame_latency, presented_time - unpresented_keys[i]);
+            }
+            unpresented_key_count = 0;
 
-        usleep(40000); // Roughly 30 FPS
+            frame_count++;
+            if (current_time >= next_frame_time)
+            {
+                next_frame_time += RENDER_FRAME_NANOSECONDS;
+                if (next_frame_time < current_time)
+                {
+                    // Fell behind: skip the missed slots rather than rendering them back to back
+                    hud.dropped_frames += (uint64_t)((current_time - next_frame_time) /
+                                                     RENDER_FRAME_NANOSECONDS + 1);
+                    next_frame_time = current_time + RENDER_FRAME_NANOSECONDS;
+                }
+            }
+        }
 
-        frame_count++;
+        // Wake at the next tick boundary or frame, whichever is first. Keys wait in the queue
+        // meanwhile and are applied by the tick they were pressed in.
+        sleep_until(tick_end_time < next_frame_time ? tick_end_time : next_frame_time);
     }
 
+    stop_input_thread(keyboard);
     disable_raw_mode();
     printf("Game Over!\n");
 
+    if (recorder != NULL)
+    {
+        printf("Recorded %llu frames, dropped %llu\n",
+               (unsigned long long)asciicast_recorder_recorded_frames(recorder),
+               (unsigned long long)asciicast_recorder_dropped_frames(recorder));
+        asciicast_recorder_close(recorder);
+    }
+
+    if (serving)
+    {
+        stop_spectator_server(&spectators);
+        printf("Served %llu viewers, resynced %llu times, dropped %llu frames\n",
+               (unsigned long long)spectators.viewers, (unsigned long long)spectators.resyncs,
+               (unsigned long long)spectators.dropped_frames);
+    }
+
+    if (log.file != NULL)
+    {
+        write_input_event(&log, game.tick, INPUT_KEY_QUIT);
+        if (close_input_log(&log) != 0)
+        {
+            perror("Unable to finish the input log");
+        }
+        else
+        {
+            printf("Logged input for %u ticks from seed %llu\n", game.tick,
+                   (unsigned long long)seed);
+        }
+    }
+
+    if (tick_latency.count > 0)
+    {
+        print_histogram(stdout, "Key to tick", &tick_latency);
+        print_histogram(stdout, "Key to frame", &frame_latency);
+    }
+
+    print_perf_hud(stderr, &hud);
+
+    uint64_t dropped_keys = atomic_load(&keyboard->dropped);
+    if (dropped_keys > 0)
+    {
+        printf("Dropped %llu keys from a full input queue\n", (unsigned long long)dropped_keys);
+    }
+
+    free(keyboard);
+    free_game(&game);
+    unload_textures();
+
     return 0;
 }
-
-// End of dino.c
\ No newline at end of file
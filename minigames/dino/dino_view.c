@@ -0,0 +1,159 @@
+/**************************************************************************************************/
+/**
+ * @file dino_view.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Watches a dino game served with --serve: copies the stream from its socket to the
+ *        terminal until the game ends or Ctrl-C is pressed
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define VIEW_READ_LENGTH        65536
+#define VIEW_ENTER_SCREEN       "\033[?1049h\033[H"     // Alternate screen, cursor home
+#define VIEW_LEAVE_SCREEN       "\033[?25h\033[?1049l"  // Show the cursor, main screen
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+static volatile sig_atomic_t interrupted = 0;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    handle_interrupt
+ * @brief   Makes the copy loop stop so the terminal is restored before exiting.
+ *
+ * @param   signal_number
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void handle_interrupt(int signal_number);
+
+/**************************************************************************************************/
+/**
+ * @name    write_all
+ * @brief   Writes every byte to a descriptor, retrying partial writes.
+ *
+ * @param   descriptor
+ * @param   bytes
+ * @param   length
+ *
+ * @return  int     0 on success, -1 on failure
+ */
+/**************************************************************************************************/
+static int write_all(int descriptor, const char *bytes, size_t length);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void handle_interrupt(int signal_number)
+{
+    (void)signal_number;
+    interrupted = 1;
+}
+
+static int write_all(int descriptor, const char *bytes, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(descriptor, bytes, length);
+
+        if (written < 0)
+        {
+            if (errno == EINTR && !interrupted)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        bytes += written;
+        length -= (size_t)written;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+    if (argc != 2 || strlen(argv[1]) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Usage: %s SOCKET\n", argv[0]);
+        return 2;
+    }
+    strcpy(address.sun_path, argv[1]);
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0 || connect(descriptor, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        perror("Unable to connect to the game");
+        return 1;
+    }
+
+    // No SA_RESTART: the blocking read must return so the loop sees the flag
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_interrupt;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    write_all(STDOUT_FILENO, VIEW_ENTER_SCREEN, strlen(VIEW_ENTER_SCREEN));
+
+    char bytes[VIEW_READ_LENGTH];
+    ssize_t length = 0;
+
+    while (!interrupted)
+    {
+        length = read(descriptor, bytes, sizeof(bytes));
+
+        if (length < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (length <= 0 || write_all(STDOUT_FILENO, bytes, (size_t)length) != 0)
+        {
+            break;
+        }
+    }
+
+    write_all(STDOUT_FILENO, VIEW_LEAVE_SCREEN, strlen(VIEW_LEAVE_SCREEN));
+    close(descriptor);
+
+    if (!interrupted)
+    {
+        fprintf(stderr, length == 0 ? "The game ended\n" : "Lost the game's stream\n");
+    }
+
+    return 0;
+}
+
+// End of dino_view.c
@@ -19,13 +19,15 @@
 // HEADERS                                                                                        */
 /*------------------------------------------------------------------------------------------------*/
 
-
+#include <stdbool.h>
+#include <stdint.h>
 
 /*------------------------------------------------------------------------------------------------*/
 // GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
 
-
+// Widest texture that gets collision masks, one bit per column in a uint64_t
+#define ASCII_MASK_MAX_WIDTH    64
 
 /*------------------------------------------------------------------------------------------------*/
 // CLASS DECLARATIONS                                                                             */
@@ -35,13 +37,73 @@ typedef struct {
     int width;
     int height;
     const char **lines;  // Array of strings, each representing a row of the sprite
+    bool opaque_spaces;  // Draw spaces over the background instead of treating them as transparent
 } ascii_object;
 
+/**
+ * Run of consecutive opaque characters in one row of a texture
+ * - offset: column of the first character, relative to the texture's left edge
+ * - length: number of characters in the run
+ * - characters: the run's characters, pointing into the texture's source line
+ */
+typedef struct {
+    int offset;
+    int length;
+    const char *characters;
+} ascii_span;
+
+/**
+ * Texture compiled into per-row lists of opaque spans, so drawing it is one memcpy per span
+ * - width, height: size of the texture's bounding rectangle
+ * - row_first_span: index into spans of each row's first span, with one extra entry at the end
+ *   so row r owns spans[row_first_span[r]] up to spans[row_first_span[r + 1]]
+ * - spans: every span of every row, in row order
+ * - row_masks: one collision mask per row, bit c set when column c holds a visible character.
+ *   Spaces never collide, even in textures with opaque_spaces. NULL for textures wider than
+ *   ASCII_MASK_MAX_WIDTH.
+ *
+ * The tables are read-only: built-in textures point them at constant data generated at build
+ * time, and compile_ascii_object at memory it allocates.
+ */
+typedef struct {
+    int width;
+    int height;
+    const int *row_first_span;
+    const ascii_span *spans;
+    const uint64_t *row_masks;
+} compiled_ascii_object;
+
 /*------------------------------------------------------------------------------------------------*/
 // FUNCTION DECLARATIONS                                                                          */
 /*------------------------------------------------------------------------------------------------*/
 
+/**************************************************************************************************/
+/**
+ * @name    compile_ascii_object
+ * @brief   Compiles a texture into per-row lists of opaque spans and, for textures no wider than
+ *          ASCII_MASK_MAX_WIDTH, per-row collision masks. Rows are only read up to their real
+ *          length, so a row shorter than the declared width is padded with transparency instead
+ *          of reading past the end of its string.
+ *
+ * @param   object      Texture to compile
+ * @param   compiled    Receives the compiled texture, which keeps pointers into object's lines
+ *
+ * @return  int         0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int compile_ascii_object(const ascii_object *object, compiled_ascii_object *compiled);
 
+/**************************************************************************************************/
+/**
+ * @name    free_compiled_ascii_object
+ * @brief   Releases the span lists and collision masks of a texture from compile_ascii_object.
+ *
+ * @param   compiled
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_compiled_ascii_object(compiled_ascii_object *compiled);
 
 #endif // ASCII_H
 
@@ -19,38 +19,90 @@
 // HEADERS                                                                                        */
 /*------------------------------------------------------------------------------------------------*/
 
+#include "entity_store.h"
+#include "particles.h"
 #include "terminal.h"
-#include "ascii.h"
+#include "texture_cache.h"
 
 /*------------------------------------------------------------------------------------------------*/
 // GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
 
 #define NUM_LAYERS                  4
-#define MAX_ELEMENTS_PER_LAYER      10
+
+// Elements are dropped once this far past the left edge. Scenery is at most the screen width wide,
+// so by then even the widest element is off screen and a redraw has nothing to restore for it.
+#define BACKGROUND_WRAP_DISTANCE    (TERMINAL_DISPLAY_WIDTH + LAYER_STRIP_TRAILING_COLUMNS)
+#define BACKGROUND_SPAWN_DISTANCE   80      // Elements enter up to this far past the right edge
+
+// Ring strip width, a power of two so world columns map to strip columns with a mask. It must
+// hold everything from the screen's left edge to the farthest edge of a freshly added element.
+#define LAYER_STRIP_WIDTH           256
+#define LAYER_STRIP_MASK            (LAYER_STRIP_WIDTH - 1)
+#define LAYER_STRIP_WORDS           (LAYER_STRIP_WIDTH / 64)   // Opacity bitmap words per row
+
+// The first columns of every strip row are mirrored past its end, so the visible window is always
+// one contiguous run of cells the compositor can copy from.
+#define LAYER_STRIP_APRON           TERMINAL_DISPLAY_WIDTH
+
+// Columns kept behind the scroll position, since interpolated frames show up to one tick earlier
+#define LAYER_STRIP_TRAILING_COLUMNS 2
+
+_Static_assert(LAYER_STRIP_WIDTH >= TERMINAL_DISPLAY_WIDTH + BACKGROUND_SPAWN_DISTANCE +
+                                    BACKGROUND_WRAP_DISTANCE + LAYER_STRIP_TRAILING_COLUMNS + 16,
+               "Layer strips are too narrow for the element spawn range");
 
 /*------------------------------------------------------------------------------------------------*/
 // CLASS DECLARATIONS                                                                             */
 /*------------------------------------------------------------------------------------------------*/
 
+/**
+ * Off-screen ring strip holding a layer's pre-rendered elements. Elements are stamped once at
+ * world column (screen column + scroll_column) when they are placed, and the screen shows the
+ * TERMINAL_DISPLAY_WIDTH columns starting at world column scroll_column.
+ * - cells: stamped elements, ' ' where the layer is transparent, followed by the mirrored apron
+ * - opaque: bit c % 64 of word c / 64 is set when ring column c of the row is not ' ', so the
+ *   compositor can test 64 cells at once. The apron is not mirrored here.
+ * - scroll_column: world column at the screen's left edge
+ * - scroll_fraction: sub-column part of the scroll position, kept apart so it never loses
+ *   precision however far the layer scrolls
+ * - last_scroll_distance: columns scrolled by the last simulation tick, used to interpolate
+ * - cleared_column: world columns before this one have scrolled off and been blanked for reuse.
+ *   LAYER_STRIP_TRAILING_COLUMNS columns are kept behind scroll_column for interpolated frames.
+ * - top_row, bottom_row: rows [top_row, bottom_row) contain everything ever stamped
+ */
 typedef struct
 {
-    float x;
-    const ascii_object *texture;
-} background_element;
+    char cells[TERMINAL_DISPLAY_HEIGHT][LAYER_STRIP_WIDTH + LAYER_STRIP_APRON];
+    uint64_t opaque[TERMINAL_DISPLAY_HEIGHT][LAYER_STRIP_WORDS];
+    int scroll_column;
+    float scroll_fraction;
+    float last_scroll_distance;
+    int cleared_column;
+    int top_row;
+    int bottom_row;
+} layer_strip;
 
 typedef struct
 {
-    background_element elements[MAX_ELEMENTS_PER_LAYER];
-    int element_count;
     float speed_multiplier;
     char color_code[10];
+    layer_strip strip;
 } parallax_layer;
 
+/**
+ * Scrolling scenery
+ * - layers: per-layer speed, color and pre-rendered strip
+ * - entities: every element of every layer, tagged with its layer. An element's speed column is
+ *   its layer's speed_multiplier.
+ * - particles: dust, plus rain or snow when enabled, drawn over the layers
+ */
 typedef struct
 {
     parallax_layer layers[NUM_LAYERS];
-    float particle_positions[TERMINAL_DISPLAY_HEIGHT];
+    entity_store entities;
+    particle_system particles;
+    char static_frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]; // Sky, ground, mountain base
 } background_system;
 
 typedef enum {
@@ -66,51 +118,75 @@ typedef enum {
 
 /**************************************************************************************************/
 /**
- * @name
- * @brief
- *
+ * @name    initialize_background
+ * @brief   Places the starting elements of every layer, stamps them into the layer strips,
+ *          scatters PARTICLE_DEFAULT_DUST dust particles and builds the static frame holding the
+ *          rows that never change.
  *
+ * @param   background
+ * @param   seed        Seed for the particles
  *
+ * @return  int     0 on success, -1 if memory could not be allocated
  */
 /**************************************************************************************************/
-void initialize_particles(background_system *background);
+int initialize_background(background_system *background, uint64_t seed);
 
 /**************************************************************************************************/
 /**
- * @name
- * @brief
- *
+ * @name    free_background
+ * @brief   Releases the element and particle storage of a background.
  *
+ * @param   background
  *
+ * @return  void
  */
 /**************************************************************************************************/
-void initialize_background(background_system *background);
+void free_background(background_system *background);
 
 /**************************************************************************************************/
 /**
- * @name    update_background_particles
- * @brief   Updates the positions of background particles to create a scrolling effect.
- *          Each particle's position is decremented by the specified speed.
+ * @name    add_background_element
+ * @brief   Adds an element to a layer and stamps it into the layer's strip. x must lie within
+ *          BACKGROUND_SPAWN_DISTANCE columns past the right edge, give or take a tick of scroll.
  *
+ * @param   background
+ * @param   layer
+ * @param   texture
+ * @param   x           Screen column of the element's left edge
  *
- * @param background
- * @param speed       Speed at which particles move leftward, not technically pixels per frame but
- *                    a float value to allow for smoother movement.
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int add_background_element(background_system *background, layer_type layer, texture_id texture,
+                           float x);
+
+/**************************************************************************************************/
+/**
+ * @name    redraw_background_strips
+ * @brief   Clears the layer strips and stamps every live element again, for when the textures
+ *          they were stamped with have been replaced. Elements go back to the world columns they
+ *          were first stamped at, in the order they were first stamped, and columns that already
+ *          scrolled off stay blank.
+ *
+ * @param   background
  *
  * @return  void
  */
 /**************************************************************************************************/
-void update_background_particles(background_system *background, float speed);
+void redraw_background_strips(background_system *background);
 
 /**************************************************************************************************/
 /**
- * @name
- * @brief
- *
+ * @name    update_background
+ * @brief   Scrolls every layer. All elements move in one pass over the entity store, then the
+ *          ones that scrolled BACKGROUND_WRAP_DISTANCE past the left edge are dropped. Columns
+ *          that scroll off the left edge are blanked for reuse; new elements are only ever added
+ *          at the right edge, so strip content is only generated there. Particles move last.
  *
  * @param background
  * @param speed
  *
+ * @return  void
  */
 /**************************************************************************************************/
 void update_background(background_system *background, float speed);
@@ -0,0 +1,126 @@
+/**************************************************************************************************/
+/**
+ * @file batch.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Runs many headless games with a scripted autoplayer across a work-stealing thread pool,
+ *        for tuning difficulty and scroll speed
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define BATCH_MAX_THREADS               256
+
+#define BATCH_DEFAULT_SEED              1
+#define BATCH_DEFAULT_MAX_TICKS         10000   // About 6.7 minutes of play at 25 ticks per second
+#define BATCH_DEFAULT_AUTOPLAYER_LEAD   4
+#define BATCH_DEFAULT_REACTION_TICKS    1       // Reaction delays are drawn from [0, this] ticks
+#define BATCH_DEFAULT_MISS_PERCENT      2
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * What to simulate
+ * - game_count: number of games
+ * - thread_count: worker threads, at most BATCH_MAX_THREADS
+ * - seed: game i is seeded with seed + i, so every game differs and a batch is reproducible
+ * - scroll_speed: ground columns scrolled per tick
+ * - max_ticks: a game still running after this many ticks counts as survived
+ * - autoplayer_lead: the autoplayer notices an obstacle once its left edge is fewer than this
+ *   many columns ahead of the player's right edge
+ * - autoplayer_reaction_ticks: it jumps a delay drawn from [0, this] ticks after noticing one
+ * - autoplayer_miss_percent: chance that it does not jump at all for an obstacle it noticed.
+ *   Delays and misses come from a generator seeded like the game, seed + i, on its own stream,
+ *   so outcomes vary with the seed and the batch stays reproducible.
+ */
+typedef struct
+{
+    int game_count;
+    int thread_count;
+    uint64_t seed;
+    float scroll_speed;
+    uint32_t max_ticks;
+    int autoplayer_lead;
+    int autoplayer_reaction_ticks;
+    int autoplayer_miss_percent;
+} batch_options;
+
+/**
+ * Outcome of one game
+ * - ticks: ticks survived
+ * - jumps: jumps the autoplayer made
+ * - crashed: whether the game ended on an obstacle rather than at max_ticks
+ */
+typedef struct
+{
+    uint32_t ticks;
+    uint32_t jumps;
+    bool crashed;
+} batch_game_result;
+
+/**
+ * Totals over a batch, filled in after every worker has finished
+ * - total_ticks, crashed_games: sums over all games
+ * - min_ticks, median_ticks, max_ticks: distribution of ticks survived
+ * - steals: ranges of games moved between workers
+ * - elapsed_nanoseconds: wall time from starting the workers to joining them
+ */
+typedef struct
+{
+    uint64_t total_ticks;
+    int crashed_games;
+    uint32_t min_ticks;
+    uint32_t median_ticks;
+    uint32_t max_ticks;
+    uint64_t steals;
+    int64_t elapsed_nanoseconds;
+} batch_statistics;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    run_batch
+ * @brief   Plays options->game_count games to completion and gathers their results.
+ *
+ *          Every worker starts with an equal contiguous range of game indices and takes games
+ *          from its front. A worker whose range runs out steals the back half of another worker's
+ *          range. Each range is one atomic word, so taking and stealing are single compare-and-
+ *          swaps and no lock is ever held. Workers share nothing else: each owns its game
+ *          instance and writes only the results of the games it ran. Textures must be loaded.
+ *
+ * @param   options
+ * @param   results     Receives one result per game, indexed like the games
+ * @param   statistics  Receives the batch totals
+ *
+ * @return  int         0 on success, -1 if threads or memory could not be allocated
+ */
+/**************************************************************************************************/
+int run_batch(const batch_options *options, batch_game_result *results,
+              batch_statistics *statistics);
+
+#endif // BATCH_H
+
+// End of batch.h
@@ -0,0 +1,74 @@
+/**************************************************************************************************/
+/**
+ * @file coverage.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Bitmap of the frame cells already drawn, for compositing front to back
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define COVERAGE_WORD_BITS          64
+#define COVERAGE_WORDS              ((TERMINAL_DISPLAY_WIDTH + COVERAGE_WORD_BITS - 1) / \
+                                     COVERAGE_WORD_BITS)
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Cells of one frame drawn so far. Whatever is drawn first is in front, so a cell is written at
+ * most once and everything behind it is skipped.
+ * - rows: bit c % 64 of word c / 64 is set once column c of the row has been drawn
+ * - cells_written: cells drawn into the frame, counted by every pass as it draws them
+ * - cells_hidden: opaque cells skipped because something in front already covered them
+ */
+typedef struct
+{
+    uint64_t rows[TERMINAL_DISPLAY_HEIGHT][COVERAGE_WORDS];
+    uint32_t cells_written;
+    uint32_t cells_hidden;
+} frame_coverage;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    get_coverage_word_mask
+ * @brief   Returns the bits of a coverage word that stand for columns on screen.
+ *
+ * @param   word
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+static inline uint64_t get_coverage_word_mask(int word)
+{
+    int columns = TERMINAL_DISPLAY_WIDTH - word * COVERAGE_WORD_BITS;
+
+    return columns >= COVERAGE_WORD_BITS ? UINT64_MAX : (UINT64_C(1) << columns) - 1;
+}
+
+#endif // COVERAGE_H
+
+// End of coverage.h
@@ -0,0 +1,151 @@
+/**************************************************************************************************/
+/**
+ * @file entity_store.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Pooled structure-of-arrays storage for everything that scrolls with the world
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// Capacity is kept a multiple of this many floats so the position pass never needs a scalar tail
+#define ENTITY_STORE_VECTOR_WIDTH   4
+
+#define ENTITY_STORE_MIN_CAPACITY   16
+
+// Layer value of a slot that is on the free list
+#define ENTITY_LAYER_FREE           UINT8_MAX
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Entity pool. Entity i is described by element i of every column, and an entity keeps its index
+ * for as long as it lives. Released slots are chained through next_free and reused before the
+ * pool grows, so indices stay dense and the columns stay contiguous.
+ * - x: screen column of the entity's left edge
+ * - speed: fraction of the scroll speed the entity moves at each tick
+ * - texture: texture_id drawn for the entity
+ * - layer: layer the entity belongs to, ENTITY_LAYER_FREE for unused slots
+ * - stamp_column: world column the entity was first drawn at, for owners that pre-render their
+ *   entities; add_entity sets it to 0
+ * - sequence: order the entity was added in, so overlapping entities can be drawn again in the
+ *   order they were first drawn
+ * - next_free: index of the next free slot, only meaningful for free slots
+ * - next_sequence: sequence given to the next entity added
+ * - slot_count: slots [0, slot_count) have been handed out at least once
+ * - live_count: slots currently in use
+ * - capacity: allocated length of every column
+ */
+typedef struct
+{
+    float *x;
+    float *speed;
+    uint16_t *texture;
+    uint8_t *layer;
+    int *stamp_column;
+    uint32_t *sequence;
+    int *next_free;
+    uint32_t next_sequence;
+    int free_head;
+    int slot_count;
+    int live_count;
+    int capacity;
+} entity_store;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_entity_store
+ * @brief   Allocates an empty store. The store grows as entities are added, so initial_capacity
+ *          is only a hint.
+ *
+ * @param   store
+ * @param   initial_capacity
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int initialize_entity_store(entity_store *store, int initial_capacity);
+
+/**************************************************************************************************/
+/**
+ * @name    free_entity_store
+ * @brief   Releases the columns of a store.
+ *
+ * @param   store
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_entity_store(entity_store *store);
+
+/**************************************************************************************************/
+/**
+ * @name    add_entity
+ * @brief   Takes a slot from the free list, or a new one at the end of the columns, doubling them
+ *          when they are full.
+ *
+ * @param   store
+ * @param   x
+ * @param   speed
+ * @param   texture
+ * @param   layer
+ *
+ * @return  int     Index of the new entity, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int add_entity(entity_store *store, float x, float speed, uint16_t texture, uint8_t layer);
+
+/**************************************************************************************************/
+/**
+ * @name    remove_entity
+ * @brief   Returns an entity's slot to the free list.
+ *
+ * @param   store
+ * @param   entity
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void remove_entity(entity_store *store, int entity);
+
+/**************************************************************************************************/
+/**
+ * @name    advance_entities
+ * @brief   Moves every entity left by its speed times the scroll speed, in one pass over the x and
+ *          speed columns. Free slots are moved too; that is cheaper than skipping them and nothing
+ *          reads their position.
+ *
+ * @param   store
+ * @param   scroll_speed
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void advance_entities(entity_store *store, float scroll_speed);
+
+#endif // ENTITY_STORE_H
+
+// End of entity_store.h
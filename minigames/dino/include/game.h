@@ -0,0 +1,116 @@
+/**************************************************************************************************/
+/**
+ * @file game.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief One self-contained game: the player, the scenery, the obstacles and their generators.
+ *        Games share nothing but the read-only texture table, so any number of them can run at
+ *        once on different threads.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef GAME_H
+#define GAME_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "background.h"
+#include "obstacles.h"
+#include "perf_hud.h"
+#include "sprites.h"
+#include "world.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define GAME_DEFAULT_SCROLL_SPEED   1.5f    // Ground columns scrolled per simulation tick
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Game instance
+ * - character, background, obstacles: the simulated world
+ * - world: the chunks of scenery and obstacles still to come
+ * - scroll_speed: ground columns scrolled per tick
+ * - distance: ground columns scrolled so far
+ * - tick: simulation ticks run so far
+ * - jumps: jump keys applied so far
+ * - game_over: set once the player hit an obstacle (or memory ran out)
+ * - hud: where the sprite and background updates are timed, NULL to leave them untimed
+ */
+typedef struct
+{
+    sprite character;
+    background_system background;
+    obstacle_system obstacles;
+    world_stream world;
+    float scroll_speed;
+    float distance;
+    uint32_t tick;
+    uint32_t jumps;
+    bool game_over;
+    perf_hud *hud;
+} dino_game;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_game
+ * @brief   Sets up a new game, generating its world on demand; start_world_generator on the
+ *          game's world moves generation ahead of time to a worker. Either way, two games with
+ *          the same seed and speed, fed the same jumps at the same ticks, stay identical.
+ *
+ * @param   game
+ * @param   seed
+ * @param   scroll_speed
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int initialize_game(dino_game *game, uint64_t seed, float scroll_speed);
+
+/**************************************************************************************************/
+/**
+ * @name    free_game
+ * @brief   Stops the game's world generator, if running, and releases the storage of a game.
+ *
+ * @param   game
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_game(dino_game *game);
+
+/**************************************************************************************************/
+/**
+ * @name    advance_game
+ * @brief   Runs one fixed simulation tick: adds the scenery and obstacles entering during the
+ *          tick, then moves everything. Everything the tick does depends only on the game and on
+ *          whether a jump was applied, which is what makes input logs replayable.
+ *
+ * @param   game
+ * @param   jump    Whether a jump key is applied at this tick
+ *
+ * @return  bool    true when the game is over
+ */
+/**************************************************************************************************/
+bool advance_game(dino_game *game, bool jump);
+
+#endif // GAME_H
+
+// End of game.h
@@ -0,0 +1,112 @@
+/**************************************************************************************************/
+/**
+ * @file histogram.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Fixed-size histogram of durations with power-of-two buckets, cheap enough to record
+ *        into from the game loop
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// Bucket 0 holds values below 1 ns, bucket b > 0 holds [2^(b-1), 2^b) ns
+#define HISTOGRAM_BUCKETS   64
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Duration histogram
+ * - buckets: number of values recorded in each bucket
+ * - count: number of values recorded
+ * - total: sum of the values, for the mean
+ * - minimum, maximum: exact extremes, since buckets only bound them to a factor of two
+ */
+typedef struct
+{
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+    uint64_t count;
+    int64_t total;
+    int64_t minimum;
+    int64_t maximum;
+} histogram;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    reset_histogram
+ * @brief   Empties a histogram.
+ *
+ * @param   values
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void reset_histogram(histogram *values);
+
+/**************************************************************************************************/
+/**
+ * @name    record_histogram
+ * @brief   Adds one duration to a histogram.
+ *
+ * @param   values
+ * @param   nanoseconds     Negative durations are counted as 0
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void record_histogram(histogram *values, int64_t nanoseconds);
+
+/**************************************************************************************************/
+/**
+ * @name    get_histogram_percentile
+ * @brief   Returns an upper bound on the given percentile: the top of the bucket it falls in,
+ *          clamped to the largest value recorded.
+ *
+ * @param   values
+ * @param   percentile      In [0, 100]
+ *
+ * @return  int64_t     Nanoseconds, 0 for an empty histogram
+ */
+/**************************************************************************************************/
+int64_t get_histogram_percentile(const histogram *values, double percentile);
+
+/**************************************************************************************************/
+/**
+ * @name    print_histogram
+ * @brief   Prints a one-line summary of a histogram followed by a bar per non-empty bucket.
+ *
+ * @param   stream
+ * @param   name
+ * @param   values
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void print_histogram(FILE *stream, const char *name, const histogram *values);
+
+#endif // HISTOGRAM_H
+
+// End of histogram.h
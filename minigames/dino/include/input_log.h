@@ -0,0 +1,156 @@
+/**************************************************************************************************/
+/**
+ * @file input_log.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Binary log of the keys that reached the simulation, and the replays read back from it
+ *
+ *        File layout, all integers little-endian:
+ *        - header: the 8 bytes "DINOINP1", then the game's uint64 seed
+ *        - one 5-byte record per event: uint32 simulation tick, then one input_key byte
+ *
+ *        Events are written in tick order, and the last event of a finished session is always
+ *        INPUT_KEY_QUIT at the tick the session ended on.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define INPUT_LOG_MAGIC             "DINOINP1"
+#define INPUT_LOG_MAGIC_LENGTH      8
+#define INPUT_LOG_HEADER_LENGTH     (INPUT_LOG_MAGIC_LENGTH + 8)
+#define INPUT_LOG_RECORD_LENGTH     5
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef enum {
+    INPUT_KEY_JUMP = 1,
+    INPUT_KEY_QUIT = 2,
+    INPUT_KEY_PERF_HUD = 3  // Toggles the overlay; never logged, as the simulation never sees it
+} input_key;
+
+/**
+ * One key applied by the simulation
+ * - tick: simulation tick the key was applied at, counting from 0
+ * - key: what the key did
+ */
+typedef struct
+{
+    uint32_t tick;
+    input_key key;
+} input_event;
+
+/**
+ * Input log being written during a session
+ * - file: the log file, NULL when not recording
+ */
+typedef struct
+{
+    FILE *file;
+} input_log;
+
+/**
+ * Input log read back for a replay
+ * - seed: seed of the recorded session
+ * - events, event_count: every recorded event, in tick order
+ * - next_event: index of the first event not yet replayed
+ */
+typedef struct
+{
+    uint64_t seed;
+    input_event *events;
+    int event_count;
+    int next_event;
+} input_replay;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    open_input_log
+ * @brief   Creates a log file and writes its header.
+ *
+ * @param   log
+ * @param   path
+ * @param   seed    Seed of the session being recorded
+ *
+ * @return  int     0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int open_input_log(input_log *log, const char *path, uint64_t seed);
+
+/**************************************************************************************************/
+/**
+ * @name    write_input_event
+ * @brief   Appends one event. Does nothing when the log is not open, so callers need not check.
+ *
+ * @param   log
+ * @param   tick
+ * @param   key
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void write_input_event(input_log *log, uint32_t tick, input_key key);
+
+/**************************************************************************************************/
+/**
+ * @name    close_input_log
+ * @brief   Flushes and closes the log. Does nothing when the log is not open.
+ *
+ * @param   log
+ *
+ * @return  int     0 on success, -1 if any write to the log failed
+ */
+/**************************************************************************************************/
+int close_input_log(input_log *log);
+
+/**************************************************************************************************/
+/**
+ * @name    load_input_replay
+ * @brief   Reads a whole log into memory. A truncated final record is ignored.
+ *
+ * @param   replay
+ * @param   path
+ *
+ * @return  int     0 on success, -1 if the file cannot be read or is not an input log
+ */
+/**************************************************************************************************/
+int load_input_replay(input_replay *replay, const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    free_input_replay
+ * @brief   Releases the events of a replay.
+ *
+ * @param   replay
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_input_replay(input_replay *replay);
+
+#endif // INPUT_LOG_H
+
+// End of input_log.h
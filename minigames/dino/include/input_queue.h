@@ -0,0 +1,133 @@
+/**************************************************************************************************/
+/**
+ * @file input_queue.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Keyboard reader thread and the lock-free queue of timestamped keys it feeds to the game
+ *        loop
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "input_log.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define INPUT_QUEUE_CAPACITY        256     // Must be a power of two
+#define INPUT_QUEUE_CACHE_LINE      64
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Key press with the time it was read
+ * - key: what the key does
+ * - timestamp: CLOCK_MONOTONIC time the key was read, in nanoseconds
+ */
+typedef struct
+{
+    input_key key;
+    int64_t timestamp;
+} timed_input;
+
+/**
+ * Single-producer single-consumer ring between the reader thread and the game loop. Both ends
+ * are wait-free: each index is written by one side only, and a full ring drops the new key.
+ * - head: next slot the game loop takes, written by the game loop only
+ * - tail: next slot the reader fills, written by the reader only. Each index sits on its own
+ *   cache line so the two threads never contend for one.
+ * - events: the ring
+ * - dropped: keys lost to a full ring
+ * - stop_pipe: closing the writing end makes the reader exit
+ * - descriptor: where keys are read from
+ * - thread, running: the reader thread, and whether it has been started and not yet joined
+ */
+typedef struct
+{
+    _Alignas(INPUT_QUEUE_CACHE_LINE) _Atomic uint32_t head;
+    _Alignas(INPUT_QUEUE_CACHE_LINE) _Atomic uint32_t tail;
+    _Atomic uint64_t dropped;
+    _Alignas(INPUT_QUEUE_CACHE_LINE) timed_input events[INPUT_QUEUE_CAPACITY];
+    int stop_pipe[2];
+    int descriptor;
+    pthread_t thread;
+    bool running;
+} input_queue;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    start_input_thread
+ * @brief   Starts a thread that blocks on descriptor, timestamps every read, turns the bytes into
+ *          keys and queues them. Space and the up arrow jump, q quits; escape sequences for other
+ *          keys are skipped whole. The thread exits at end of file.
+ *
+ * @param   queue
+ * @param   descriptor  Usually STDIN_FILENO, already in raw mode
+ *
+ * @return  int     0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int start_input_thread(input_queue *queue, int descriptor);
+
+/**************************************************************************************************/
+/**
+ * @name    stop_input_thread
+ * @brief   Stops and joins the reader thread. Keys still queued are discarded.
+ *
+ * @param   queue
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void stop_input_thread(input_queue *queue);
+
+/**************************************************************************************************/
+/**
+ * @name    take_input_before
+ * @brief   Takes the oldest queued key if it was read before a given time. Keys read later stay
+ *          queued, so each simulation tick only applies the keys pressed before it ended.
+ *
+ * @param   queue
+ * @param   before      CLOCK_MONOTONIC time in nanoseconds
+ * @param   event       Receives the key
+ *
+ * @return  bool    true if a key was taken
+ */
+/**************************************************************************************************/
+bool take_input_before(input_queue *queue, int64_t before, timed_input *event);
+
+/**************************************************************************************************/
+/**
+ * @name    get_monotonic_nanoseconds
+ * @brief   Returns CLOCK_MONOTONIC in nanoseconds, the clock every input timestamp uses.
+ *
+ * @return  int64_t
+ */
+/**************************************************************************************************/
+int64_t get_monotonic_nanoseconds(void);
+
+#endif // INPUT_QUEUE_H
+
+// End of input_queue.h
@@ -0,0 +1,156 @@
+/**************************************************************************************************/
+/**
+ * @file obstacles.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Cacti and birds the player has to jump over, and collision tests against them
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef OBSTACLES_H
+#define OBSTACLES_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include "entity_store.h"
+#include "sprites.h"
+#include "terminal.h"
+#include "texture_cache.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define OBSTACLE_SPEED_MULTIPLIER       1.0f    // Obstacles stand on the ground, which scrolls 1:1
+#define OBSTACLE_BIRD_ROW               (TERMINAL_DISPLAY_HEIGHT - 4)   // Head height when standing
+
+// Ticks between two obstacles: at least enough to land from a jump, and up to RANGE more
+#define OBSTACLE_MIN_SPAWN_TICKS        20
+#define OBSTACLE_SPAWN_TICK_RANGE       30
+
+// Broadphase grid over screen columns. Obstacles are binned by their left edge only, so a query
+// also scans the cells up to ASCII_MASK_MAX_WIDTH columns to its left, which covers any obstacle
+// whose masks reach into the queried columns.
+#define OBSTACLE_GRID_CELL_WIDTH        8
+#define OBSTACLE_GRID_ORIGIN            (-ASCII_MASK_MAX_WIDTH)
+#define OBSTACLE_GRID_CELLS             ((TERMINAL_DISPLAY_WIDTH - OBSTACLE_GRID_ORIGIN + \
+                                          OBSTACLE_GRID_CELL_WIDTH - 1) / OBSTACLE_GRID_CELL_WIDTH)
+
+#define OBSTACLE_LAYER                  0       // Layer column value of a live obstacle
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Live obstacles and their broadphase grid
+ * - entities: one entity per obstacle; its texture decides what it is and which row it sits on
+ * - last_scroll_speed: speed passed to the last update_obstacles, for interpolation
+ * - cell_start: obstacles binned in grid cell c are cell_entities[cell_start[c]] up to
+ *   cell_entities[cell_start[c + 1]]. Rebuilt every tick.
+ * - cell_entities, cell_entities_capacity: entity indices sorted by grid cell
+ */
+typedef struct
+{
+    entity_store entities;
+    float last_scroll_speed;
+    int cell_start[OBSTACLE_GRID_CELLS + 1];
+    int *cell_entities;
+    int cell_entities_capacity;
+} obstacle_system;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_obstacles
+ * @brief   Starts with no obstacles on screen.
+ *
+ * @param   obstacles
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int initialize_obstacles(obstacle_system *obstacles);
+
+/**************************************************************************************************/
+/**
+ * @name    free_obstacles
+ * @brief   Releases the obstacle storage.
+ *
+ * @param   obstacles
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_obstacles(obstacle_system *obstacles);
+
+/**************************************************************************************************/
+/**
+ * @name    get_obstacle_row
+ * @brief   Returns the screen row of an obstacle's top edge: cacti stand on the ground, birds fly
+ *          at OBSTACLE_BIRD_ROW.
+ *
+ * @param   texture
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+int get_obstacle_row(texture_id texture);
+
+/**************************************************************************************************/
+/**
+ * @name    add_obstacle
+ * @brief   Adds an obstacle. It joins the broadphase grid at the next update_obstacles.
+ *
+ * @param   obstacles
+ * @param   texture
+ * @param   x           Screen column of the obstacle's left edge
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int add_obstacle(obstacle_system *obstacles, texture_id texture, float x);
+
+/**************************************************************************************************/
+/**
+ * @name    update_obstacles
+ * @brief   Advances obstacles by one simulation tick: moves them, drops the ones that left the
+ *          screen and rebuilds the broadphase grid.
+ *
+ * @param   obstacles
+ * @param   speed       Scroll speed of the ground, in columns per tick
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int update_obstacles(obstacle_system *obstacles, float speed);
+
+/**************************************************************************************************/
+/**
+ * @name    check_collision
+ * @brief   Tests the player against the obstacles near it. The grid narrows the candidates to the
+ *          obstacles binned close to the player's columns, then each candidate is tested with one
+ *          shift and AND of the two textures' masks per row they share.
+ *
+ * @param   obstacles
+ * @param   character
+ *
+ * @return  bool    true if a visible character of the player overlaps one of an obstacle
+ */
+/**************************************************************************************************/
+bool check_collision(const obstacle_system *obstacles, const sprite *character);
+
+#endif // OBSTACLES_H
+
+// End of obstacles.h
@@ -0,0 +1,150 @@
+/**************************************************************************************************/
+/**
+ * @file particles.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Dust, rain and snow drifting over the scenery, stored as structure-of-arrays columns and
+ *        updated a vector of particles at a time
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "coverage.h"
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// Every kind's range of the columns starts and ends on a multiple of this many particles, so the
+// update never needs a scalar tail. 4 floats fill one SSE or NEON register; wider vectors are
+// split and scalarized badly by compilers when the target has no AVX.
+#define PARTICLE_VECTOR_WIDTH       4
+
+// Particles live above the ground row
+#define PARTICLE_FIELD_HEIGHT       (TERMINAL_DISPLAY_HEIGHT - 1)
+
+#define PARTICLE_DEFAULT_DUST       11      // Matches the dust of the original one-per-row field
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef enum
+{
+    PARTICLE_DUST,      // Hangs in the air and scrolls with the ground
+    PARTICLE_RAIN,      // Falls fast, slanted by the wind
+    PARTICLE_SNOW,      // Falls slowly and drifts
+    PARTICLE_KIND_COUNT
+} particle_kind;
+
+/**
+ * Particle columns. Particle i is described by element i of every column. Kinds occupy
+ * consecutive ranges: kind k is particles [first[k], first[k] + count[k]), and the range is padded
+ * with idle particles up to the next multiple of PARTICLE_VECTOR_WIDTH, which are updated but
+ * never drawn.
+ * - x, y: position in screen columns and rows
+ * - velocity_x, velocity_y: movement per tick on top of the scroll
+ * - depth: fraction of the scroll speed the particle is carried left by
+ * - random_state: per-particle xorshift32 state for respawning, so a vector of particles draws
+ *   a vector of random numbers at once
+ * - first, count: each kind's range
+ * - capacity: allocated length of every column
+ * - last_scroll_speed: speed passed to the last update_particles, for interpolation
+ */
+typedef struct
+{
+    float *x;
+    float *y;
+    float *velocity_x;
+    float *velocity_y;
+    float *depth;
+    uint32_t *random_state;
+    int first[PARTICLE_KIND_COUNT];
+    int count[PARTICLE_KIND_COUNT];
+    int capacity;
+    float last_scroll_speed;
+} particle_system;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_particles
+ * @brief   Scatters the given number of particles of each kind over the field. The same seed and
+ *          counts always give the same particles.
+ *
+ * @param   particles
+ * @param   seed
+ * @param   counts      Particles of each kind, indexed by particle_kind
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+int initialize_particles(particle_system *particles, uint64_t seed,
+                         const int counts[PARTICLE_KIND_COUNT]);
+
+/**************************************************************************************************/
+/**
+ * @name    free_particles
+ * @brief   Releases the particle columns.
+ *
+ * @param   particles
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_particles(particle_system *particles);
+
+/**************************************************************************************************/
+/**
+ * @name    update_particles
+ * @brief   Moves every particle by one simulation tick in one vectorized pass. A particle that
+ *          leaves the field through the left, right or bottom edge comes back in at the opposite
+ *          edge with its other coordinate drawn at random; the wrap is a compare and blend, so
+ *          the pass has no branches.
+ *
+ * @param   particles
+ * @param   scroll_speed    Scroll speed of the ground, in columns per tick
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void update_particles(particle_system *particles, float scroll_speed);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_particles
+ * @brief   Scatters every particle's glyph into the cells of a frame not covered yet, placed
+ *          between its previous and current position. Positions are computed a vector at a time;
+ *          only the coverage tests and stores are scalar.
+ *
+ * @param   terminal_display
+ * @param   coverage        Cells already drawn; the ones drawn here are added
+ * @param   particles
+ * @param   interpolation   Fraction of a tick since the last update, in [0, 1)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void draw_particles(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                    frame_coverage *coverage, const particle_system *particles,
+                    float interpolation);
+
+#endif // PARTICLES_H
+
+// End of particles.h
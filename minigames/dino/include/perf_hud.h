@@ -0,0 +1,159 @@
+/**************************************************************************************************/
+/**
+ * @file perf_hud.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Frame time breakdown of the live game, recorded into fixed-size histograms and shown
+ *        as an overlay toggled with P
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "histogram.h"
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define PERF_HUD_WIDTH          56      // Overlay columns, blanked behind the text
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef enum
+{
+    PERF_STAGE_FRAME,       // Presented frame to presented frame
+    PERF_STAGE_BACKGROUND,  // update_background, once per tick
+    PERF_STAGE_SPRITE,      // update_sprite_position, once per tick
+    PERF_STAGE_COMPOSE,     // compose_frame
+    PERF_STAGE_OUTPUT,      // Encoding the frame delta and writing it to the terminal
+    PERF_STAGE_COUNT
+} perf_stage;
+
+/**
+ * Timings of the live game. Recording costs a clock read and a histogram update per stage and
+ * never allocates; the overlay is only drawn while visible.
+ * - visible: whether the overlay is drawn over the frame
+ * - stages: every duration recorded for each stage
+ * - latest: the last duration of each stage, in nanoseconds
+ * - last_frame_time: CLOCK_MONOTONIC time the last frame was presented, 0 before the first
+ * - latest_bytes, total_bytes: bytes written to the terminal by the last frame and by all of them
+ * - dropped_frames: frame slots skipped because the loop fell behind
+ */
+typedef struct
+{
+    bool visible;
+    histogram stages[PERF_STAGE_COUNT];
+    int64_t latest[PERF_STAGE_COUNT];
+    int64_t last_frame_time;
+    size_t latest_bytes;
+    uint64_t total_bytes;
+    uint64_t dropped_frames;
+} perf_hud;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_perf_hud
+ * @brief   Empties every histogram and hides the overlay.
+ *
+ * @param   hud
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void initialize_perf_hud(perf_hud *hud);
+
+/**************************************************************************************************/
+/**
+ * @name    start_perf_stage
+ * @brief   Returns the CLOCK_MONOTONIC time a stage starts at, or 0 without a HUD, so untimed
+ *          callers pay no clock read.
+ *
+ * @param   hud     May be NULL
+ *
+ * @return  int64_t     Nanoseconds
+ */
+/**************************************************************************************************/
+int64_t start_perf_stage(const perf_hud *hud);
+
+/**************************************************************************************************/
+/**
+ * @name    end_perf_stage
+ * @brief   Records the time since start_time as one duration of a stage.
+ *
+ * @param   hud         May be NULL, in which case nothing is recorded
+ * @param   stage
+ * @param   start_time  From start_perf_stage or a previous end_perf_stage
+ *
+ * @return  int64_t     The end time, which can start the next stage
+ */
+/**************************************************************************************************/
+int64_t end_perf_stage(perf_hud *hud, perf_stage stage, int64_t start_time);
+
+/**************************************************************************************************/
+/**
+ * @name    record_perf_frame
+ * @brief   Records a presented frame: its distance from the previous one and the bytes it wrote.
+ *
+ * @param   hud
+ * @param   presented_time  CLOCK_MONOTONIC time the frame finished presenting
+ * @param   bytes           Bytes written to the terminal for it
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void record_perf_frame(perf_hud *hud, int64_t presented_time, size_t bytes);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_perf_hud
+ * @brief   Writes the overlay over the top left of a composed frame: the current, p50 and p99
+ *          time of each stage, bytes per frame and dropped frames. Percentiles are the tops of
+ *          their power-of-two buckets.
+ *
+ * @param   hud
+ * @param   terminal_display
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void draw_perf_hud(const perf_hud *hud,
+                   char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
+
+/**************************************************************************************************/
+/**
+ * @name    print_perf_hud
+ * @brief   Prints every stage's full histogram, then the output and dropped frame totals.
+ *
+ * @param   stream
+ * @param   hud
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void print_perf_hud(FILE *stream, const perf_hud *hud);
+
+#endif // PERF_HUD_H
+
+// End of perf_hud.h
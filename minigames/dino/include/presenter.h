@@ -0,0 +1,134 @@
+/**************************************************************************************************/
+/**
+ * @file presenter.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Cell-diff frame presenter. Keeps the last frame shown on the terminal and sends only
+ *        the cells that changed since then.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef PRESENTER_H
+#define PRESENTER_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define PRESENTER_MAX_FOOTER_LENGTH     128
+
+// Largest leftward scroll, in cells, that is tried when diffing a row
+#define PRESENTER_MAX_ROW_SHIFT         4
+
+// Every row costs at most one cursor move, one shift and a rewrite of the row, so a full frame
+// plus the screen clear, footer and synchronized update bracket always fits
+#define PRESENTER_OUTPUT_CAPACITY       (TERMINAL_DISPLAY_HEIGHT * (TERMINAL_DISPLAY_WIDTH + 32) + \
+                                         PRESENTER_MAX_FOOTER_LENGTH + 128)
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Terminal frame presenter
+ * - presented_frame: cells currently shown on the terminal
+ * - needs_full_redraw: set until the first frame (or after invalidate_presenter) is presented
+ * - footer: text drawn two rows below the frame on every full redraw
+ * - output, output_length: escape sequences produced by the last encode_frame_delta call
+ */
+typedef struct
+{
+    char presented_frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
+    bool needs_full_redraw;
+    char footer[PRESENTER_MAX_FOOTER_LENGTH];
+    char output[PRESENTER_OUTPUT_CAPACITY];
+    size_t output_length;
+} frame_presenter;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_presenter
+ * @brief   Prepares a presenter whose first frame clears the screen and draws every cell.
+ *
+ * @param   presenter
+ * @param   footer      Text shown below the frame (truncated to PRESENTER_MAX_FOOTER_LENGTH - 1)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void initialize_presenter(frame_presenter *presenter, const char *footer);
+
+/**************************************************************************************************/
+/**
+ * @name    invalidate_presenter
+ * @brief   Forgets what is on the terminal so the next frame is drawn in full, e.g. after the
+ *          screen was cleared or resized behind the presenter's back.
+ *
+ * @param   presenter
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void invalidate_presenter(frame_presenter *presenter);
+
+/**************************************************************************************************/
+/**
+ * @name    encode_frame_delta
+ * @brief   Encodes the escape sequences that turn the presented frame into the given frame and
+ *          records the given frame as presented. The output is left in presenter->output.
+ *
+ *          Each changed row is encoded as the cheapest of:
+ *          - a plain diff, where runs of unchanged cells are skipped with a cursor move or simply
+ *            rewritten when that is shorter, so it is never longer than rewriting the row
+ *          - a leftward shift of the whole row with delete-character, followed by a diff against
+ *            the shifted row, which catches scrolling parallax layers
+ *
+ *          Only leftward shifts are tried: the world only scrolls left, and deleting characters
+ *          never pushes cells past the right edge of the frame the way inserting them would.
+ *          A non-empty update is wrapped in a synchronized update bracket so the terminal shows
+ *          it all at once.
+ *
+ * @param   presenter
+ * @param   frame       The frame to present
+ *
+ * @return  size_t      Number of bytes in presenter->output, 0 when nothing changed
+ */
+/**************************************************************************************************/
+size_t encode_frame_delta(frame_presenter *presenter,
+                          const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
+
+/**************************************************************************************************/
+/**
+ * @name    present_frame
+ * @brief   Encodes the frame with encode_frame_delta and sends the output to stdout with a single
+ *          write(2), retrying only on partial writes and interrupts.
+ *
+ * @param   presenter
+ * @param   frame       The frame to present
+ *
+ * @return  int         0 on success, -1 if writing to stdout failed
+ */
+/**************************************************************************************************/
+int present_frame(frame_presenter *presenter,
+                  const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
+
+#endif // PRESENTER_H
+
+// End of presenter.h
@@ -0,0 +1,97 @@
+/**************************************************************************************************/
+/**
+ * @file prng.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Small seeded PCG32 generator. Each subsystem carries its own, so a seed reproduces a
+ *        game exactly and subsystems never disturb each other's sequences.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef PRNG_H
+#define PRNG_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// Stream identifiers, so generators seeded with the same seed still produce unrelated sequences
+#define PRNG_STREAM_BACKGROUND      1
+#define PRNG_STREAM_OBSTACLES       2
+#define PRNG_STREAM_PARTICLES       3
+#define PRNG_STREAM_AUTOPLAYER      4
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * PCG32 generator state (O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically
+ * Good Algorithms for Random Number Generation")
+ * - state: 64-bit LCG state
+ * - increment: LCG increment, always odd, selects the stream
+ */
+typedef struct
+{
+    uint64_t state;
+    uint64_t increment;
+} prng;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    seed_prng
+ * @brief   Seeds a generator. The same seed and stream always give the same sequence.
+ *
+ * @param   generator
+ * @param   seed
+ * @param   stream      One of the PRNG_STREAM_ identifiers
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void seed_prng(prng *generator, uint64_t seed, uint64_t stream);
+
+/**************************************************************************************************/
+/**
+ * @name    next_prng
+ * @brief   Returns the next 32 random bits.
+ *
+ * @param   generator
+ *
+ * @return  uint32_t
+ */
+/**************************************************************************************************/
+uint32_t next_prng(prng *generator);
+
+/**************************************************************************************************/
+/**
+ * @name    prng_below
+ * @brief   Returns a random integer in [0, bound) using a multiply and shift instead of a modulo.
+ *          The bias is below bound / 2^32, far too small to matter for a game.
+ *
+ * @param   generator
+ * @param   bound       Must be greater than 0
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+int prng_below(prng *generator, int bound);
+
+#endif // PRNG_H
+
+// End of prng.h
@@ -24,18 +24,39 @@
 #include "ascii.h"
 #include "sprites.h"
 #include "background.h"
+#include "coverage.h"
+#include "obstacles.h"
+#include "perf_hud.h"
+#include "presenter.h"
+#include "spectator.h"
+#include "asciicast.h"
 
 /*------------------------------------------------------------------------------------------------*/
 // GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
 
+#define RENDER_CONTROLS_TEXT    "Press SPACE to jump | Press Q to quit"
 
 
 /*------------------------------------------------------------------------------------------------*/
 // CLASS DECLARATIONS                                                                             */
 /*------------------------------------------------------------------------------------------------*/
 
-
+/**
+ * Overdraw counters summed over composed frames
+ * - frames: frames composed
+ * - cells_written: cells written, as counted by each drawing pass. One per cell of every frame
+ *   when nothing is drawn twice; more shows overdraw, fewer shows cells left unwritten
+ * - cells_hidden: opaque cells of sprites, obstacles, particles and layers that were skipped
+ *   because something in front covered them. A back-to-front painter writes all of these too,
+ *   on top of filling the whole frame first.
+ */
+typedef struct
+{
+    uint64_t frames;
+    uint64_t cells_written;
+    uint64_t cells_hidden;
+} compose_stats;
 
 /*------------------------------------------------------------------------------------------------*/
 // FUNCTION DECLARATIONS                                                                          */
@@ -44,46 +65,127 @@
 /**************************************************************************************************/
 /**
  * @name    draw_object
- * @brief   General-purpose function to draw any ASCII sprite to the terminal display buffer.
- *          Loops through the sprite's dimensions and copies each character to the display.
+ * @brief   General-purpose function to draw any compiled texture to the terminal display buffer.
+ *          The texture's rectangle is clipped against the screen once, then each opaque span is
+ *          copied with memcpy, trimmed to the clipped columns and to the cells not covered yet.
  *
  * @param   terminal_display  The 2D character array representing the terminal screen
- * @param   sprite           Pointer to the ascii_object structure containing the sprite data
- * @param   x                X-coordinate (column) where the sprite's top-left corner will be drawn
- * @param   y                Y-coordinate (row) where the sprite's top-left corner will be drawn
+ * @param   coverage         Cells already drawn; the ones drawn here are added
+ * @param   texture          Compiled texture to draw
+ * @param   x                X-coordinate (column) where the texture's top-left corner will be drawn
+ * @param   y                Y-coordinate (row) where the texture's top-left corner will be drawn
  *
  * @return  void
  */
 /**************************************************************************************************/
 void draw_object(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
-                      const ascii_object *sprite, int x, int y);
+                 frame_coverage *coverage, const compiled_ascii_object *texture, int x, int y);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_layer_strip
+ * @brief   Copies the visible window of a layer strip onto the display, starting at the strip's
+ *          scroll column and wrapping around the ring. Blank strip cells are transparent. The
+ *          strip's opacity bitmap is tested against the coverage 64 cells at a time, and only the
+ *          runs of opaque, uncovered cells are copied, so a row hidden behind nearer layers costs
+ *          a few word operations. The cost depends only on the rows the layer covers, not on how
+ *          many elements it holds.
+ *
+ * @param   terminal_display  The 2D character array representing the terminal screen
+ * @param   coverage         Cells already drawn; the ones drawn here are added
+ * @param   strip            Layer strip to draw
+ * @param   interpolation    Fraction of the next simulation tick that has elapsed, in [0, 1)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void draw_layer_strip(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                      frame_coverage *coverage, const layer_strip *strip, float interpolation);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_obstacles
+ * @brief   Draws every live obstacle at its interpolated position, later obstacles in front.
+ *
+ * @param   terminal_display  The 2D character array representing the terminal screen
+ * @param   coverage         Cells already drawn; the ones drawn here are added
+ * @param   obstacles        Obstacles to draw
+ * @param   interpolation    Fraction of the next simulation tick that has elapsed, in [0, 1)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void draw_obstacles(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                    frame_coverage *coverage, const obstacle_system *obstacles,
+                    float interpolation);
 
 /**************************************************************************************************/
 /**
  * @name    draw_sprite
- * @brief   Draws the player sprite character to the terminal display buffer.
+ * @brief   Draws the player sprite character to the terminal display buffer, using the
+ *          TEXTURE_PLAYER texture.
  *
  * @param   terminal_display  The 2D character array representing the terminal screen
+ * @param   coverage         Cells already drawn; the ones drawn here are added
  * @param   character        Pointer to the sprite structure containing position data
+ * @param   interpolation    Fraction of the next simulation tick that has elapsed, in [0, 1)
  *
  * @return  void
  */
 /**************************************************************************************************/
 void draw_sprite(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
-                 sprite *character);
+                 frame_coverage *coverage, sprite *character, float interpolation);
+
+/**************************************************************************************************/
+/**
+ * @name    compose_frame
+ * @brief   Draws all game elements into a frame buffer without sending it anywhere. Elements are
+ *          drawn front to back, from the player to the farthest layer, each marking the cells it
+ *          wrote in a coverage bitmap so nothing behind overwrites them; the static rows fill
+ *          whatever is left. Every cell is written exactly once.
+ *
+ * @param   terminal_display  Receives the composed frame
+ * @param   character        Pointer to the player sprite
+ * @param   background       Pointer to the background system containing parallax layers
+ * @param   obstacles        Obstacles drawn in front of the background
+ * @param   interpolation    Fraction of the next simulation tick that has elapsed, in [0, 1)
+ * @param   stats            Receives the frame's overdraw counters (may be NULL)
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void compose_frame(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                   sprite *character, background_system *background,
+                   const obstacle_system *obstacles, float interpolation, compose_stats *stats);
 
 /**************************************************************************************************/
 /**
  * @name    render
- * @brief   Main render function that draws all game elements and outputs to the terminal.
+ * @brief   Main render function that composes a frame with compose_frame and outputs it to the
+ *          terminal. Only the cells that changed since the previous frame are sent, see
+ *          present_frame.
+ *
+ *          Positions are interpolated between the last two simulation ticks, so frames rendered
+ *          between ticks still move smoothly.
+ *
+ *          With a HUD, composing and output are timed, and the overlay is drawn over the frame
+ *          while visible. With a spectator server, the frame is also handed to its viewers.
  *
  * @param   character    Pointer to the player sprite
  * @param   background   Pointer to the background system containing parallax layers
+ * @param   obstacles    Obstacles drawn in front of the background
+ * @param   interpolation Fraction of the next simulation tick that has elapsed, in [0, 1)
+ * @param   presenter    Presenter holding the frame currently shown on the terminal
+ * @param   recorder     Optional asciicast recorder that receives every composed frame (may be NULL)
+ * @param   hud          Optional timings and overlay (may be NULL)
+ * @param   spectators   Optional server streaming the game to viewers (may be NULL)
  *
  * @return  void
  */
 /**************************************************************************************************/
-void render(sprite *character, background_system *background);
+void render(sprite *character, background_system *background, const obstacle_system *obstacles,
+            float interpolation, frame_presenter *presenter, asciicast_recorder *recorder,
+            perf_hud *hud, spectator_server *spectators);
 
 #endif // RENDER_H
 
@@ -0,0 +1,152 @@
+/**************************************************************************************************/
+/**
+ * @file spectator.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Streams the live game to viewers on a Unix domain socket. The game thread only hands
+ *        composed frames over; a server thread delta-encodes each one once and fans it out to
+ *        every viewer from an epoll loop.
+ *
+ *        The stream is plain terminal output: a viewer (dino-view) copies it to its terminal.
+ *        Each viewer starts with a keyframe, a full redraw of the current frame, and gets
+ *        another one instead of its backlog whenever it falls SPECTATOR_CLIENT_QUEUE frames
+ *        behind, so a slow viewer costs a bounded amount of memory and never slows the game.
+ *        Linux only; elsewhere start_spectator_server fails with ENOSYS.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "presenter.h"
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define SPECTATOR_RING_FRAMES       4       // Frames handed over and not encoded yet. Power of two.
+#define SPECTATOR_CLIENT_QUEUE      16      // Encoded frames a viewer may fall behind by
+#define SPECTATOR_CACHE_LINE        64
+#define SPECTATOR_PATH_LENGTH       108     // sun_path of struct sockaddr_un
+
+#define SPECTATOR_FOOTER            "Watching a live game | Press Ctrl-C to stop"
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef struct spectator_client spectator_client;
+
+/**
+ * Single-producer single-consumer ring of composed frames, from the game thread to the server
+ * thread. A full ring drops the new frame: viewers are sent deltas from whatever frame they
+ * last got, so a skipped frame only means a larger next delta.
+ * - head: next frame the server takes, written by the server only
+ * - tail: next slot the game fills, written by the game only
+ * - frames: the ring
+ */
+typedef struct
+{
+    _Alignas(SPECTATOR_CACHE_LINE) _Atomic uint32_t head;
+    _Alignas(SPECTATOR_CACHE_LINE) _Atomic uint32_t tail;
+    _Alignas(SPECTATOR_CACHE_LINE)
+    char frames[SPECTATOR_RING_FRAMES][TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
+} spectator_ring;
+
+/**
+ * Spectator server. Apart from the ring and the stop flag, everything below belongs to the
+ * server thread while it runs and to the caller of stop_spectator_server after.
+ * - ring: frames from the game
+ * - stopping: set to make the server thread exit
+ * - listener, epoll, wake: listening socket, epoll instance, and eventfd the game signals new
+ *   frames (and stopping) on
+ * - path: where the socket is bound, unlinked when the server stops
+ * - thread: the server thread
+ * - delta: the frame every viewer in sync has, and the encoder of the next delta from it
+ * - keyframe: encoder of full redraws for viewers that are joining or resyncing
+ * - clients: viewers connected, in a doubly linked list
+ * - closed_clients: viewers disconnected during the current batch of events, freed after it
+ * - dropped_frames: frames the game dropped on a full ring, written by the game thread only
+ * - viewers: viewers that ever connected
+ * - resyncs: keyframes sent to viewers that fell behind
+ */
+typedef struct
+{
+    spectator_ring ring;
+    atomic_bool stopping;
+    int listener;
+    int epoll;
+    int wake;
+    char path[SPECTATOR_PATH_LENGTH];
+    pthread_t thread;
+    frame_presenter delta;
+    frame_presenter keyframe;
+    spectator_client *clients;
+    spectator_client *closed_clients;
+    uint64_t dropped_frames;
+    uint64_t viewers;
+    uint64_t resyncs;
+} spectator_server;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    start_spectator_server
+ * @brief   Binds a socket at path, readable and writable by every local user, and starts the
+ *          server thread. A stale socket left at path by an earlier run is replaced.
+ *
+ * @param   server
+ * @param   path
+ *
+ * @return  int     0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int start_spectator_server(spectator_server *server, const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    publish_spectator_frame
+ * @brief   Hands a composed frame to the server thread: one copy and one eventfd write, however
+ *          many viewers are connected. Never blocks.
+ *
+ * @param   server
+ * @param   frame
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void publish_spectator_frame(spectator_server *server,
+                             const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
+
+/**************************************************************************************************/
+/**
+ * @name    stop_spectator_server
+ * @brief   Stops the server thread, disconnects every viewer and removes the socket.
+ *
+ * @param   server
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void stop_spectator_server(spectator_server *server);
+
+#endif // SPECTATOR_H
+
+// End of spectator.h
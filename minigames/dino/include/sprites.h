@@ -45,8 +45,9 @@
 
 typedef struct
 {
-    int x, y;
-    int velocity_y;
+    int x;
+    float y, previous_y;    // Subpixel height now and one simulation tick ago, for interpolation
+    float velocity_y;
     bool is_jumping;
 } sprite;
 
@@ -73,12 +74,12 @@ void initialize_sprite(sprite *character);
 
 /**************************************************************************************************/
 /**
- * @name
- * @brief
- *
+ * @name    update_sprite_position
+ * @brief   Advances the sprite's jump physics by one fixed simulation tick.
  *
  * @param character
  *
+ * @return  void
  */
 /**************************************************************************************************/
 void update_sprite_position(sprite *character);
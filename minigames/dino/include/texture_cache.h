@@ -0,0 +1,172 @@
+/**************************************************************************************************/
+/**
+ * @file texture_cache.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Texture identifiers and the table of compiled textures used for drawing. Textures come
+ *        from an atlas file when one is given, hot reloaded when the file changes,
+ *        and from the built-in textures compiled at build time (textures.h) otherwise.
+ *
+ *        Atlas layout, all integers little-endian:
+ *        - header: the 8 bytes "DINOATL1", uint32 entry count, uint32 reserved (0)
+ *        - one 16-byte entry per texture: uint32 texture_id, uint16 width, uint16 height,
+ *          uint32 offset of the first row from the start of the file, uint8 flags
+ *          (TEXTURE_ATLAS_OPAQUE_SPACES), 3 reserved bytes
+ *        - row data: each row is width characters followed by '\n', so the art stays readable
+ *
+ *        Textures missing from the atlas keep their built-in art. Loading is not zero-copy: the
+ *        whole file is read into memory the texture set owns, and every row is checked and
+ *        compiled from there. Drawing never reads the file, so saving over the atlas in place is
+ *        safe; a load that catches a save half-way sees a short or broken file and rejects it,
+ *        and the next change to the file reloads it.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include "ascii.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define TEXTURE_ATLAS_MAGIC             "DINOATL1"
+#define TEXTURE_ATLAS_MAGIC_LENGTH      8
+#define TEXTURE_ATLAS_HEADER_LENGTH     16
+#define TEXTURE_ATLAS_ENTRY_LENGTH      16
+#define TEXTURE_ATLAS_OPAQUE_SPACES     0x01
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef enum {
+    TEXTURE_CLOUD_LARGE = 0,
+    TEXTURE_CLOUD_SMALL,
+    TEXTURE_MOUNTAIN_SMALL,
+    TEXTURE_MOUNTAIN_LARGE,
+    TEXTURE_MOUNTAIN_TWIN_PEAKS,
+    TEXTURE_TREE,
+    TEXTURE_HOUSE,
+    TEXTURE_BUSH,
+    TEXTURE_PLAYER,
+    TEXTURE_CACTUS_SMALL,
+    TEXTURE_CACTUS_LARGE,
+    TEXTURE_BIRD,
+    TEXTURE_COUNT
+} texture_id;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    load_textures
+ * @brief   Makes the built-in textures current. They are compiled at build time, so this only
+ *          points the table at them. Must be called before anything is drawn.
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void load_textures(void);
+
+/**************************************************************************************************/
+/**
+ * @name    unload_textures
+ * @brief   Releases the compiled textures.
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void unload_textures(void);
+
+/**************************************************************************************************/
+/**
+ * @name    get_texture
+ * @brief   Returns the compiled texture for an identifier.
+ *
+ * @param   texture
+ *
+ * @return  const compiled_ascii_object*
+ */
+/**************************************************************************************************/
+const compiled_ascii_object *get_texture(texture_id texture);
+
+/**************************************************************************************************/
+/**
+ * @name    load_texture_atlas
+ * @brief   Reads an atlas file and makes its textures current straight away. On failure the
+ *          current textures are kept.
+ *
+ * @param   path
+ *
+ * @return  int     0 on success, -1 if the file cannot be read or is not a valid atlas
+ */
+/**************************************************************************************************/
+int load_texture_atlas(const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    start_texture_watcher
+ * @brief   Starts a thread that reloads the atlas whenever the file is written or replaced. The
+ *          thread reads and compiles the new atlas on its own and only hands it over; it becomes
+ *          current at the next refresh_textures call. Linux only (inotify).
+ *
+ * @param   path
+ *
+ * @return  int     0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int start_texture_watcher(const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    stop_texture_watcher
+ * @brief   Stops the watcher thread, if running.
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void stop_texture_watcher(void);
+
+/**************************************************************************************************/
+/**
+ * @name    refresh_textures
+ * @brief   Makes the latest reloaded atlas current, if the watcher has one waiting, and releases
+ *          the one it replaces. Must be called from the thread that draws, at a point where no
+ *          texture pointer from get_texture is still held. It is one atomic exchange when nothing
+ *          changed.
+ *
+ * @return  bool    true if the textures changed
+ */
+/**************************************************************************************************/
+bool refresh_textures(void);
+
+/**************************************************************************************************/
+/**
+ * @name    export_texture_atlas
+ * @brief   Writes the built-in textures as an atlas file, to start editing from. The file is
+ *          written next to path and renamed over it, so a running watcher never sees it half done.
+ *
+ * @param   path
+ *
+ * @return  int     0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int export_texture_atlas(const char *path);
+
+#endif // TEXTURE_CACHE_H
+
+// End of texture_cache.h
@@ -0,0 +1,194 @@
+/**************************************************************************************************/
+/**
+ * @file world.h
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Procedural generator for the scenery and obstacles ahead of the camera, producing fixed
+ *        width chunks either on demand or ahead of time on a worker thread
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+#ifndef WORLD_H
+#define WORLD_H
+
+/*------------------------------------------------------------------------------------------------*/
+// HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "background.h"
+#include "prng.h"
+
+/*------------------------------------------------------------------------------------------------*/
+// GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+#define WORLD_CHUNK_DISTANCE        64      // Ground columns covered by one chunk
+#define WORLD_CHUNK_MAX_EVENTS      64      // Later events of a crowded chunk are dropped
+
+// Chunks the worker keeps ready, about seven screens at the default speed. A power of two.
+#define WORLD_LOOKAHEAD_CHUNKS      8
+
+#define WORLD_CACHE_LINE            64
+
+// Spawn sources: one per background layer, then the obstacles
+#define WORLD_SOURCE_OBSTACLES      NUM_LAYERS
+#define WORLD_SOURCE_COUNT          (NUM_LAYERS + 1)
+
+/*------------------------------------------------------------------------------------------------*/
+// CLASS DECLARATIONS                                                                             */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Something entering the screen
+ * - distance: ground distance scrolled when it enters
+ * - x: screen column of its left edge at that moment
+ * - texture: what it is
+ * - source: background layer it belongs to, or WORLD_SOURCE_OBSTACLES
+ */
+typedef struct
+{
+    float distance;
+    float x;
+    uint16_t texture;
+    uint8_t source;
+} world_event;
+
+/**
+ * Everything entering the screen while the ground scrolls through one chunk
+ * - index: chunk k covers ground distances [k, k + 1) * WORLD_CHUNK_DISTANCE
+ * - event_count, events: its events, in order of distance
+ */
+typedef struct
+{
+    uint32_t index;
+    int event_count;
+    world_event events[WORLD_CHUNK_MAX_EVENTS];
+} world_chunk;
+
+/**
+ * Generator state. Chunks come out in order and depend only on the seed and scroll speed, never
+ * on which thread generates them or when.
+ * - scenery_random, obstacle_random: separate generators, so richer scenery never changes the
+ *   obstacle course
+ * - scroll_speed: obstacle gaps are drawn in ticks, so they are converted to distance with it
+ * - next_chunk: index of the next chunk to generate
+ * - next_spawn: ground distance of each source's next event
+ */
+typedef struct
+{
+    prng scenery_random;
+    prng obstacle_random;
+    float scroll_speed;
+    uint32_t next_chunk;
+    float next_spawn[WORLD_SOURCE_COUNT];
+} world_generator;
+
+/**
+ * Single-producer single-consumer ring of generated chunks, filled by the worker thread. Slots
+ * stay owned by the game thread from the moment it takes them until it releases them.
+ * - head: next chunk the game thread takes, written by the game thread only
+ * - tail: next chunk the worker fills, written by the worker only
+ * - chunks: the ring
+ */
+typedef struct
+{
+    _Alignas(WORLD_CACHE_LINE) _Atomic uint32_t head;
+    _Alignas(WORLD_CACHE_LINE) _Atomic uint32_t tail;
+    _Alignas(WORLD_CACHE_LINE) world_chunk chunks[WORLD_LOOKAHEAD_CHUNKS];
+} world_ring;
+
+/**
+ * Source of chunks for one game
+ * - generator: owned by the worker while it runs, by the game thread otherwise
+ * - chunk: the chunk being consumed when there is no worker
+ * - current: the chunk being consumed, in the ring or chunk, NULL before the first one
+ * - next_event: first event of current not spawned yet
+ * - ring: chunks from the worker, NULL when generating on demand
+ * - wake_pipe: the game thread writes a byte each time it frees a slot; closing the writing end
+ *   stops the worker
+ * - thread: the worker
+ */
+typedef struct
+{
+    world_generator generator;
+    world_chunk chunk;
+    const world_chunk *current;
+    int next_event;
+    world_ring *ring;
+    int wake_pipe[2];
+    pthread_t thread;
+} world_stream;
+
+/*------------------------------------------------------------------------------------------------*/
+// FUNCTION DECLARATIONS                                                                          */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    initialize_world
+ * @brief   Starts a world at distance 0, generating chunks on demand on the calling thread.
+ *
+ * @param   world
+ * @param   seed
+ * @param   scroll_speed    Ground columns scrolled per tick
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void initialize_world(world_stream *world, uint64_t seed, float scroll_speed);
+
+/**************************************************************************************************/
+/**
+ * @name    start_world_generator
+ * @brief   Moves generation to a worker thread that keeps WORLD_LOOKAHEAD_CHUNKS chunks ready.
+ *          The chunks are the same as on demand; only the thread that builds them changes. Call
+ *          before the first take_world_event.
+ *
+ * @param   world
+ *
+ * @return  int     0 on success, -1 with errno set on failure, in which case generation stays on
+ *                  demand
+ */
+/**************************************************************************************************/
+int start_world_generator(world_stream *world);
+
+/**************************************************************************************************/
+/**
+ * @name    free_world
+ * @brief   Stops the worker, if running, and releases the ring.
+ *
+ * @param   world
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+void free_world(world_stream *world);
+
+/**************************************************************************************************/
+/**
+ * @name    take_world_event
+ * @brief   Takes the next event if the ground has scrolled far enough for it to enter. Moving to
+ *          the next chunk takes it from the worker, or generates it when there is none. If the
+ *          worker has fallen behind, this waits for it rather than letting the world diverge.
+ *
+ * @param   world
+ * @param   distance    Ground distance scrolled so far
+ * @param   event       Receives the event
+ *
+ * @return  bool    true if an event was taken
+ */
+/**************************************************************************************************/
+bool take_world_event(world_stream *world, float distance, world_event *event);
+
+#endif // WORLD_H
+
+// End of world.h
@@ -0,0 +1,202 @@
+/**************************************************************************************************/
+/**
+ * @file ascii.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Compiles ASCII textures into per-row lists of opaque spans and collision masks
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ascii.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    get_row_length
+ * @brief   Returns how many characters of a texture row may be drawn: the declared width, or less
+ *          if the row's string is shorter.
+ *
+ * @param   object
+ * @param   row
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+static int get_row_length(const ascii_object *object, int row);
+
+/**************************************************************************************************/
+/**
+ * @name    collect_row_spans
+ * @brief   Finds the opaque spans of one texture row. Spans are only stored when spans is not
+ *          NULL, so the same function counts them before allocation and fills them after.
+ *
+ * @param   object
+ * @param   row
+ * @param   spans   Destination for the row's spans, or NULL to only count them
+ *
+ * @return  int     Number of spans in the row
+ */
+/**************************************************************************************************/
+static int collect_row_spans(const ascii_object *object, int row, ascii_span *spans);
+
+/**************************************************************************************************/
+/**
+ * @name    build_row_mask
+ * @brief   Returns the collision mask of one texture row: bit c is set when column c holds a
+ *          character other than a space.
+ *
+ * @param   object
+ * @param   row
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+static uint64_t build_row_mask(const ascii_object *object, int row);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static int get_row_length(const ascii_object *object, int row)
+{
+    return (int)strnlen(object->lines[row], (size_t)object->width);
+}
+
+static int collect_row_spans(const ascii_object *object, int row, ascii_span *spans)
+{
+    const char *line = object->lines[row];
+    int row_length = get_row_length(object, row);
+    int span_count = 0;
+    int column = 0;
+
+    while (column < row_length)
+    {
+        if (line[column] == ' ' && !object->opaque_spaces)
+        {
+            column++;
+            continue;
+        }
+
+        int span_start = column;
+        while (column < row_length && (line[column] != ' ' || object->opaque_spaces))
+        {
+            column++;
+        }
+
+        if (spans != NULL)
+        {
+            spans[span_count].offset = span_start;
+            spans[span_count].length = column - span_start;
+            spans[span_count].characters = line + span_start;
+        }
+        span_count++;
+    }
+
+    return span_count;
+}
+
+static uint64_t build_row_mask(const ascii_object *object, int row)
+{
+    const char *line = object->lines[row];
+    int row_length = get_row_length(object, row);
+    uint64_t mask = 0;
+
+    for (int column = 0; column < row_length; column++)
+    {
+        if (line[column] != ' ')
+        {
+            mask |= (uint64_t)1 << column;
+        }
+    }
+
+    return mask;
+}
+
+int compile_ascii_object(const ascii_object *object, compiled_ascii_object *compiled)
+{
+    int total_spans = 0;
+
+    for (int row = 0; row < object->height; row++)
+    {
+        total_spans += collect_row_spans(object, row, NULL);
+    }
+
+    int *row_first_span = malloc(sizeof(int) * (object->height + 1));
+    ascii_span *spans = malloc(sizeof(ascii_span) * (total_spans > 0 ? total_spans : 1));
+    uint64_t *row_masks = NULL;
+
+    if (object->width <= ASCII_MASK_MAX_WIDTH)
+    {
+        row_masks = malloc(sizeof(uint64_t) * (object->height > 0 ? object->height : 1));
+    }
+
+    if (row_first_span == NULL || spans == NULL ||
+        (object->width <= ASCII_MASK_MAX_WIDTH && row_masks == NULL))
+    {
+        free(row_first_span);
+        free(spans);
+        free(row_masks);
+        return -1;
+    }
+
+    int span_index = 0;
+    for (int row = 0; row < object->height; row++)
+    {
+        row_first_span[row] = span_index;
+        span_index += collect_row_spans(object, row, spans + span_index);
+
+        if (row_masks != NULL)
+        {
+            row_masks[row] = build_row_mask(object, row);
+        }
+    }
+    row_first_span[object->height] = span_index;
+
+    compiled->width = object->width;
+    compiled->height = object->height;
+    compiled->row_first_span = row_first_span;
+    compiled->spans = spans;
+    compiled->row_masks = row_masks;
+
+    return 0;
+}
+
+void free_compiled_ascii_object(compiled_ascii_object *compiled)
+{
+    // Only ever called on tables compile_ascii_object allocated
+    free((void *)compiled->row_first_span);
+    free((void *)compiled->spans);
+    free((void *)compiled->row_masks);
+    compiled->row_first_span = NULL;
+    compiled->spans = NULL;
+    compiled->row_masks = NULL;
+}
+
+// End of ascii.c
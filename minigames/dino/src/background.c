@@ -19,9 +19,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "background.h"
-#include "textures.h"
 
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
@@ -33,147 +33,411 @@
 /* GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
 
-
+// Elements on screen when the game starts, in the order they are added to the entity store
+static const struct
+{
+    layer_type layer;
+    float x;
+    texture_id texture;
+} initial_elements[] = {
+    { LAYER_CLOUDS,     20, TEXTURE_CLOUD_SMALL },
+    { LAYER_CLOUDS,     50, TEXTURE_CLOUD_LARGE },
+    { LAYER_CLOUDS,     65, TEXTURE_CLOUD_SMALL },
+    { LAYER_MOUNTAINS,  15, TEXTURE_MOUNTAIN_TWIN_PEAKS },
+    { LAYER_MOUNTAINS,  45, TEXTURE_MOUNTAIN_TWIN_PEAKS },
+    { LAYER_HOUSES,     30, TEXTURE_BUSH },
+    { LAYER_TREES,      35, TEXTURE_TREE },
+    { LAYER_TREES,      60, TEXTURE_TREE }
+};
 
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION PROTOTYPES                                                                            */
 /*------------------------------------------------------------------------------------------------*/
 
+/**************************************************************************************************/
+/**
+ * @name    get_element_row
+ * @brief   Returns the screen row of an element's top edge. Clouds are staggered by their index,
+ *          everything else stands on its layer's baseline.
+ *
+ * @param   layer
+ * @param   texture
+ * @param   entity      Index of the element in the entity store
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+static int get_element_row(layer_type layer, const compiled_ascii_object *texture, int entity);
 
+/**************************************************************************************************/
+/**
+ * @name    write_strip_cells
+ * @brief   Writes a run of cells into a strip row starting at a ring column, splitting it where
+ *          the ring wraps and keeping the mirrored apron and the opacity bitmap in sync.
+ *
+ * @param   strip
+ * @param   row
+ * @param   column      Ring column of the first cell, in [0, LAYER_STRIP_WIDTH)
+ * @param   cells
+ * @param   length      Number of cells, at most LAYER_STRIP_WIDTH
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void write_strip_cells(layer_strip *strip, int row, int column, const char *cells,
+                              int length);
+
+/**************************************************************************************************/
+/**
+ * @name    clear_layer_strip
+ * @brief   Blanks every cell of a strip.
+ *
+ * @param   strip
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void clear_layer_strip(layer_strip *strip);
+
+/**************************************************************************************************/
+/**
+ * @name    stamp_element
+ * @brief   Draws one element into its layer's strip at the world column it was first stamped
+ *          at. Columns the strip has already cleared are skipped: they map to ring columns that
+ *          now hold content ahead of the screen. Spans crossing the end of the ring are split in
+ *          two.
+ *
+ * @param   background
+ * @param   entity      Index of the element in the entity store
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void stamp_element(background_system *background, int entity);
+
+/**************************************************************************************************/
+/**
+ * @name    scroll_layer_strip
+ * @brief   Advances a strip's scroll position and blanks the columns that scrolled off the left
+ *          edge, so the ring can reuse them for content stamped at the right.
+ *
+ * @param   strip
+ * @param   distance    Columns to scroll, may be fractional
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void scroll_layer_strip(layer_strip *strip, float distance);
+
+/**************************************************************************************************/
+/**
+ * @name    build_static_frame
+ * @brief   Builds the frame every render starts from: empty sky, the ground row and the mountain
+ *          base row.
+ *
+ * @param   background
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void build_static_frame(background_system *background);
 
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION DEFINITIONS                                                                           */
 /*------------------------------------------------------------------------------------------------*/
 
-void initialize_particles(background_system *background)
+static int get_element_row(layer_type layer, const compiled_ascii_object *texture, int entity)
 {
-    for (int i = 0; i < TERMINAL_DISPLAY_HEIGHT; i++)
+    if (layer == LAYER_CLOUDS)
     {
-        background->particle_positions[i] = (float)(rand() % TERMINAL_DISPLAY_WIDTH);
+        return 5 + (entity % 3) * 3;
+    }
+    else if (layer == LAYER_MOUNTAINS)
+    {
+        return TERMINAL_DISPLAY_HEIGHT - texture->height - 10;
+    }
+    else if (layer == LAYER_HOUSES)
+    {
+        return TERMINAL_DISPLAY_HEIGHT - texture->height - 3;
+    }
+    else // Most close layer (trees)
+    {
+        return TERMINAL_DISPLAY_HEIGHT - texture->height - 1;
     }
 }
 
-void initialize_background(background_system *background)
+static void write_strip_cells(layer_strip *strip, int row, int column, const char *cells,
+                              int length)
+{
+    char *strip_row = strip->cells[row];
+    uint64_t *opaque = strip->opaque[row];
+
+    // Elements are stamped rarely, so the bitmap is kept a cell at a time
+    for (int i = 0; i < length; i++)
+    {
+        int ring_column = (column + i) & LAYER_STRIP_MASK;
+        uint64_t bit = UINT64_C(1) << (ring_column % 64);
+
+        if (cells[i] != ' ')
+        {
+            opaque[ring_column / 64] |= bit;
+        }
+        else
+        {
+            opaque[ring_column / 64] &= ~bit;
+        }
+    }
+
+    while (length > 0)
+    {
+        int piece_length = LAYER_STRIP_WIDTH - column < length ? LAYER_STRIP_WIDTH - column
+                                                               : length;
+
+        memcpy(strip_row + column, cells, piece_length);
+
+        if (column < LAYER_STRIP_APRON)
+        {
+            int mirrored_length = LAYER_STRIP_APRON - column < piece_length
+                                      ? LAYER_STRIP_APRON - column
+                                      : piece_length;
+            memcpy(strip_row + LAYER_STRIP_WIDTH + column, cells, mirrored_length);
+        }
+
+        cells += piece_length;
+        length -= piece_length;
+        column = 0;
+    }
+}
+
+static void stamp_element(background_system *background, int entity)
+{
+    const entity_store *entities = &background->entities;
+    layer_type layer = (layer_type)entities->layer[entity];
+    layer_strip *strip = &background->layers[layer].strip;
+    const compiled_ascii_object *texture = get_texture((texture_id)entities->texture[entity]);
+    int world_column = entities->stamp_column[entity];
+    int top_row = get_element_row(layer, texture, entity);
+
+    for (int row = 0; row < texture->height; row++)
+    {
+        int strip_row = top_row + row;
+        if (strip_row < 0 || strip_row >= TERMINAL_DISPLAY_HEIGHT)
+        {
+            continue;
+        }
+
+        const ascii_span *span = texture->spans + texture->row_first_span[row];
+        const ascii_span *row_end = texture->spans + texture->row_first_span[row + 1];
+
+        for (; span < row_end; span++)
+        {
+            int first_column = world_column + span->offset;
+            int skipped = strip->cleared_column - first_column;
+
+            if (skipped >= span->length)
+            {
+                continue;
+            }
+            if (skipped < 0)
+            {
+                skipped = 0;
+            }
+
+            write_strip_cells(strip, strip_row, (first_column + skipped) & LAYER_STRIP_MASK,
+                              span->characters + skipped, span->length - skipped);
+        }
+
+        if (strip_row < strip->top_row)
+        {
+            strip->top_row = strip_row;
+        }
+        if (strip_row + 1 > strip->bottom_row)
+        {
+            strip->bottom_row = strip_row + 1;
+        }
+    }
+}
+
+static void scroll_layer_strip(layer_strip *strip, float distance)
+{
+    strip->scroll_fraction += distance;
+
+    int whole_columns = (int)floorf(strip->scroll_fraction);
+    strip->scroll_column += whole_columns;
+    strip->scroll_fraction -= whole_columns;
+    strip->last_scroll_distance = distance;
+
+    for (; strip->cleared_column < strip->scroll_column - LAYER_STRIP_TRAILING_COLUMNS;
+         strip->cleared_column++)
+    {
+        int column = strip->cleared_column & LAYER_STRIP_MASK;
+
+        for (int row = strip->top_row; row < strip->bottom_row; row++)
+        {
+            write_strip_cells(strip, row, column, " ", 1);
+        }
+    }
+}
+
+static void clear_layer_strip(layer_strip *strip)
+{
+    memset(strip->cells, ' ', sizeof(strip->cells));
+    memset(strip->opaque, 0, sizeof(strip->opaque));
+    strip->top_row = TERMINAL_DISPLAY_HEIGHT;
+    strip->bottom_row = 0;
+}
+
+static void build_static_frame(background_system *background)
+{
+    memset(background->static_frame, ' ', sizeof(background->static_frame));
+
+    // Ground
+    memset(background->static_frame[TERMINAL_DISPLAY_HEIGHT - 1], '=', TERMINAL_DISPLAY_WIDTH);
+
+    // Background mountain base
+    memset(background->static_frame[TERMINAL_DISPLAY_HEIGHT - 11], '.', TERMINAL_DISPLAY_WIDTH);
+}
+
+int initialize_background(background_system *background, uint64_t seed)
 {
     // Layer 0: Clouds (farthest)
-    background->layers[0].speed_multiplier = 0.1f;
-    strcpy(background->layers[0].color_code, "\033[90m"); // Dark gray
-    background->layers[0].element_count = 3;
-    background->layers[0].elements[0].x = 20;
-    background->layers[0].elements[0].texture = &cloud_small;
-    background->layers[0].elements[1].x = 50;
-    background->layers[0].elements[1].texture = &cloud_large;
-    background->layers[0].elements[2].x = 65;
-    background->layers[0].elements[2].texture = &cloud_small;
+    background->layers[LAYER_CLOUDS].speed_multiplier = 0.1f;
+    strcpy(background->layers[LAYER_CLOUDS].color_code, "\033[90m");     // Dark gray
+
     // Layer 1: Mountains (medium-far)
-    background->layers[1].speed_multiplier = 0.3f;
-    strcpy(background->layers[1].color_code, "\033[37m");  // White
-    background->layers[1].element_count = 2;
-    background->layers[1].elements[0].x = 15;
-    background->layers[1].elements[0].texture = &mountain_twin_peaks;  // From sprites.h
-    background->layers[1].elements[1].x = 45;
-    background->layers[1].elements[1].texture = &mountain_twin_peaks;
+    background->layers[LAYER_MOUNTAINS].speed_multiplier = 0.3f;
+    strcpy(background->layers[LAYER_MOUNTAINS].color_code, "\033[37m");  // White
 
     // Layer 2: Houses/forests (medium-close)
-    background->layers[2].speed_multiplier = 0.5f;
-    strcpy(background->layers[2].color_code, "\033[97m");  // Bright white
-    background->layers[2].element_count = 1;
-    background->layers[2].elements[0].x = 30;
-    background->layers[2].elements[0].texture = &bush;  // From sprites.h
-    // background->layers[2].elements[1].x = 55;
-    // background->layers[2].elements[1].texture = &house;
+    background->layers[LAYER_HOUSES].speed_multiplier = 0.5f;
+    strcpy(background->layers[LAYER_HOUSES].color_code, "\033[97m");     // Bright white
 
     // Layer 3: Trees/cacti (closest, full speed)
-    background->layers[3].speed_multiplier = 0.9f;
-    strcpy(background->layers[3].color_code, "\033[0m");   // Default
-    background->layers[3].element_count = 2;
-    background->layers[3].elements[0].x = 35;
-    background->layers[3].elements[0].texture = &tree;
-    background->layers[3].elements[1].x = 60;
-    background->layers[3].elements[1].texture = &tree;
-
-    initialize_particles(background);
+    background->layers[LAYER_TREES].speed_multiplier = 0.9f;
+    strcpy(background->layers[LAYER_TREES].color_code, "\033[0m");       // Default
+
+    for (int layer = 0; layer < NUM_LAYERS; layer++)
+    {
+        layer_strip *strip = &background->layers[layer].strip;
+
+        clear_layer_strip(strip);
+        strip->scroll_column = 0;
+        strip->scroll_fraction = 0.0f;
+        strip->last_scroll_distance = 0.0f;
+        strip->cleared_column = 0;
+    }
+
+    int element_count = (int)(sizeof(initial_elements) / sizeof(initial_elements[0]));
+
+    if (initialize_entity_store(&background->entities, element_count) != 0)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < element_count; i++)
+    {
+        if (add_background_element(background, initial_elements[i].layer,
+                                   initial_elements[i].texture, initial_elements[i].x) != 0)
+        {
+            free_entity_store(&background->entities);
+            return -1;
+        }
+    }
+
+    const int particle_counts[PARTICLE_KIND_COUNT] = { [PARTICLE_DUST] = PARTICLE_DEFAULT_DUST };
+
+    if (initialize_particles(&background->particles, seed, particle_counts) != 0)
+    {
+        free_entity_store(&background->entities);
+        return -1;
+    }
+
+    build_static_frame(background);
+
+    return 0;
+}
+
+void free_background(background_system *background)
+{
+    free_entity_store(&background->entities);
+    free_particles(&background->particles);
+}
+
+int add_background_element(background_system *background, layer_type layer, texture_id texture,
+                           float x)
+{
+    int entity = add_entity(&background->entities, x, background->layers[layer].speed_multiplier,
+                            (uint16_t)texture, (uint8_t)layer);
+    if (entity < 0)
+    {
+        return -1;
+    }
+
+    // Fixed once, so a redraw puts the element back exactly where it was first drawn
+    layer_strip *strip = &background->layers[layer].strip;
+    background->entities.stamp_column[entity] = strip->scroll_column +
+                                                (int)floorf(x + strip->scroll_fraction);
+
+    stamp_element(background, entity);
+    return 0;
 }
 
-void update_background_particles(background_system *background, float speed)
+void redraw_background_strips(background_system *background)
 {
-    for (int i = 0; i < TERMINAL_DISPLAY_HEIGHT; i++)
+    for (int layer = 0; layer < NUM_LAYERS; layer++)
+    {
+        clear_layer_strip(&background->layers[layer].strip);
+    }
+
+    // Overlapping elements must land in the order they were first stamped, which reused slots
+    // no longer follow. Picking the next sequence each pass is quadratic, but redraws only follow
+    // a texture reload and the layers hold a few dozen elements.
+    const entity_store *entities = &background->entities;
+    uint32_t next_sequence = 0;
+
+    for (int stamped = 0; stamped < entities->live_count; stamped++)
     {
-        background->particle_positions[i] -= speed;
+        int next = -1;
 
-        // When particle goes off screen, wrap around
-        if (background->particle_positions[i] < 0)
+        for (int entity = 0; entity < entities->slot_count; entity++)
         {
-            background->particle_positions[i] = TERMINAL_DISPLAY_WIDTH + (rand() % 10);
+            if (entities->layer[entity] != ENTITY_LAYER_FREE &&
+                entities->sequence[entity] >= next_sequence &&
+                (next < 0 || entities->sequence[entity] < entities->sequence[next]))
+            {
+                next = entity;
+            }
         }
+
+        stamp_element(background, next);
+        next_sequence = entities->sequence[next] + 1;
     }
 }
 
 void update_background(background_system *background, float speed)
 {
-    for (int layer = 0; layer < NUM_LAYERS; layer++) {
-          float layer_speed = speed * background->layers[layer].speed_multiplier;
+    entity_store *entities = &background->entities;
+
+    for (int layer = 0; layer < NUM_LAYERS; layer++)
+    {
+        scroll_layer_strip(&background->layers[layer].strip,
+                           speed * background->layers[layer].speed_multiplier);
+    }
+
+    advance_entities(entities, speed);
 
-          for (int i = 0; i < background->layers[layer].element_count; i++)
+    // Leaving is rare, so this pass is a compare per element; the layer is looked up only for
+    // the elements that actually left. Their columns are blanked as the strip scrolls on.
+    for (int entity = 0; entity < entities->slot_count; entity++)
+    {
+        if (entities->x[entity] < -BACKGROUND_WRAP_DISTANCE &&
+            entities->layer[entity] != ENTITY_LAYER_FREE)
         {
-              background->layers[layer].elements[i].x -= layer_speed;
-
-              if (background->layers[layer].elements[i].x < -64) // Wrap elements back around
-              {
-                  background->layers[layer].elements[i].x = TERMINAL_DISPLAY_WIDTH + (rand() % 80);
-
-                  if (layer == LAYER_CLOUDS)
-                  {
-                      if (rand() % 2 == 0)
-                      {
-                        background->layers[layer].elements[i].texture = &cloud_large;
-                      }
-                      else
-                      {
-                        background->layers[layer].elements[i].texture = &cloud_small;
-                      }
-
-                  }
-                  else if (layer == LAYER_MOUNTAINS)
-                  {
-                      // Randomly pick mountain type
-                      int mountain_choice = rand() % 3;
-                      if (mountain_choice == 0)
-                      {
-                          background->layers[layer].elements[i].texture = &mountain_small;
-                      }
-                      else if (mountain_choice == 1)
-                      {
-                          background->layers[layer].elements[i].texture = &mountain_large;
-                      }
-                      else
-                      {
-                          background->layers[layer].elements[i].texture = &mountain_twin_peaks;
-                      }
-
-                  }
-                  else if (layer == LAYER_HOUSES)
-                  {
-                      // Randomly pick house or bush
-                      if (rand() % 2 == 0)
-                      {
-                          background->layers[layer].elements[i].texture = &bush;
-                      }
-                      else
-                      {
-                        //   background->layers[layer].elements[i].texture = &house;
-                      }
-
-                  }
-                  else // if (layer == LAYER_TREES)
-                  {
-                      background->layers[layer].elements[i].texture = &tree;
-                  }
-              }
-          }
-      }
-
-    update_background_particles(background, speed);
+            remove_entity(entities, entity);
+        }
+    }
+
+    update_particles(&background->particles, speed);
 }
 
 // End of background.c
\ No newline at end of file
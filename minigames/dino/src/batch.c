@@ -0,0 +1,454 @@
+/**************************************************************************************************/
+/**
+ * @file batch.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Runs many headless games with a scripted autoplayer across a work-stealing thread pool,
+ *        for tuning difficulty and scroll speed
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "batch.h"
+#include "game.h"
+#include "prng.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define CACHE_LINE_BYTES    64
+
+// A game range is packed into one word: first game in the low half, one past the last in the high
+#define PACK_RANGE(begin, end)  (((uint64_t)(uint32_t)(end) << 32) | (uint32_t)(begin))
+#define RANGE_BEGIN(range)      ((uint32_t)(range))
+#define RANGE_END(range)        ((uint32_t)((range) >> 32))
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+typedef struct batch_pool batch_pool;
+
+/**
+ * One worker thread. Each sits on its own cache line so taking games from one range never
+ * invalidates another worker's.
+ * - range: games not yet started, popped from the front by the owner, stolen from the back
+ * - index: position in the pool's worker array, also where stealing starts looking
+ * - steals: ranges this worker stole
+ */
+typedef struct
+{
+    _Alignas(CACHE_LINE_BYTES) _Atomic uint64_t range;
+    int index;
+    uint64_t steals;
+    batch_pool *pool;
+    pthread_t thread;
+} batch_worker;
+
+/**
+ * Scripted player of one game, reacting like a person: late, and now and then not at all
+ * - generator: draws reaction delays and misses, on its own stream so the game is unaffected
+ * - last_distance: distance to the nearest obstacle within the lead on the previous tick, -1 if
+ *   there was none; an obstacle farther than that one is a new one to react to
+ * - jump_tick: tick the pending jump is due at, UINT32_MAX when none is pending
+ */
+typedef struct
+{
+    prng generator;
+    int last_distance;
+    uint32_t jump_tick;
+} autoplayer;
+
+struct batch_pool
+{
+    const batch_options *options;
+    batch_game_result *results;
+    batch_worker *workers;
+    int worker_count;
+    _Atomic bool failed;
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    take_game
+ * @brief   Pops the first game of a worker's own range.
+ *
+ * @param   worker
+ *
+ * @return  int     Game index, or -1 if the range is empty
+ */
+/**************************************************************************************************/
+static int take_game(batch_worker *worker);
+
+/**************************************************************************************************/
+/**
+ * @name    steal_games
+ * @brief   Moves the back half (rounded up) of the first non-empty range found among the other
+ *          workers into the thief's own, empty range.
+ *
+ * @param   thief
+ *
+ * @return  bool    false when every other range was empty, so no work is left to start
+ */
+/**************************************************************************************************/
+static bool steal_games(batch_worker *thief);
+
+/**************************************************************************************************/
+/**
+ * @name    get_obstacle_distance
+ * @brief   Finds the nearest obstacle whose left edge is fewer than lead columns ahead of the
+ *          player's right edge.
+ *
+ * @param   game
+ * @param   lead
+ *
+ * @return  int     Columns to that obstacle, or -1 if there is none
+ */
+/**************************************************************************************************/
+static int get_obstacle_distance(const dino_game *game, int lead);
+
+/**************************************************************************************************/
+/**
+ * @name    autoplayer_wants_jump
+ * @brief   Scripted player: notices each obstacle as it comes within the lead, then either misses
+ *          it or jumps after a random reaction delay.
+ *
+ * @param   player
+ * @param   game
+ * @param   options
+ *
+ * @return  bool
+ */
+/**************************************************************************************************/
+static bool autoplayer_wants_jump(autoplayer *player, const dino_game *game,
+                                  const batch_options *options);
+
+/**************************************************************************************************/
+/**
+ * @name    play_game
+ * @brief   Plays one game to a crash or to the tick limit, reusing the worker's game instance.
+ *
+ * @param   game
+ * @param   options
+ * @param   game_index
+ * @param   result
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+static int play_game(dino_game *game, const batch_options *options, int game_index,
+                     batch_game_result *result);
+
+/**************************************************************************************************/
+/**
+ * @name    worker_main
+ * @brief   Thread entry point: plays games from its own range, then steals until none are left.
+ *
+ * @param   argument    The worker
+ *
+ * @return  void*
+ */
+/**************************************************************************************************/
+static void *worker_main(void *argument);
+
+/**************************************************************************************************/
+/**
+ * @name    compare_ticks
+ * @brief   qsort comparator for tick counts.
+ *
+ * @param   first
+ * @param   second
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+static int compare_ticks(const void *first, const void *second);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static int take_game(batch_worker *worker)
+{
+    uint64_t range = atomic_load_explicit(&worker->range, memory_order_relaxed);
+
+    while (RANGE_BEGIN(range) < RANGE_END(range))
+    {
+        // A failed exchange reloads range, so a concurrent steal is simply retried against
+        uint64_t taken = PACK_RANGE(RANGE_BEGIN(range) + 1, RANGE_END(range));
+        if (atomic_compare_exchange_weak_explicit(&worker->range, &range, taken,
+                                                  memory_order_acq_rel, memory_order_relaxed))
+        {
+            return (int)RANGE_BEGIN(range);
+        }
+    }
+
+    return -1;
+}
+
+static bool steal_games(batch_worker *thief)
+{
+    batch_pool *pool = thief->pool;
+
+    for (int offset = 1; offset < pool->worker_count; offset++)
+    {
+        batch_worker *victim = &pool->workers[(thief->index + offset) % pool->worker_count];
+        uint64_t range = atomic_load_explicit(&victim->range, memory_order_relaxed);
+
+        while (RANGE_BEGIN(range) < RANGE_END(range))
+        {
+            uint32_t count = RANGE_END(range) - RANGE_BEGIN(range);
+            uint32_t split = RANGE_END(range) - (count + 1) / 2;
+
+            // Games are only ever removed from ranges, so a range can never come back to a value
+            // a stale thief saw, and the exchange cannot succeed on outdated bounds
+            if (atomic_compare_exchange_weak_explicit(&victim->range, &range,
+                                                      PACK_RANGE(RANGE_BEGIN(range), split),
+                                                      memory_order_acq_rel, memory_order_relaxed))
+            {
+                atomic_store_explicit(&thief->range, PACK_RANGE(split, RANGE_END(range)),
+                                      memory_order_release);
+                thief->steals++;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static int get_obstacle_distance(const dino_game *game, int lead)
+{
+    const entity_store *entities = &game->obstacles.entities;
+    int player_right = game->character.x + get_texture(TEXTURE_PLAYER)->width;
+    int nearest = -1;
+
+    for (int entity = 0; entity < entities->slot_count; entity++)
+    {
+        if (entities->layer[entity] != OBSTACLE_LAYER)
+        {
+            continue;
+        }
+
+        int distance = (int)floorf(entities->x[entity]) - player_right;
+        if (distance >= 0 && distance < lead && (nearest < 0 || distance < nearest))
+        {
+            nearest = distance;
+        }
+    }
+
+    return nearest;
+}
+
+static bool autoplayer_wants_jump(autoplayer *player, const dino_game *game,
+                                  const batch_options *options)
+{
+    int distance = get_obstacle_distance(game, options->autoplayer_lead);
+
+    // Obstacles only come closer, so one that is farther than last tick's has just come in range
+    if (distance >= 0 && (player->last_distance < 0 || distance > player->last_distance) &&
+        prng_below(&player->generator, 100) >= options->autoplayer_miss_percent)
+    {
+        player->jump_tick = game->tick +
+                            (uint32_t)prng_below(&player->generator,
+                                                 options->autoplayer_reaction_ticks + 1);
+    }
+    player->last_distance = distance;
+
+    if (game->tick != player->jump_tick)
+    {
+        return false;
+    }
+
+    player->jump_tick = UINT32_MAX;
+    return true;
+}
+
+static int play_game(dino_game *game, const batch_options *options, int game_index,
+                     batch_game_result *result)
+{
+    uint64_t seed = options->seed + (uint64_t)game_index;
+    autoplayer player = { .last_distance = -1, .jump_tick = UINT32_MAX };
+
+    if (initialize_game(game, seed, options->scroll_speed) != 0)
+    {
+        return -1;
+    }
+    seed_prng(&player.generator, seed, PRNG_STREAM_AUTOPLAYER);
+
+    while (!game->game_over && game->tick < options->max_ticks)
+    {
+        advance_game(game, autoplayer_wants_jump(&player, game, options));
+    }
+
+    result->ticks = game->tick;
+    result->jumps = game->jumps;
+    result->crashed = game->game_over;
+
+    free_game(game);
+    return 0;
+}
+
+static void *worker_main(void *argument)
+{
+    batch_worker *worker = argument;
+    batch_pool *pool = worker->pool;
+    dino_game *game = malloc(sizeof(dino_game));
+
+    if (game == NULL)
+    {
+        atomic_store(&pool->failed, true);
+        return NULL;
+    }
+
+    while (!atomic_load_explicit(&pool->failed, memory_order_relaxed))
+    {
+        int game_index = take_game(worker);
+
+        if (game_index < 0)
+        {
+            if (!steal_games(worker))
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (play_game(game, pool->options, game_index, &pool->results[game_index]) != 0)
+        {
+            atomic_store(&pool->failed, true);
+        }
+    }
+
+    free(game);
+    return NULL;
+}
+
+static int compare_ticks(const void *first, const void *second)
+{
+    uint32_t a = *(const uint32_t *)first;
+    uint32_t b = *(const uint32_t *)second;
+
+    return (a > b) - (a < b);
+}
+
+int run_batch(const batch_options *options, batch_game_result *results,
+              batch_statistics *statistics)
+{
+    int worker_count = options->thread_count;
+    struct timespec start_time, end_time;
+
+    if (worker_count < 1)
+    {
+        worker_count = 1;
+    }
+    if (worker_count > BATCH_MAX_THREADS)
+    {
+        worker_count = BATCH_MAX_THREADS;
+    }
+
+    batch_pool pool = {
+        .options = options,
+        .results = results,
+        .worker_count = worker_count,
+        .failed = false
+    };
+
+    pool.workers = aligned_alloc(CACHE_LINE_BYTES, sizeof(batch_worker) * (size_t)worker_count);
+    if (pool.workers == NULL)
+    {
+        return -1;
+    }
+
+    // Split the games into equal contiguous ranges; stealing evens out the rest
+    for (int i = 0; i < worker_count; i++)
+    {
+        int begin = (int)((int64_t)options->game_count * i / worker_count);
+        int end = (int)((int64_t)options->game_count * (i + 1) / worker_count);
+
+        atomic_init(&pool.workers[i].range, PACK_RANGE(begin, end));
+        pool.workers[i].index = i;
+        pool.workers[i].steals = 0;
+        pool.workers[i].pool = &pool;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    int started = 0;
+    for (; started < worker_count; started++)
+    {
+        if (pthread_create(&pool.workers[started].thread, NULL, worker_main,
+                           &pool.workers[started]) != 0)
+        {
+            atomic_store(&pool.failed, true);
+            break;
+        }
+    }
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(pool.workers[i].thread, NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    memset(statistics, 0, sizeof(*statistics));
+    statistics->elapsed_nanoseconds = (int64_t)(end_time.tv_sec - start_time.tv_sec) *
+                                      1000000000LL + (end_time.tv_nsec - start_time.tv_nsec);
+    for (int i = 0; i < worker_count; i++)
+    {
+        statistics->steals += pool.workers[i].steals;
+    }
+    free(pool.workers);
+
+    if (atomic_load(&pool.failed))
+    {
+        return -1;
+    }
+
+    uint32_t *ticks = malloc(sizeof(uint32_t) * (size_t)(options->game_count > 0 ?
+                                                          options->game_count : 1));
+    if (ticks == NULL)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < options->game_count; i++)
+    {
+        ticks[i] = results[i].ticks;
+        statistics->total_ticks += results[i].ticks;
+        statistics->crashed_games += results[i].crashed;
+    }
+
+    if (options->game_count > 0)
+    {
+        qsort(ticks, (size_t)options->game_count, sizeof(uint32_t), compare_ticks);
+        statistics->min_ticks = ticks[0];
+        statistics->median_ticks = ticks[options->game_count / 2];
+        statistics->max_ticks = ticks[options->game_count - 1];
+    }
+
+    free(ticks);
+    return 0;
+}
+
+// End of batch.c
@@ -0,0 +1,239 @@
+/**************************************************************************************************/
+/**
+ * @file entity_store.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Pooled structure-of-arrays storage for everything that scrolls with the world
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "entity_store.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// GCC/Clang vector extension: lowered to SSE on x86 and NEON on ARM
+typedef float position_vector
+    __attribute__((vector_size(ENTITY_STORE_VECTOR_WIDTH * sizeof(float))));
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    resize_column
+ * @brief   Grows one column to new_capacity elements and zeroes the new elements, so the position
+ *          pass never reads uninitialized floats.
+ *
+ * @param   column
+ * @param   element_size
+ * @param   old_capacity
+ * @param   new_capacity
+ *
+ * @return  void*   The resized column, or NULL if memory could not be allocated, in which case
+ *                  the original column is left untouched
+ */
+/**************************************************************************************************/
+static void *resize_column(void *column, size_t element_size, int old_capacity, int new_capacity);
+
+/**************************************************************************************************/
+/**
+ * @name    grow_entity_store
+ * @brief   Grows every column of the store to new_capacity elements.
+ *
+ * @param   store
+ * @param   new_capacity    A multiple of ENTITY_STORE_VECTOR_WIDTH
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+static int grow_entity_store(entity_store *store, int new_capacity);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void *resize_column(void *column, size_t element_size, int old_capacity, int new_capacity)
+{
+    char *resized = realloc(column, element_size * (size_t)new_capacity);
+
+    if (resized != NULL)
+    {
+        memset(resized + element_size * (size_t)old_capacity, 0,
+               element_size * (size_t)(new_capacity - old_capacity));
+    }
+
+    return resized;
+}
+
+static int grow_entity_store(entity_store *store, int new_capacity)
+{
+    // Each column is committed as soon as it is resized, so a failure part way leaves every
+    // column at least store->capacity long and the store still usable
+    float *x = resize_column(store->x, sizeof(float), store->capacity, new_capacity);
+    if (x == NULL)
+    {
+        return -1;
+    }
+    store->x = x;
+
+    float *speed = resize_column(store->speed, sizeof(float), store->capacity, new_capacity);
+    if (speed == NULL)
+    {
+        return -1;
+    }
+    store->speed = speed;
+
+    uint16_t *texture = resize_column(store->texture, sizeof(uint16_t), store->capacity,
+                                      new_capacity);
+    if (texture == NULL)
+    {
+        return -1;
+    }
+    store->texture = texture;
+
+    uint8_t *layer = resize_column(store->layer, sizeof(uint8_t), store->capacity, new_capacity);
+    if (layer == NULL)
+    {
+        return -1;
+    }
+    store->layer = layer;
+
+    int *stamp_column = resize_column(store->stamp_column, sizeof(int), store->capacity,
+                                      new_capacity);
+    if (stamp_column == NULL)
+    {
+        return -1;
+    }
+    store->stamp_column = stamp_column;
+
+    uint32_t *sequence = resize_column(store->sequence, sizeof(uint32_t), store->capacity,
+                                       new_capacity);
+    if (sequence == NULL)
+    {
+        return -1;
+    }
+    store->sequence = sequence;
+
+    int *next_free = resize_column(store->next_free, sizeof(int), store->capacity, new_capacity);
+    if (next_free == NULL)
+    {
+        return -1;
+    }
+    store->next_free = next_free;
+
+    store->capacity = new_capacity;
+    return 0;
+}
+
+int initialize_entity_store(entity_store *store, int initial_capacity)
+{
+    memset(store, 0, sizeof(*store));
+    store->free_head = -1;
+
+    if (initial_capacity < ENTITY_STORE_MIN_CAPACITY)
+    {
+        initial_capacity = ENTITY_STORE_MIN_CAPACITY;
+    }
+    initial_capacity = (initial_capacity + ENTITY_STORE_VECTOR_WIDTH - 1) /
+                       ENTITY_STORE_VECTOR_WIDTH * ENTITY_STORE_VECTOR_WIDTH;
+
+    if (grow_entity_store(store, initial_capacity) != 0)
+    {
+        free_entity_store(store);
+        return -1;
+    }
+
+    return 0;
+}
+
+void free_entity_store(entity_store *store)
+{
+    free(store->x);
+    free(store->speed);
+    free(store->texture);
+    free(store->layer);
+    free(store->stamp_column);
+    free(store->sequence);
+    free(store->next_free);
+    memset(store, 0, sizeof(*store));
+    store->free_head = -1;
+}
+
+int add_entity(entity_store *store, float x, float speed, uint16_t texture, uint8_t layer)
+{
+    int entity;
+
+    if (store->free_head >= 0)
+    {
+        entity = store->free_head;
+        store->free_head = store->next_free[entity];
+    }
+    else
+    {
+        if (store->slot_count == store->capacity &&
+            grow_entity_store(store, store->capacity * 2) != 0)
+        {
+            return -1;
+        }
+        entity = store->slot_count++;
+    }
+
+    store->x[entity] = x;
+    store->speed[entity] = speed;
+    store->texture[entity] = texture;
+    store->layer[entity] = layer;
+    store->stamp_column[entity] = 0;
+    store->sequence[entity] = store->next_sequence++;
+    store->live_count++;
+
+    return entity;
+}
+
+void remove_entity(entity_store *store, int entity)
+{
+    store->layer[entity] = ENTITY_LAYER_FREE;
+    store->next_free[entity] = store->free_head;
+    store->free_head = entity;
+    store->live_count--;
+}
+
+void advance_entities(entity_store *store, float scroll_speed)
+{
+    // Capacity is a multiple of the vector width, so rounding up stays inside the columns
+    int end = (store->slot_count + ENTITY_STORE_VECTOR_WIDTH - 1) /
+              ENTITY_STORE_VECTOR_WIDTH * ENTITY_STORE_VECTOR_WIDTH;
+    position_vector scroll = { scroll_speed, scroll_speed, scroll_speed, scroll_speed };
+
+    for (int entity = 0; entity < end; entity += ENTITY_STORE_VECTOR_WIDTH)
+    {
+        position_vector x, speed;
+        memcpy(&x, store->x + entity, sizeof(x));
+        memcpy(&speed, store->speed + entity, sizeof(speed));
+
+        x -= speed * scroll;
+        memcpy(store->x + entity, &x, sizeof(x));
+    }
+}
+
+// End of entity_store.c
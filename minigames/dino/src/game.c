@@ -0,0 +1,152 @@
+/**************************************************************************************************/
+/**
+ * @file game.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief One self-contained game: the player, the scenery, the obstacles and their generators.
+ *        Games share nothing but the read-only texture table, so any number of them can run at
+ *        once on different threads.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include "game.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    spawn_world_events
+ * @brief   Adds everything the world says enters the screen during the coming tick. Each is placed
+ *          where it must be before the tick's move to end up at its event's position the moment
+ *          the ground passes the event's distance.
+ *
+ * @param   game
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+static int spawn_world_events(dino_game *game);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static int spawn_world_events(dino_game *game)
+{
+    float tick_end = game->distance + game->scroll_speed;
+    world_event event;
+
+    while (take_world_event(&game->world, tick_end, &event))
+    {
+        float ahead = event.distance - game->distance;
+
+        if (event.source == WORLD_SOURCE_OBSTACLES)
+        {
+            if (add_obstacle(&game->obstacles, (texture_id)event.texture,
+                             event.x + ahead * OBSTACLE_SPEED_MULTIPLIER) != 0)
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            layer_type layer = (layer_type)event.source;
+
+            if (add_background_element(&game->background, layer, (texture_id)event.texture,
+                                       event.x + ahead *
+                                       game->background.layers[layer].speed_multiplier) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int initialize_game(dino_game *game, uint64_t seed, float scroll_speed)
+{
+    initialize_sprite(&game->character);
+
+    if (initialize_background(&game->background, seed) != 0)
+    {
+        return -1;
+    }
+    if (initialize_obstacles(&game->obstacles) != 0)
+    {
+        free_background(&game->background);
+        return -1;
+    }
+
+    initialize_world(&game->world, seed, scroll_speed);
+    game->scroll_speed = scroll_speed;
+    game->distance = 0.0f;
+    game->tick = 0;
+    game->jumps = 0;
+    game->game_over = false;
+    game->hud = NULL;
+
+    return 0;
+}
+
+void free_game(dino_game *game)
+{
+    free_world(&game->world);
+    free_obstacles(&game->obstacles);
+    free_background(&game->background);
+}
+
+bool advance_game(dino_game *game, bool jump)
+{
+    if (jump)
+    {
+        sprite_jump(&game->character);
+        game->jumps++;
+    }
+
+    if (spawn_world_events(game) != 0)
+    {
+        game->game_over = true;
+    }
+
+    int64_t stage_time = start_perf_stage(game->hud);
+    update_sprite_position(&game->character);
+    stage_time = end_perf_stage(game->hud, PERF_STAGE_SPRITE, stage_time);
+    update_background(&game->background, game->scroll_speed);
+    end_perf_stage(game->hud, PERF_STAGE_BACKGROUND, stage_time);
+    game->distance += game->scroll_speed;
+
+    if (update_obstacles(&game->obstacles, game->scroll_speed) != 0 ||
+        check_collision(&game->obstacles, &game->character))
+    {
+        game->game_over = true;
+    }
+
+    game->tick++;
+    return game->game_over;
+}
+
+// End of game.c
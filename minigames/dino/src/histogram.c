@@ -0,0 +1,156 @@
+/**************************************************************************************************/
+/**
+ * @file histogram.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Fixed-size histogram of durations with power-of-two buckets, cheap enough to record
+ *        into from the game loop
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "histogram.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define HISTOGRAM_BAR_WIDTH     40
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    get_bucket_limit
+ * @brief   Returns the first value past a bucket.
+ *
+ * @param   bucket
+ *
+ * @return  int64_t
+ */
+/**************************************************************************************************/
+static int64_t get_bucket_limit(int bucket);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static int64_t get_bucket_limit(int bucket)
+{
+    return bucket >= HISTOGRAM_BUCKETS - 1 ? INT64_MAX : (int64_t)1 << bucket;
+}
+
+void reset_histogram(histogram *values)
+{
+    memset(values, 0, sizeof(*values));
+}
+
+void record_histogram(histogram *values, int64_t nanoseconds)
+{
+    if (nanoseconds < 0)
+    {
+        nanoseconds = 0;
+    }
+
+    // Bucket is the bit length of the value, so one count-leading-zeros finds it
+    int bucket = nanoseconds == 0 ? 0 : 64 - __builtin_clzll((unsigned long long)nanoseconds);
+
+    values->buckets[bucket]++;
+    values->total += nanoseconds;
+    if (values->count == 0 || nanoseconds < values->minimum)
+    {
+        values->minimum = nanoseconds;
+    }
+    if (values->count == 0 || nanoseconds > values->maximum)
+    {
+        values->maximum = nanoseconds;
+    }
+    values->count++;
+}
+
+int64_t get_histogram_percentile(const histogram *values, double percentile)
+{
+    if (values->count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the value asked for, counting from 1
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)values->count + 0.5);
+    uint64_t seen = 0;
+
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += values->buckets[bucket];
+        if (seen >= rank)
+        {
+            int64_t limit = get_bucket_limit(bucket);
+            return limit < values->maximum ? limit : values->maximum;
+        }
+    }
+
+    return values->maximum;
+}
+
+void print_histogram(FILE *stream, const char *name, const histogram *values)
+{
+    uint64_t largest = 0;
+
+    fprintf(stream, "%s: %llu samples", name, (unsigned long long)values->count);
+    if (values->count == 0)
+    {
+        fprintf(stream, "\n");
+        return;
+    }
+
+    fprintf(stream, ", min %.1f us, mean %.1f us, p50 <= %.1f us, p99 <= %.1f us, max %.1f us\n",
+            values->minimum / 1000.0, (double)values->total / (double)values->count / 1000.0,
+            get_histogram_percentile(values, 50.0) / 1000.0,
+            get_histogram_percentile(values, 99.0) / 1000.0, values->maximum / 1000.0);
+
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        if (values->buckets[bucket] > largest)
+        {
+            largest = values->buckets[bucket];
+        }
+    }
+
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        if (values->buckets[bucket] == 0)
+        {
+            continue;
+        }
+
+        int bar = (int)((values->buckets[bucket] * HISTOGRAM_BAR_WIDTH + largest - 1) / largest);
+        fprintf(stream, "  < %12.1f us %8llu %.*s\n", get_bucket_limit(bucket) / 1000.0,
+                (unsigned long long)values->buckets[bucket], bar,
+                "########################################");
+    }
+}
+
+// End of histogram.c
@@ -0,0 +1,198 @@
+/**************************************************************************************************/
+/**
+ * @file input_log.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Binary log of the keys that reached the simulation, and the replays read back from it
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "input_log.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    store_little_endian
+ * @brief   Stores the low length bytes of value, least significant first.
+ *
+ * @param   bytes
+ * @param   value
+ * @param   length
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void store_little_endian(unsigned char *bytes, uint64_t value, int length);
+
+/**************************************************************************************************/
+/**
+ * @name    load_little_endian
+ * @brief   Loads a length-byte little-endian integer.
+ *
+ * @param   bytes
+ * @param   length
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+static uint64_t load_little_endian(const unsigned char *bytes, int length);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void store_little_endian(unsigned char *bytes, uint64_t value, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint64_t load_little_endian(const unsigned char *bytes, int length)
+{
+    uint64_t value = 0;
+
+    for (int i = length - 1; i >= 0; i--)
+    {
+        value = (value << 8) | bytes[i];
+    }
+
+    return value;
+}
+
+int open_input_log(input_log *log, const char *path, uint64_t seed)
+{
+    unsigned char header[INPUT_LOG_HEADER_LENGTH];
+
+    log->file = fopen(path, "wb");
+    if (log->file == NULL)
+    {
+        return -1;
+    }
+
+    memcpy(header, INPUT_LOG_MAGIC, INPUT_LOG_MAGIC_LENGTH);
+    store_little_endian(header + INPUT_LOG_MAGIC_LENGTH, seed, 8);
+
+    if (fwrite(header, sizeof(header), 1, log->file) != 1)
+    {
+        fclose(log->file);
+        log->file = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void write_input_event(input_log *log, uint32_t tick, input_key key)
+{
+    unsigned char record[INPUT_LOG_RECORD_LENGTH];
+
+    if (log->file == NULL)
+    {
+        return;
+    }
+
+    store_little_endian(record, tick, 4);
+    record[4] = (unsigned char)key;
+
+    // Failures are sticky in the stream's error flag and reported by close_input_log
+    fwrite(record, sizeof(record), 1, log->file);
+}
+
+int close_input_log(input_log *log)
+{
+    if (log->file == NULL)
+    {
+        return 0;
+    }
+
+    int failed = ferror(log->file);
+    failed |= fclose(log->file);
+    log->file = NULL;
+
+    return failed ? -1 : 0;
+}
+
+int load_input_replay(input_replay *replay, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    unsigned char header[INPUT_LOG_HEADER_LENGTH];
+    unsigned char record[INPUT_LOG_RECORD_LENGTH];
+    int capacity = 0;
+
+    memset(replay, 0, sizeof(*replay));
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    if (fread(header, sizeof(header), 1, file) != 1 ||
+        memcmp(header, INPUT_LOG_MAGIC, INPUT_LOG_MAGIC_LENGTH) != 0)
+    {
+        fclose(file);
+        return -1;
+    }
+    replay->seed = load_little_endian(header + INPUT_LOG_MAGIC_LENGTH, 8);
+
+    while (fread(record, sizeof(record), 1, file) == 1)
+    {
+        if (replay->event_count == capacity)
+        {
+            int new_capacity = capacity > 0 ? capacity * 2 : 64;
+            input_event *events = realloc(replay->events, sizeof(input_event) * new_capacity);
+
+            if (events == NULL)
+            {
+                free_input_replay(replay);
+                fclose(file);
+                return -1;
+            }
+            replay->events = events;
+            capacity = new_capacity;
+        }
+
+        replay->events[replay->event_count].tick = (uint32_t)load_little_endian(record, 4);
+        replay->events[replay->event_count].key = (input_key)record[4];
+        replay->event_count++;
+    }
+
+    fclose(file);
+    return 0;
+}
+
+void free_input_replay(input_replay *replay)
+{
+    free(replay->events);
+    memset(replay, 0, sizeof(*replay));
+}
+
+// End of input_log.c
@@ -0,0 +1,307 @@
+/**************************************************************************************************/
+/**
+ * @file input_queue.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Keyboard reader thread and the lock-free queue of timestamped keys it feeds to the game
+ *        loop
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "input_queue.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define NANOSECONDS_PER_SECOND          1000000000LL
+
+#define INPUT_READ_LENGTH               64
+#define INPUT_ESCAPE                    0x1b
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Where the key parser is inside an escape sequence
+ * - KEY_STATE_TEXT: between sequences, each byte is a key
+ * - KEY_STATE_ESCAPE: after ESC, waiting for the sequence type
+ * - KEY_STATE_CONTROL: inside ESC [ (CSI), skipping parameters up to the final byte
+ * - KEY_STATE_SHIFT: after ESC O (SS3), the next byte is the final byte
+ */
+typedef enum
+{
+    KEY_STATE_TEXT,
+    KEY_STATE_ESCAPE,
+    KEY_STATE_CONTROL,
+    KEY_STATE_SHIFT
+} key_state;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    push_input
+ * @brief   Queues one key, or counts it as dropped if the ring is full. Reader thread only.
+ *
+ * @param   queue
+ * @param   key
+ * @param   timestamp
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void push_input(input_queue *queue, input_key key, int64_t timestamp);
+
+/**************************************************************************************************/
+/**
+ * @name    parse_key
+ * @brief   Feeds one byte to the key parser.
+ *
+ * @param   state       Parser state, carried across reads so a split sequence is still skipped
+ * @param   byte
+ * @param   key         Receives the key the byte completes
+ *
+ * @return  bool    true if the byte completed a key the game uses
+ */
+/**************************************************************************************************/
+static bool parse_key(key_state *state, unsigned char byte, input_key *key);
+
+/**************************************************************************************************/
+/**
+ * @name    read_keys
+ * @brief   Reader thread body.
+ *
+ * @param   argument    The input_queue
+ *
+ * @return  void*
+ */
+/**************************************************************************************************/
+static void *read_keys(void *argument);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void push_input(input_queue *queue, input_key key, int64_t timestamp)
+{
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    if (tail - head == INPUT_QUEUE_CAPACITY)
+    {
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    timed_input *slot = &queue->events[tail & (INPUT_QUEUE_CAPACITY - 1)];
+    slot->key = key;
+    slot->timestamp = timestamp;
+
+    // Publishes the slot: the game loop's acquire load of tail sees it filled in
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+}
+
+static bool parse_key(key_state *state, unsigned char byte, input_key *key)
+{
+    switch (*state)
+    {
+    case KEY_STATE_ESCAPE:
+        if (byte == '[')
+        {
+            *state = KEY_STATE_CONTROL;
+            return false;
+        }
+        if (byte == 'O')
+        {
+            *state = KEY_STATE_SHIFT;
+            return false;
+        }
+
+        // Alt+key or a lone ESC followed by a key: treat the byte as text
+        *state = KEY_STATE_TEXT;
+        return parse_key(state, byte, key);
+
+    case KEY_STATE_CONTROL:
+        if (byte < 0x40 || byte > 0x7e)
+        {
+            return false;   // Parameter or intermediate byte
+        }
+        *state = KEY_STATE_TEXT;
+        *key = INPUT_KEY_JUMP;
+        return byte == 'A';
+
+    case KEY_STATE_SHIFT:
+        *state = KEY_STATE_TEXT;
+        *key = INPUT_KEY_JUMP;
+        return byte == 'A';
+
+    case KEY_STATE_TEXT:
+    default:
+        if (byte == INPUT_ESCAPE)
+        {
+            *state = KEY_STATE_ESCAPE;
+            return false;
+        }
+        if (byte == ' ')
+        {
+            *key = INPUT_KEY_JUMP;
+            return true;
+        }
+        if (byte == 'q' || byte == 'Q')
+        {
+            *key = INPUT_KEY_QUIT;
+            return true;
+        }
+        if (byte == 'p' || byte == 'P')
+        {
+            *key = INPUT_KEY_PERF_HUD;
+            return true;
+        }
+        return false;
+    }
+}
+
+static void *read_keys(void *argument)
+{
+    input_queue *queue = argument;
+    key_state state = KEY_STATE_TEXT;
+    unsigned char bytes[INPUT_READ_LENGTH];
+
+    for (;;)
+    {
+        struct pollfd descriptors[2] = {
+            { .fd = queue->descriptor, .events = POLLIN },
+            { .fd = queue->stop_pipe[0], .events = POLLIN }
+        };
+
+        if (poll(descriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (descriptors[1].revents != 0)
+        {
+            break;
+        }
+
+        // With VMIN 0 a terminal read returns 0 when nothing is waiting, so 0 only means end of
+        // file when poll said the descriptor was readable
+        ssize_t length = read(queue->descriptor, bytes, sizeof(bytes));
+        int64_t timestamp = get_monotonic_nanoseconds();
+
+        if (length < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            continue;
+        }
+        if (length <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t i = 0; i < length; i++)
+        {
+            input_key key;
+
+            if (parse_key(&state, bytes[i], &key))
+            {
+                push_input(queue, key, timestamp);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+int start_input_thread(input_queue *queue, int descriptor)
+{
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->dropped, 0);
+    queue->descriptor = descriptor;
+    queue->running = false;
+
+    if (pipe(queue->stop_pipe) != 0)
+    {
+        return -1;
+    }
+
+    int error = pthread_create(&queue->thread, NULL, read_keys, queue);
+    if (error != 0)
+    {
+        close(queue->stop_pipe[0]);
+        close(queue->stop_pipe[1]);
+        errno = error;
+        return -1;
+    }
+
+    queue->running = true;
+    return 0;
+}
+
+void stop_input_thread(input_queue *queue)
+{
+    if (!queue->running)
+    {
+        return;
+    }
+
+    close(queue->stop_pipe[1]);
+    pthread_join(queue->thread, NULL);
+    close(queue->stop_pipe[0]);
+    queue->running = false;
+}
+
+bool take_input_before(input_queue *queue, int64_t before, timed_input *event)
+{
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    const timed_input *slot = &queue->events[head & (INPUT_QUEUE_CAPACITY - 1)];
+    if (slot->timestamp >= before)
+    {
+        return false;
+    }
+
+    *event = *slot;
+
+    // Hands the slot back: the reader's acquire load of head sees it free only after the copy
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+int64_t get_monotonic_nanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+// End of input_queue.c
@@ -0,0 +1,288 @@
+/**************************************************************************************************/
+/**
+ * @file obstacles.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Cacti and birds the player has to jump over, and collision tests against them
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "obstacles.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    get_grid_cell
+ * @brief   Returns the broadphase cell holding a screen column, or -1 if the column is outside
+ *          the grid.
+ *
+ * @param   column
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+static int get_grid_cell(int column);
+
+/**************************************************************************************************/
+/**
+ * @name    rebuild_collision_grid
+ * @brief   Bins every live obstacle by the grid cell of its left edge with a counting sort, so each
+ *          cell's obstacles are contiguous in cell_entities.
+ *
+ * @param   obstacles
+ *
+ * @return  int     0 on success, -1 if memory could not be allocated
+ */
+/**************************************************************************************************/
+static int rebuild_collision_grid(obstacle_system *obstacles);
+
+/**************************************************************************************************/
+/**
+ * @name    masks_overlap
+ * @brief   Tests two masked textures for a shared visible cell.
+ *
+ * @param   first
+ * @param   first_x
+ * @param   first_y
+ * @param   second
+ * @param   second_x
+ * @param   second_y
+ *
+ * @return  bool
+ */
+/**************************************************************************************************/
+static bool masks_overlap(const compiled_ascii_object *first, int first_x, int first_y,
+                          const compiled_ascii_object *second, int second_x, int second_y);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static int get_grid_cell(int column)
+{
+    if (column < OBSTACLE_GRID_ORIGIN || column >= TERMINAL_DISPLAY_WIDTH)
+    {
+        return -1;
+    }
+
+    return (column - OBSTACLE_GRID_ORIGIN) / OBSTACLE_GRID_CELL_WIDTH;
+}
+
+static int rebuild_collision_grid(obstacle_system *obstacles)
+{
+    const entity_store *entities = &obstacles->entities;
+    int *cell_start = obstacles->cell_start;
+
+    if (obstacles->cell_entities_capacity < entities->capacity)
+    {
+        int *cell_entities = realloc(obstacles->cell_entities,
+                                     sizeof(int) * (size_t)entities->capacity);
+        if (cell_entities == NULL)
+        {
+            return -1;
+        }
+        obstacles->cell_entities = cell_entities;
+        obstacles->cell_entities_capacity = entities->capacity;
+    }
+
+    // Count into cell_start[c + 1], then turn the counts into start offsets
+    memset(cell_start, 0, sizeof(obstacles->cell_start));
+    for (int entity = 0; entity < entities->slot_count; entity++)
+    {
+        int cell = get_grid_cell((int)floorf(entities->x[entity]));
+
+        if (cell >= 0 && entities->layer[entity] == OBSTACLE_LAYER)
+        {
+            cell_start[cell + 1]++;
+        }
+    }
+    for (int cell = 0; cell < OBSTACLE_GRID_CELLS; cell++)
+    {
+        cell_start[cell + 1] += cell_start[cell];
+    }
+
+    // Fill each cell from its end, then step the ends back so cell_start holds starts again
+    int cell_end[OBSTACLE_GRID_CELLS];
+    memcpy(cell_end, cell_start + 1, sizeof(cell_end));
+    for (int entity = entities->slot_count - 1; entity >= 0; entity--)
+    {
+        int cell = get_grid_cell((int)floorf(entities->x[entity]));
+
+        if (cell >= 0 && entities->layer[entity] == OBSTACLE_LAYER)
+        {
+            obstacles->cell_entities[--cell_end[cell]] = entity;
+        }
+    }
+
+    return 0;
+}
+
+static bool masks_overlap(const compiled_ascii_object *first, int first_x, int first_y,
+                          const compiled_ascii_object *second, int second_x, int second_y)
+{
+    int offset = second_x - first_x;
+
+    // Reject by bounding box first; it also keeps every shift below 64
+    if (offset >= first->width || -offset >= second->width)
+    {
+        return false;
+    }
+
+    int top = first_y > second_y ? first_y : second_y;
+    int bottom = first_y + first->height < second_y + second->height ? first_y + first->height
+                                                                     : second_y + second->height;
+
+    for (int row = top; row < bottom; row++)
+    {
+        uint64_t first_mask = first->row_masks[row - first_y];
+        uint64_t second_mask = second->row_masks[row - second_y];
+
+        // Line both masks up in the first texture's columns
+        uint64_t overlap = offset >= 0 ? first_mask & (second_mask << offset)
+                                       : (first_mask << -offset) & second_mask;
+        if (overlap != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int initialize_obstacles(obstacle_system *obstacles)
+{
+    obstacles->last_scroll_speed = 0.0f;
+    obstacles->cell_entities = NULL;
+    obstacles->cell_entities_capacity = 0;
+
+    if (initialize_entity_store(&obstacles->entities, ENTITY_STORE_MIN_CAPACITY) != 0)
+    {
+        return -1;
+    }
+
+    if (rebuild_collision_grid(obstacles) != 0)
+    {
+        free_obstacles(obstacles);
+        return -1;
+    }
+
+    return 0;
+}
+
+void free_obstacles(obstacle_system *obstacles)
+{
+    free_entity_store(&obstacles->entities);
+    free(obstacles->cell_entities);
+    obstacles->cell_entities = NULL;
+    obstacles->cell_entities_capacity = 0;
+}
+
+int get_obstacle_row(texture_id texture)
+{
+    if (texture == TEXTURE_BIRD)
+    {
+        return OBSTACLE_BIRD_ROW;
+    }
+
+    return TERMINAL_DISPLAY_HEIGHT - 1 - get_texture(texture)->height;
+}
+
+int add_obstacle(obstacle_system *obstacles, texture_id texture, float x)
+{
+    if (add_entity(&obstacles->entities, x, OBSTACLE_SPEED_MULTIPLIER, (uint16_t)texture,
+                   OBSTACLE_LAYER) < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int update_obstacles(obstacle_system *obstacles, float speed)
+{
+    entity_store *entities = &obstacles->entities;
+
+    advance_entities(entities, speed);
+    obstacles->last_scroll_speed = speed;
+
+    for (int entity = 0; entity < entities->slot_count; entity++)
+    {
+        if (entities->layer[entity] == OBSTACLE_LAYER &&
+            entities->x[entity] < -get_texture((texture_id)entities->texture[entity])->width)
+        {
+            remove_entity(entities, entity);
+        }
+    }
+
+    return rebuild_collision_grid(obstacles);
+}
+
+bool check_collision(const obstacle_system *obstacles, const sprite *character)
+{
+    const entity_store *entities = &obstacles->entities;
+    const compiled_ascii_object *player = get_texture(TEXTURE_PLAYER);
+    int player_y = (int)lroundf(character->y);
+
+    // Any obstacle reaching the player's columns has its left edge in this range
+    int first_column = character->x - ASCII_MASK_MAX_WIDTH + 1;
+    int last_column = character->x + player->width - 1;
+
+    if (first_column < OBSTACLE_GRID_ORIGIN)
+    {
+        first_column = OBSTACLE_GRID_ORIGIN;
+    }
+    if (last_column >= TERMINAL_DISPLAY_WIDTH)
+    {
+        last_column = TERMINAL_DISPLAY_WIDTH - 1;
+    }
+    if (first_column > last_column)
+    {
+        return false;
+    }
+
+    int first_cell = get_grid_cell(first_column);
+    int last_cell = get_grid_cell(last_column);
+
+    for (int i = obstacles->cell_start[first_cell]; i < obstacles->cell_start[last_cell + 1]; i++)
+    {
+        int entity = obstacles->cell_entities[i];
+        texture_id texture = (texture_id)entities->texture[entity];
+
+        if (masks_overlap(player, character->x, player_y, get_texture(texture),
+                          (int)floorf(entities->x[entity]), get_obstacle_row(texture)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// End of obstacles.c
@@ -0,0 +1,297 @@
+/**************************************************************************************************/
+/**
+ * @file particles.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Dust, rain and snow drifting over the scenery, stored as structure-of-arrays columns and
+ *        updated a vector of particles at a time
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "particles.h"
+#include "prng.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define PARTICLE_COLUMN_ALIGNMENT   (PARTICLE_VECTOR_WIDTH * sizeof(float))
+
+// xorshift32 output is turned into a float in [0, 1) from its top 24 bits
+#define PARTICLE_RANDOM_SCALE       (1.0f / 16777216.0f)
+
+// Per-lane choice between two float vectors, where mask is all ones in the lanes that take
+// if_true, as produced by a vector compare
+#define SELECT_LANES(mask, if_true, if_false) \
+    ((particle_vector)(((mask) & (lane_vector)(if_true)) | (~(mask) & (lane_vector)(if_false))))
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+// GCC/Clang vector extension: lowered to SSE on x86 and NEON on ARM
+typedef float particle_vector
+    __attribute__((vector_size(PARTICLE_VECTOR_WIDTH * sizeof(float))));
+typedef int32_t lane_vector __attribute__((vector_size(PARTICLE_VECTOR_WIDTH * sizeof(int32_t))));
+typedef uint32_t random_vector
+    __attribute__((vector_size(PARTICLE_VECTOR_WIDTH * sizeof(uint32_t))));
+
+/**
+ * How each kind looks and moves. A particle's velocity is drawn once, when it is created:
+ * base + range * r for a random r in [0, 1).
+ */
+static const struct
+{
+    char glyph;
+    float depth;
+    float velocity_x;
+    float velocity_x_range;
+    float velocity_y;
+    float velocity_y_range;
+} particle_kinds[PARTICLE_KIND_COUNT] = {
+    [PARTICLE_DUST] = { '.', 1.0f,  0.00f, 0.0f, 0.00f, 0.0f },
+    [PARTICLE_RAIN] = { '/', 0.2f, -0.40f, 0.1f, 1.20f, 0.6f },
+    [PARTICLE_SNOW] = { '*', 0.3f, -0.15f, 0.3f, 0.15f, 0.2f }
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    get_random_float
+ * @brief   Returns a random float in [0, 1) from a scalar generator, for creating particles.
+ *
+ * @param   generator
+ *
+ * @return  float
+ */
+/**************************************************************************************************/
+static float get_random_float(prng *generator);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static float get_random_float(prng *generator)
+{
+    return (float)(next_prng(generator) >> 8) * PARTICLE_RANDOM_SCALE;
+}
+
+int initialize_particles(particle_system *particles, uint64_t seed,
+                         const int counts[PARTICLE_KIND_COUNT])
+{
+    prng generator;
+    int capacity = 0;
+
+    memset(particles, 0, sizeof(*particles));
+
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; kind++)
+    {
+        particles->first[kind] = capacity;
+        particles->count[kind] = counts[kind] > 0 ? counts[kind] : 0;
+        capacity += (particles->count[kind] + PARTICLE_VECTOR_WIDTH - 1) /
+                    PARTICLE_VECTOR_WIDTH * PARTICLE_VECTOR_WIDTH;
+    }
+    particles->capacity = capacity;
+
+    if (capacity == 0)
+    {
+        return 0;
+    }
+
+    size_t float_column = sizeof(float) * (size_t)capacity;
+    particles->x = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT, float_column);
+    particles->y = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT, float_column);
+    particles->velocity_x = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT, float_column);
+    particles->velocity_y = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT, float_column);
+    particles->depth = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT, float_column);
+    particles->random_state = aligned_alloc(PARTICLE_COLUMN_ALIGNMENT,
+                                            sizeof(uint32_t) * (size_t)capacity);
+
+    if (particles->x == NULL || particles->y == NULL || particles->velocity_x == NULL ||
+        particles->velocity_y == NULL || particles->depth == NULL ||
+        particles->random_state == NULL)
+    {
+        free_particles(particles);
+        return -1;
+    }
+
+    // Padding particles are created like real ones so the update treats every lane the same
+    seed_prng(&generator, seed, PRNG_STREAM_PARTICLES);
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; kind++)
+    {
+        int end = kind + 1 < PARTICLE_KIND_COUNT ? particles->first[kind + 1] : capacity;
+
+        for (int particle = particles->first[kind]; particle < end; particle++)
+        {
+            particles->x[particle] = get_random_float(&generator) * TERMINAL_DISPLAY_WIDTH;
+            particles->y[particle] = get_random_float(&generator) * PARTICLE_FIELD_HEIGHT;
+            particles->velocity_x[particle] = particle_kinds[kind].velocity_x +
+                                              particle_kinds[kind].velocity_x_range *
+                                              get_random_float(&generator);
+            particles->velocity_y[particle] = particle_kinds[kind].velocity_y +
+                                              particle_kinds[kind].velocity_y_range *
+                                              get_random_float(&generator);
+            particles->depth[particle] = particle_kinds[kind].depth;
+
+            // A zero xorshift32 state would stay zero, so every state starts odd
+            particles->random_state[particle] = next_prng(&generator) | 1;
+        }
+    }
+
+    return 0;
+}
+
+void free_particles(particle_system *particles)
+{
+    free(particles->x);
+    free(particles->y);
+    free(particles->velocity_x);
+    free(particles->velocity_y);
+    free(particles->depth);
+    free(particles->random_state);
+    memset(particles, 0, sizeof(*particles));
+}
+
+void update_particles(particle_system *particles, float scroll_speed)
+{
+    const particle_vector zero = { 0.0f };
+    const particle_vector scroll = zero + scroll_speed;
+    const particle_vector width = zero + (float)TERMINAL_DISPLAY_WIDTH;
+    const particle_vector height = zero + (float)PARTICLE_FIELD_HEIGHT;
+
+    particles->last_scroll_speed = scroll_speed;
+
+    for (int particle = 0; particle < particles->capacity; particle += PARTICLE_VECTOR_WIDTH)
+    {
+        particle_vector x, y, velocity_x, velocity_y, depth;
+        random_vector state;
+
+        memcpy(&x, particles->x + particle, sizeof(x));
+        memcpy(&y, particles->y + particle, sizeof(y));
+        memcpy(&velocity_x, particles->velocity_x + particle, sizeof(velocity_x));
+        memcpy(&velocity_y, particles->velocity_y + particle, sizeof(velocity_y));
+        memcpy(&depth, particles->depth + particle, sizeof(depth));
+        memcpy(&state, particles->random_state + particle, sizeof(state));
+
+        x += velocity_x - scroll * depth;
+        y += velocity_y;
+
+        // One xorshift32 step per lane; lanes that do not respawn keep their old state
+        random_vector next = state ^ (state << 13);
+        next ^= next >> 17;
+        next ^= next << 5;
+        particle_vector random = __builtin_convertvector((lane_vector)(next >> 8),
+                                                         particle_vector) * PARTICLE_RANDOM_SCALE;
+
+        lane_vector left = x < zero;
+        lane_vector right = x >= width;
+        lane_vector bottom = y >= height;
+        lane_vector sideways = left | right;
+
+        // Off the side: back in on the other side at a random height. Off the bottom: back in
+        // at the top at a random column.
+        x = SELECT_LANES(left, x + width, x);
+        x = SELECT_LANES(right, x - width, x);
+        y = SELECT_LANES(sideways, random * height, y);
+        y = SELECT_LANES(bottom, y - height, y);
+        x = SELECT_LANES(bottom, random * width, x);
+        state = (random_vector)(((sideways | bottom) & (lane_vector)next) |
+                                (~(sideways | bottom) & (lane_vector)state));
+
+        memcpy(particles->x + particle, &x, sizeof(x));
+        memcpy(particles->y + particle, &y, sizeof(y));
+        memcpy(particles->random_state + particle, &state, sizeof(state));
+    }
+}
+
+void draw_particles(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                    frame_coverage *coverage, const particle_system *particles,
+                    float interpolation)
+{
+    const particle_vector zero = { 0.0f };
+    const particle_vector lag = zero + (1.0f - interpolation);
+    const particle_vector scroll = zero + particles->last_scroll_speed;
+    char *cells = &terminal_display[0][0];
+    uint32_t drawn = 0;
+    uint32_t hidden = 0;
+
+    // Later particles are in front of earlier ones, so they claim their cells first
+    for (int kind = PARTICLE_KIND_COUNT - 1; kind >= 0; kind--)
+    {
+        char glyph = particle_kinds[kind].glyph;
+        int first = particles->first[kind];
+        int end = first + particles->count[kind];
+        int last_vector = end > first ? first + (end - first - 1) / PARTICLE_VECTOR_WIDTH *
+                                                PARTICLE_VECTOR_WIDTH
+                                      : first - PARTICLE_VECTOR_WIDTH;
+
+        for (int particle = last_vector; particle >= first; particle -= PARTICLE_VECTOR_WIDTH)
+        {
+            particle_vector x, y, velocity_x, velocity_y, depth;
+
+            memcpy(&x, particles->x + particle, sizeof(x));
+            memcpy(&y, particles->y + particle, sizeof(y));
+            memcpy(&velocity_x, particles->velocity_x + particle, sizeof(velocity_x));
+            memcpy(&velocity_y, particles->velocity_y + particle, sizeof(velocity_y));
+            memcpy(&depth, particles->depth + particle, sizeof(depth));
+
+            // Step back towards the previous position. Converting to int truncates towards
+            // zero, so shift by a screen first to round the slightly negative ones down.
+            x -= lag * (velocity_x - scroll * depth);
+            y -= lag * velocity_y;
+            lane_vector column = __builtin_convertvector(x + (float)TERMINAL_DISPLAY_WIDTH,
+                                                         lane_vector) - TERMINAL_DISPLAY_WIDTH;
+            lane_vector row = __builtin_convertvector(y + (float)PARTICLE_FIELD_HEIGHT,
+                                                      lane_vector) - PARTICLE_FIELD_HEIGHT;
+            lane_vector inside = (column >= 0) & (column < TERMINAL_DISPLAY_WIDTH) &
+                                 (row >= 0) & (row < PARTICLE_FIELD_HEIGHT);
+
+            int lanes = end - particle < PARTICLE_VECTOR_WIDTH ? end - particle
+                                                               : PARTICLE_VECTOR_WIDTH;
+            lane_vector word = row * COVERAGE_WORDS + column / COVERAGE_WORD_BITS;
+            lane_vector bit = column % COVERAGE_WORD_BITS;
+            lane_vector cell = row * TERMINAL_DISPLAY_WIDTH + column;
+
+            for (int lane = lanes - 1; lane >= 0; lane--)
+            {
+                if (!inside[lane])
+                {
+                    continue;
+                }
+
+                uint64_t *covered = &coverage->rows[0][0] + word[lane];
+                uint64_t mask = UINT64_C(1) << bit[lane];
+                bool is_hidden = (*covered & mask) != 0;
+
+                // Selected rather than branched on: whether a particle is hidden is random
+                *covered |= mask;
+                cells[cell[lane]] = is_hidden ? cells[cell[lane]] : glyph;
+                drawn++;
+                hidden += is_hidden;
+            }
+        }
+    }
+
+    // Counted locally: the glyph stores may alias anything, so counting through coverage would
+    // chain every iteration on a load and store of the counter
+    coverage->cells_written += drawn - hidden;
+    coverage->cells_hidden += hidden;
+}
+
+// End of particles.c
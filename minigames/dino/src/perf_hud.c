@@ -0,0 +1,165 @@
+/**************************************************************************************************/
+/**
+ * @file perf_hud.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Frame time breakdown of the live game, recorded into fixed-size histograms and shown
+ *        as an overlay toggled with P
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "input_queue.h"
+#include "perf_hud.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define NANOSECONDS_PER_MICROSECOND     1000.0
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+static const char *const stage_names[PERF_STAGE_COUNT] = {
+    [PERF_STAGE_FRAME]      = "frame",
+    [PERF_STAGE_BACKGROUND] = "background",
+    [PERF_STAGE_SPRITE]     = "sprite",
+    [PERF_STAGE_COMPOSE]    = "compose",
+    [PERF_STAGE_OUTPUT]     = "output"
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    draw_hud_line
+ * @brief   Writes one line of the overlay over a frame row, blanking the rest of the overlay
+ *          width so the scenery does not show through.
+ *
+ * @param   row_cells
+ * @param   text
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void draw_hud_line(char *row_cells, const char *text);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void draw_hud_line(char *row_cells, const char *text)
+{
+    size_t length = strlen(text);
+
+    if (length > PERF_HUD_WIDTH)
+    {
+        length = PERF_HUD_WIDTH;
+    }
+
+    memset(row_cells, ' ', PERF_HUD_WIDTH);
+    memcpy(row_cells, text, length);
+}
+
+void initialize_perf_hud(perf_hud *hud)
+{
+    memset(hud, 0, sizeof(*hud));
+
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++)
+    {
+        reset_histogram(&hud->stages[stage]);
+    }
+}
+
+int64_t start_perf_stage(const perf_hud *hud)
+{
+    return hud != NULL ? get_monotonic_nanoseconds() : 0;
+}
+
+int64_t end_perf_stage(perf_hud *hud, perf_stage stage, int64_t start_time)
+{
+    if (hud == NULL)
+    {
+        return 0;
+    }
+
+    int64_t end_time = get_monotonic_nanoseconds();
+
+    hud->latest[stage] = end_time - start_time;
+    record_histogram(&hud->stages[stage], end_time - start_time);
+
+    return end_time;
+}
+
+void record_perf_frame(perf_hud *hud, int64_t presented_time, size_t bytes)
+{
+    // The first frame has nothing to be measured from
+    if (hud->last_frame_time != 0)
+    {
+        hud->latest[PERF_STAGE_FRAME] = presented_time - hud->last_frame_time;
+        record_histogram(&hud->stages[PERF_STAGE_FRAME], presented_time - hud->last_frame_time);
+    }
+
+    hud->last_frame_time = presented_time;
+    hud->latest_bytes = bytes;
+    hud->total_bytes += bytes;
+}
+
+void draw_perf_hud(const perf_hud *hud,
+                   char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    char line[PERF_HUD_WIDTH + 1];
+    int row = 0;
+
+    snprintf(line, sizeof(line), "%-10s %11s %11s %11s", "time (us)", "current", "p50", "p99");
+    draw_hud_line(terminal_display[row++], line);
+
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++)
+    {
+        const histogram *values = &hud->stages[stage];
+
+        snprintf(line, sizeof(line), "%-10s %11.1f %11.1f %11.1f", stage_names[stage],
+                 hud->latest[stage] / NANOSECONDS_PER_MICROSECOND,
+                 get_histogram_percentile(values, 50.0) / NANOSECONDS_PER_MICROSECOND,
+                 get_histogram_percentile(values, 99.0) / NANOSECONDS_PER_MICROSECOND);
+        draw_hud_line(terminal_display[row++], line);
+    }
+
+    uint64_t frames = hud->stages[PERF_STAGE_OUTPUT].count;
+
+    snprintf(line, sizeof(line), "%-10s %11zu %11.1f  dropped %llu", "bytes", hud->latest_bytes,
+             frames > 0 ? (double)hud->total_bytes / (double)frames : 0.0,
+             (unsigned long long)hud->dropped_frames);
+    draw_hud_line(terminal_display[row], line);
+}
+
+void print_perf_hud(FILE *stream, const perf_hud *hud)
+{
+    uint64_t frames = hud->stages[PERF_STAGE_OUTPUT].count;
+
+    for (int stage = 0; stage < PERF_STAGE_COUNT; stage++)
+    {
+        print_histogram(stream, stage_names[stage], &hud->stages[stage]);
+    }
+
+    fprintf(stream, "bytes: %llu written, %.1f per frame; dropped %llu frames\n",
+            (unsigned long long)hud->total_bytes,
+            frames > 0 ? (double)hud->total_bytes / (double)frames : 0.0,
+            (unsigned long long)hud->dropped_frames);
+}
+
+// End of perf_hud.c
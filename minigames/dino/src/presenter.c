@@ -0,0 +1,257 @@
+/**************************************************************************************************/
+/**
+ * @file presenter.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Cell-diff frame presenter. Keeps the last frame shown on the terminal and sends only
+ *        the cells that changed since then.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "presenter.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define SYNCHRONIZED_UPDATE_BEGIN   "\033[?2026h"
+#define SYNCHRONIZED_UPDATE_END     "\033[?2026l"
+#define FULL_REDRAW_PREFIX          "\033[?25l\033[H\033[2J"   // Hide cursor, home, clear screen
+
+// A row diff is never longer than one cursor position plus a rewrite of the whole row
+#define ROW_OUTPUT_CAPACITY         (TERMINAL_DISPLAY_WIDTH + 32)
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    append_cursor_position
+ * @brief   Appends the escape sequence that moves the cursor to a zero-based row and column.
+ *
+ * @param   output
+ * @param   row
+ * @param   column
+ *
+ * @return  size_t  Number of bytes appended
+ */
+/**************************************************************************************************/
+static size_t append_cursor_position(char *output, int row, int column);
+
+/**************************************************************************************************/
+/**
+ * @name    encode_row_diff
+ * @brief   Appends the bytes that turn shown_row into target_row. Runs of unchanged cells between
+ *          changes are skipped with a cursor-forward sequence, or rewritten when that is shorter.
+ *
+ * @param   output
+ * @param   row             Zero-based row index on the terminal
+ * @param   shown_row       Cells currently on the terminal
+ * @param   target_row      Cells to display
+ * @param   cursor_column   Column of the cursor if it is already on this row, otherwise -1
+ *
+ * @return  size_t  Number of bytes appended
+ */
+/**************************************************************************************************/
+static size_t encode_row_diff(char *output, int row, const char *shown_row,
+                              const char *target_row, int cursor_column);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static size_t append_cursor_position(char *output, int row, int column)
+{
+    return (size_t)sprintf(output, "\033[%d;%dH", row + 1, column + 1);
+}
+
+static size_t encode_row_diff(char *output, int row, const char *shown_row,
+                              const char *target_row, int cursor_column)
+{
+    size_t length = 0;
+
+    for (int column = 0; column < TERMINAL_DISPLAY_WIDTH; column++)
+    {
+        if (shown_row[column] == target_row[column])
+        {
+            continue;
+        }
+
+        if (cursor_column != column)
+        {
+            int gap = column - cursor_column;
+
+            if (cursor_column >= 0 && gap > 0)
+            {
+                char cursor_forward[16];
+                int cursor_forward_length = sprintf(cursor_forward, "\033[%dC", gap);
+
+                if (gap <= cursor_forward_length)
+                {
+                    // Unchanged cells are identical in both rows, so rewriting them is harmless
+                    memcpy(output + length, target_row + cursor_column, gap);
+                    length += gap;
+                }
+                else
+                {
+                    memcpy(output + length, cursor_forward, cursor_forward_length);
+                    length += cursor_forward_length;
+                }
+            }
+            else
+            {
+                length += append_cursor_position(output + length, row, column);
+            }
+        }
+
+        output[length++] = target_row[column];
+        cursor_column = column + 1;
+    }
+
+    return length;
+}
+
+void initialize_presenter(frame_presenter *presenter, const char *footer)
+{
+    snprintf(presenter->footer, sizeof(presenter->footer), "%s", footer != NULL ? footer : "");
+    presenter->output_length = 0;
+    invalidate_presenter(presenter);
+}
+
+void invalidate_presenter(frame_presenter *presenter)
+{
+    presenter->needs_full_redraw = true;
+}
+
+size_t encode_frame_delta(frame_presenter *presenter,
+                          const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    char *output = presenter->output;
+    size_t length = 0;
+    bool full_redraw = presenter->needs_full_redraw;
+
+    memcpy(output, SYNCHRONIZED_UPDATE_BEGIN, strlen(SYNCHRONIZED_UPDATE_BEGIN));
+    length += strlen(SYNCHRONIZED_UPDATE_BEGIN);
+    size_t empty_update_length = length;
+
+    if (full_redraw)
+    {
+        // After clearing, the terminal holds a blank frame and only non-blank cells are sent
+        memcpy(output + length, FULL_REDRAW_PREFIX, strlen(FULL_REDRAW_PREFIX));
+        length += strlen(FULL_REDRAW_PREFIX);
+        memset(presenter->presented_frame, ' ', sizeof(presenter->presented_frame));
+        presenter->needs_full_redraw = false;
+    }
+
+    for (int row = 0; row < TERMINAL_DISPLAY_HEIGHT; row++)
+    {
+        const char *shown_row = presenter->presented_frame[row];
+        const char *target_row = frame[row];
+
+        if (memcmp(shown_row, target_row, TERMINAL_DISPLAY_WIDTH) == 0)
+        {
+            continue;
+        }
+
+        char best_row_output[ROW_OUTPUT_CAPACITY];
+        size_t best_row_length = encode_row_diff(best_row_output, row, shown_row, target_row, -1);
+
+        for (int shift = 1; shift <= PRESENTER_MAX_ROW_SHIFT; shift++)
+        {
+            char shifted_row[TERMINAL_DISPLAY_WIDTH];
+            char candidate_output[ROW_OUTPUT_CAPACITY];
+
+            // Deleting characters at the start of the row pulls the rest left and blanks the end
+            memcpy(shifted_row, shown_row + shift, TERMINAL_DISPLAY_WIDTH - shift);
+            memset(shifted_row + TERMINAL_DISPLAY_WIDTH - shift, ' ', shift);
+
+            size_t candidate_length = append_cursor_position(candidate_output, row, 0);
+            candidate_length += sprintf(candidate_output + candidate_length, "\033[%dP", shift);
+
+            if (candidate_length >= best_row_length)
+            {
+                break; // Larger shifts only have longer prefixes
+            }
+
+            candidate_length += encode_row_diff(candidate_output + candidate_length, row,
+                                                shifted_row, target_row, 0);
+
+            if (candidate_length < best_row_length)
+            {
+                memcpy(best_row_output, candidate_output, candidate_length);
+                best_row_length = candidate_length;
+            }
+        }
+
+        memcpy(output + length, best_row_output, best_row_length);
+        length += best_row_length;
+        memcpy(presenter->presented_frame[row], target_row, TERMINAL_DISPLAY_WIDTH);
+    }
+
+    if (full_redraw && presenter->footer[0] != '\0')
+    {
+        length += append_cursor_position(output + length, TERMINAL_DISPLAY_HEIGHT + 1, 0);
+        memcpy(output + length, presenter->footer, strlen(presenter->footer));
+        length += strlen(presenter->footer);
+    }
+
+    if (length == empty_update_length)
+    {
+        presenter->output_length = 0;
+        return 0;
+    }
+
+    memcpy(output + length, SYNCHRONIZED_UPDATE_END, strlen(SYNCHRONIZED_UPDATE_END));
+    length += strlen(SYNCHRONIZED_UPDATE_END);
+
+    presenter->output_length = length;
+    return length;
+}
+
+int present_frame(frame_presenter *presenter,
+                  const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    size_t length = encode_frame_delta(presenter, frame);
+    size_t written = 0;
+
+    while (written < length)
+    {
+        ssize_t result = write(STDOUT_FILENO, presenter->output + written, length - written);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            invalidate_presenter(presenter); // The terminal state is unknown now
+            return -1;
+        }
+        written += (size_t)result;
+    }
+
+    return 0;
+}
+
+// End of presenter.c
@@ -0,0 +1,69 @@
+/**************************************************************************************************/
+/**
+ * @file prng.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Small seeded PCG32 generator. Each subsystem carries its own, so a seed reproduces a
+ *        game exactly and subsystems never disturb each other's sequences.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include "prng.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define PCG_MULTIPLIER  6364136223846793005ULL
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+void seed_prng(prng *generator, uint64_t seed, uint64_t stream)
+{
+    generator->state = 0;
+    generator->increment = (stream << 1) | 1;
+    next_prng(generator);
+    generator->state += seed;
+    next_prng(generator);
+}
+
+uint32_t next_prng(prng *generator)
+{
+    uint64_t state = generator->state;
+    generator->state = state * PCG_MULTIPLIER + generator->increment;
+
+    // XSH RR output: xorshift the high bits down, then rotate by the top five bits
+    uint32_t shifted = (uint32_t)(((state >> 18) ^ state) >> 27);
+    uint32_t rotation = (uint32_t)(state >> 59);
+    return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+}
+
+int prng_below(prng *generator, int bound)
+{
+    return (int)(((uint64_t)next_prng(generator) * (uint32_t)bound) >> 32);
+}
+
+// End of prng.c
@@ -16,220 +16,467 @@
 /* HEADERS                                                                                        */
 /*------------------------------------------------------------------------------------------------*/
 
+#include <math.h>
+#include <string.h>
+
 #include "render.h"
 #include "sprites.h"
 #include "background.h"
+#include "presenter.h"
+#include "texture_cache.h"
 
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
 /*------------------------------------------------------------------------------------------------*/
 
+#define CELL_VECTOR_BYTES   16
 
+// Table of 8-bit masks spread to 8-byte lane masks, built by the preprocessor
+#define BYTE_LANE(b, i)     ((uint64_t)((b) >> (i) & 1) * (UINT64_C(0xff) << (8 * (i))))
+#define BYTE_LANES(b)       (BYTE_LANE(b, 0) | BYTE_LANE(b, 1) | BYTE_LANE(b, 2) | \
+                             BYTE_LANE(b, 3) | BYTE_LANE(b, 4) | BYTE_LANE(b, 5) | \
+                             BYTE_LANE(b, 6) | BYTE_LANE(b, 7))
+#define BYTE_LANES_4(b)     BYTE_LANES(b), BYTE_LANES((b) + 1), BYTE_LANES((b) + 2), \
+                            BYTE_LANES((b) + 3)
+#define BYTE_LANES_16(b)    BYTE_LANES_4(b), BYTE_LANES_4((b) + 4), BYTE_LANES_4((b) + 8), \
+                            BYTE_LANES_4((b) + 12)
+#define BYTE_LANES_64(b)    BYTE_LANES_16(b), BYTE_LANES_16((b) + 16), BYTE_LANES_16((b) + 32), \
+                            BYTE_LANES_16((b) + 48)
 
 /*------------------------------------------------------------------------------------------------*/
 /* GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
 
+// GCC/Clang vector extension: lowered to SSE2 on x86 and NEON on ARM
+typedef unsigned char cell_vector __attribute__((vector_size(CELL_VECTOR_BYTES)));
+typedef uint64_t cell_word_vector __attribute__((vector_size(CELL_VECTOR_BYTES)));
 
+// Byte i of byte_lanes[b] is all ones if bit i of b is set: 8 coverage bits as 8 blend lanes
+static const uint64_t byte_lanes[256] = {
+    BYTE_LANES_64(0), BYTE_LANES_64(64), BYTE_LANES_64(128), BYTE_LANES_64(192)
+};
 
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION PROTOTYPES                                                                            */
 /*------------------------------------------------------------------------------------------------*/
 
+/**************************************************************************************************/
+/**
+ * @name    copy_masked_row
+ * @brief   Copies the cells of one row whose coverage-layout bits are set. Every 16 cells are one
+ *          vector blend, with their 16 bits spread into a byte mask. The last vector is aligned
+ *          to the end of the row and may overlap the one before it, which is harmless since a
+ *          blend applied twice gives the same cells, so nothing past the row is touched.
+ *
+ * @param   destination     First cell of the row
+ * @param   source          Cells to copy from, TERMINAL_DISPLAY_WIDTH of them
+ * @param   mask            Bit c % 64 of word c / 64 set to copy cell c
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void copy_masked_row(char *destination, const char *source,
+                            const uint64_t mask[COVERAGE_WORDS]);
 
+/**************************************************************************************************/
+/**
+ * @name    copy_opaque_row
+ * @brief   Copies the non-blank cells of one row, a vector compare and blend per 16 cells, with
+ *          the last vector aligned to the end of the row like copy_masked_row.
+ *
+ * @param   destination     First cell of the row
+ * @param   source          Cells to copy from, TERMINAL_DISPLAY_WIDTH of them
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void copy_opaque_row(char *destination, const char *source);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_cells
+ * @brief   Draws a run of opaque cells into one row, skipping the ones already covered. The
+ *          coverage of up to 64 cells is tested at once, so an uncovered run is one memcpy.
+ *
+ * @param   terminal_display
+ * @param   coverage
+ * @param   row
+ * @param   column      First column, on screen
+ * @param   cells
+ * @param   length      Number of cells, all on screen
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void draw_cells(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                       frame_coverage *coverage, int row, int column, const char *cells,
+                       int length);
+
+/**************************************************************************************************/
+/**
+ * @name    get_strip_opacity
+ * @brief   Returns the opacity bits of 64 consecutive strip cells starting at a ring column.
+ *
+ * @param   strip
+ * @param   row
+ * @param   column      Ring column, wrapped here
+ *
+ * @return  uint64_t
+ */
+/**************************************************************************************************/
+static uint64_t get_strip_opacity(const layer_strip *strip, int row, int column);
+
+/**************************************************************************************************/
+/**
+ * @name    fill_uncovered
+ * @brief   Copies the static frame into every cell nothing else covered, completing the frame.
+ *
+ * @param   terminal_display
+ * @param   coverage
+ * @param   static_frame
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void fill_uncovered(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                           frame_coverage *coverage,
+                           const char static_frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
 
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION DEFINITIONS                                                                           */
 /*------------------------------------------------------------------------------------------------*/
 
-void draw_object(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
-                      const ascii_object *sprite, int x, int y)
+static void copy_masked_row(char *destination, const char *source,
+                            const uint64_t mask[COVERAGE_WORDS])
 {
-    for (int row = 0; row < sprite->height; row++)
+    // Branch-free: which cells are covered is different in every row, so tests on the mask
+    // would mispredict more often than the blend costs
+    for (int column = 0; column < TERMINAL_DISPLAY_WIDTH; column += CELL_VECTOR_BYTES)
     {
-        for (int col = 0; col < sprite->width; col++)
+        if (column > TERMINAL_DISPLAY_WIDTH - CELL_VECTOR_BYTES)
         {
-            // Check bounds and draw character
-            if (y + row >= 0 && y + row < TERMINAL_DISPLAY_HEIGHT &&
-                x + col >= 0 && x + col < TERMINAL_DISPLAY_WIDTH)
-            {
-                char ch = sprite->lines[row][col];
-                // Only draw non-space characters to allow transparency
-                if (ch != ' ')
-                {
-                    terminal_display[y + row][x + col] = ch;
-                }
-            }
+            column = TERMINAL_DISPLAY_WIDTH - CELL_VECTOR_BYTES;
+        }
+
+        int word = column / COVERAGE_WORD_BITS;
+        int shift = column % COVERAGE_WORD_BITS;
+        uint64_t bits = mask[word] >> shift;
+        if (shift > COVERAGE_WORD_BITS - CELL_VECTOR_BYTES && word + 1 < COVERAGE_WORDS)
+        {
+            bits |= mask[word + 1] << (COVERAGE_WORD_BITS - shift);
         }
+
+        // Lanes 0-7 from the low byte, 8-15 from the high byte
+        cell_word_vector spread = { byte_lanes[bits & 0xff], byte_lanes[bits >> 8 & 0xff] };
+        cell_vector lanes = (cell_vector)spread;
+        cell_vector cells, kept;
+
+        memcpy(&cells, source + column, sizeof(cells));
+        memcpy(&kept, destination + column, sizeof(kept));
+        kept = (cells & lanes) | (kept & ~lanes);
+        memcpy(destination + column, &kept, sizeof(kept));
     }
 }
 
-void draw_sprite(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH], sprite *character)
+static void copy_opaque_row(char *destination, const char *source)
 {
-    // Human-like sprite
-
-        // (n_n)
-        // {   }
-        //  ` `
-
-    //
+    const cell_vector blank = { ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ' };
 
-        // Row 0: (n_n)
-    if (character->y >= 0 && character->y < TERMINAL_DISPLAY_HEIGHT) {
-        if (character->x < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y][character->x] = '(';
-        }
-        if (character->x + 1 < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y][character->x + 1] = 'n';
-        }
-        if (character->x + 2 < TERMINAL_DISPLAY_WIDTH) terminal_display[character->y][character->x + 2] = '_';
-        {
-            terminal_display[character->y][character->x + 2] = '_';
-        }
-        if (character->x + 3 < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y][character->x + 3] = 'n';
-        }
-        if (character->x + 4 < TERMINAL_DISPLAY_WIDTH)
+    for (int column = 0; column < TERMINAL_DISPLAY_WIDTH; column += CELL_VECTOR_BYTES)
+    {
+        if (column > TERMINAL_DISPLAY_WIDTH - CELL_VECTOR_BYTES)
         {
-            terminal_display[character->y][character->x + 4] = ')';
+            column = TERMINAL_DISPLAY_WIDTH - CELL_VECTOR_BYTES;
         }
+
+        cell_vector cells, kept;
+
+        memcpy(&cells, source + column, sizeof(cells));
+        memcpy(&kept, destination + column, sizeof(kept));
+
+        cell_vector opaque = cells != blank;   // All ones where the source has content
+        kept = (cells & opaque) | (kept & ~opaque);
+        memcpy(destination + column, &kept, sizeof(kept));
     }
+}
 
-    // Row 1: {   }
-    if (character->y + 1 >= 0 && character->y + 1 < TERMINAL_DISPLAY_HEIGHT) {
-        if (character->x < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y + 1][character->x] = '{';
-        }
-        if (character->x + 1 < TERMINAL_DISPLAY_WIDTH)
+static void draw_cells(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                       frame_coverage *coverage, int row, int column, const char *cells,
+                       int length)
+{
+    uint64_t *words = coverage->rows[row];
+
+    while (length > 0)
+    {
+        int piece_length = length < COVERAGE_WORD_BITS ? length : COVERAGE_WORD_BITS;
+        uint64_t piece = piece_length < COVERAGE_WORD_BITS
+                             ? (UINT64_C(1) << piece_length) - 1
+                             : UINT64_MAX;
+        int word = column / COVERAGE_WORD_BITS;
+        int shift = column % COVERAGE_WORD_BITS;
+        bool straddles = shift != 0 && word + 1 < COVERAGE_WORDS;
+
+        // Line the coverage up with the piece's cells
+        uint64_t covered = words[word] >> shift;
+        if (straddles)
         {
-            terminal_display[character->y + 1][character->x + 1] = ' ';
+            covered |= words[word + 1] << (COVERAGE_WORD_BITS - shift);
         }
-        if (character->x + 2 < TERMINAL_DISPLAY_WIDTH)
+        covered &= piece;
+
+        uint64_t visible = piece & ~covered;
+        coverage->cells_written += (uint32_t)__builtin_popcountll(visible);
+        if (covered == 0)
         {
-            terminal_display[character->y + 1][character->x + 2] = ' ';
+            memcpy(terminal_display[row] + column, cells, (size_t)piece_length);
         }
-        if (character->x + 3 < TERMINAL_DISPLAY_WIDTH)
+        else
         {
-            terminal_display[character->y + 1][character->x + 3] = ' ';
+            // Only where objects overlap each other, so one cell at a time is fine
+            for (int cell = 0; cell < piece_length; cell++)
+            {
+                if (visible >> cell & 1)
+                {
+                    terminal_display[row][column + cell] = cells[cell];
+                }
+            }
+            coverage->cells_hidden += (uint32_t)__builtin_popcountll(covered);
         }
-        if (character->x + 4 < TERMINAL_DISPLAY_WIDTH)
+
+        words[word] |= visible << shift;
+        if (straddles)
         {
-            terminal_display[character->y + 1][character->x + 4] = '}';
+            words[word + 1] |= visible >> (COVERAGE_WORD_BITS - shift);
         }
+
+        column += piece_length;
+        cells += piece_length;
+        length -= piece_length;
     }
-    // Row 2:  ` `
-    if (character->y + 2 >= 0 && character->y + 2 < TERMINAL_DISPLAY_HEIGHT) {
-        if (character->x < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y + 2][character->x] = ' ';
-        }
-        if (character->x + 1 < TERMINAL_DISPLAY_WIDTH)
-        {
-            terminal_display[character->y + 2][character->x + 1] = '`';
-        }
-        if (character->x + 2 < TERMINAL_DISPLAY_WIDTH)
+}
+
+static uint64_t get_strip_opacity(const layer_strip *strip, int row, int column)
+{
+    int ring_column = column & LAYER_STRIP_MASK;
+    int word = ring_column / 64;
+    int shift = ring_column % 64;
+    uint64_t opacity = strip->opaque[row][word] >> shift;
+
+    if (shift != 0)
+    {
+        opacity |= strip->opaque[row][(word + 1) % LAYER_STRIP_WORDS] << (64 - shift);
+    }
+
+    return opacity;
+}
+
+static void fill_uncovered(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                           frame_coverage *coverage,
+                           const char static_frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    for (int row = 0; row < TERMINAL_DISPLAY_HEIGHT; row++)
+    {
+        uint64_t uncovered[COVERAGE_WORDS];
+        uint64_t any_covered = 0;
+
+        for (int word = 0; word < COVERAGE_WORDS; word++)
         {
-            terminal_display[character->y + 2][character->x + 2] = ' ';
+            uncovered[word] = ~coverage->rows[row][word] & get_coverage_word_mask(word);
+            any_covered |= coverage->rows[row][word];
+            coverage->rows[row][word] |= uncovered[word];
+            coverage->cells_written += (uint32_t)__builtin_popcountll(uncovered[word]);
         }
-        if (character->x + 3 < TERMINAL_DISPLAY_WIDTH)
+
+        // Most sky rows are empty and take one fixed-size copy
+        if (any_covered == 0)
         {
-            terminal_display[character->y + 2][character->x + 3] = '`';
+            memcpy(terminal_display[row], static_frame[row], TERMINAL_DISPLAY_WIDTH);
         }
-        if (character->x + 4 < TERMINAL_DISPLAY_WIDTH)
+        else
         {
-            terminal_display[character->y + 2][character->x + 4] = ' ';
+            copy_masked_row(terminal_display[row], static_frame[row], uncovered);
         }
     }
 }
 
-void render(sprite *character, background_system *background)
+void draw_object(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                 frame_coverage *coverage, const compiled_ascii_object *texture, int x, int y)
 {
-    char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
+    // Clip the texture's rectangle against the screen once, in texture coordinates
+    int first_row = y < 0 ? -y : 0;
+    int end_row = TERMINAL_DISPLAY_HEIGHT - y < texture->height ? TERMINAL_DISPLAY_HEIGHT - y
+                                                                : texture->height;
+    int clip_left = x < 0 ? -x : 0;
+    int clip_right = TERMINAL_DISPLAY_WIDTH - x < texture->width ? TERMINAL_DISPLAY_WIDTH - x
+                                                                 : texture->width;
+
+    if (first_row >= end_row || clip_left >= clip_right)
+    {
+        return;
+    }
 
-    // Initialize terminal display with spaces
-    for (int y = 0; y < TERMINAL_DISPLAY_HEIGHT; y++)
+    for (int row = first_row; row < end_row; row++)
     {
-        for (int x = 0; x < TERMINAL_DISPLAY_WIDTH; x++)
+        const ascii_span *span = texture->spans + texture->row_first_span[row];
+        const ascii_span *row_end = texture->spans + texture->row_first_span[row + 1];
+
+        for (; span < row_end; span++)
         {
-            terminal_display[y][x] = ' ';
+            int start = span->offset > clip_left ? span->offset : clip_left;
+            int end = span->offset + span->length < clip_right ? span->offset + span->length
+                                                               : clip_right;
+
+            if (start < end)
+            {
+                draw_cells(terminal_display, coverage, y + row, x + start,
+                           span->characters + (start - span->offset), end - start);
+            }
         }
     }
+}
 
-    // Draw ground
-    for (int x = 0; x < TERMINAL_DISPLAY_WIDTH; x++)
-    {
-        terminal_display[TERMINAL_DISPLAY_HEIGHT - 1][x] = '=';
-    }
+void draw_layer_strip(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                      frame_coverage *coverage, const layer_strip *strip, float interpolation)
+{
+    // Step back by the part of the last tick's scroll that has not happened yet at this instant
+    float column_offset = strip->scroll_fraction -
+                          (1.0f - interpolation) * strip->last_scroll_distance;
+    const int start = (strip->scroll_column + (int)floorf(column_offset)) & LAYER_STRIP_MASK;
 
-    // Draw background mountain base
-    for (int x = 0; x < TERMINAL_DISPLAY_WIDTH; x++)
+    for (int row = strip->top_row; row < strip->bottom_row; row++)
     {
-        terminal_display[TERMINAL_DISPLAY_HEIGHT - 11][x] = '.';
-    }
+        // The apron makes the window contiguous even when it wraps around the ring
+        const char *window = strip->cells[row] + start;
+        uint64_t opaque[COVERAGE_WORDS];
+        uint64_t any_covered = 0;
 
-    // Draw parallax layers
-    for (int layer = 0; layer < NUM_LAYERS; layer++)
-    {
-        for (int i = 0; i < background->layers[layer].element_count; i++)
+        for (int word = 0; word < COVERAGE_WORDS; word++)
         {
-            int element_x = (int)background->layers[layer].elements[i].x;
-            const ascii_object *texture = background->layers[layer].elements[i].texture;
+            opaque[word] = get_strip_opacity(strip, row, start + word * COVERAGE_WORD_BITS) &
+                           get_coverage_word_mask(word);
+            any_covered |= coverage->rows[row][word];
+        }
 
-            int element_y = 0;
-            if (layer == LAYER_CLOUDS)
-            {
-                element_y = 5 + (i % 3) * 3;
-            }
-            else if (layer ==  LAYER_MOUNTAINS)
-            {
-                element_y = TERMINAL_DISPLAY_HEIGHT - texture->height - 10;
-            }
-            else if (layer == LAYER_HOUSES)
+        // Rows with nothing in front of them, most of them, blend on the strip's own blanks
+        if (any_covered == 0)
+        {
+            copy_opaque_row(terminal_display[row], window);
+            for (int word = 0; word < COVERAGE_WORDS; word++)
             {
-                element_y = TERMINAL_DISPLAY_HEIGHT - texture->height - 3;
+                coverage->rows[row][word] = opaque[word];
+                coverage->cells_written += (uint32_t)__builtin_popcountll(opaque[word]);
             }
-            else // Most closse layer (trees)
+            continue;
+        }
+
+        for (int word = 0; word < COVERAGE_WORDS; word++)
+        {
+            uint64_t hidden = opaque[word] & coverage->rows[row][word];
+
+            if (hidden != 0)
             {
-                element_y = TERMINAL_DISPLAY_HEIGHT - texture->height - 1;
+                coverage->cells_hidden += (uint32_t)__builtin_popcountll(hidden);
             }
-
-            draw_object(terminal_display, texture, element_x, element_y);
+            opaque[word] &= ~coverage->rows[row][word];
+            coverage->rows[row][word] |= opaque[word];
+            coverage->cells_written += (uint32_t)__builtin_popcountll(opaque[word]);
         }
+
+        copy_masked_row(terminal_display[row], window, opaque);
     }
+}
+
+void draw_obstacles(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                    frame_coverage *coverage, const obstacle_system *obstacles,
+                    float interpolation)
+{
+    const entity_store *entities = &obstacles->entities;
 
-    // Draw background particles (scrolling dust/dots)
-    for (int y = 0; y < TERMINAL_DISPLAY_HEIGHT - 1; y++)
+    // Later obstacles are in front of earlier ones, so they claim their cells first
+    for (int entity = entities->slot_count - 1; entity >= 0; entity--)
     {
-        if (y % 4 == 0)
+        if (entities->layer[entity] != OBSTACLE_LAYER)
         {
-            int particle_x = (int)background->particle_positions[y];
-            if (particle_x >= 0 && particle_x < TERMINAL_DISPLAY_WIDTH)
-            {
-                terminal_display[y][particle_x] = '.';
-            }
+            continue;
         }
 
+        texture_id texture = (texture_id)entities->texture[entity];
+        float x = entities->x[entity] + (1.0f - interpolation) * obstacles->last_scroll_speed *
+                                        entities->speed[entity];
+
+        draw_object(terminal_display, coverage, get_texture(texture), (int)floorf(x),
+                    get_obstacle_row(texture));
+    }
+}
+
+void draw_sprite(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                 frame_coverage *coverage, sprite *character, float interpolation)
+{
+    float y = character->previous_y + (character->y - character->previous_y) * interpolation;
+
+    draw_object(terminal_display, coverage, get_texture(TEXTURE_PLAYER), character->x,
+                (int)lroundf(y));
+}
+
+void compose_frame(char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH],
+                   sprite *character, background_system *background,
+                   const obstacle_system *obstacles, float interpolation, compose_stats *stats)
+{
+    frame_coverage coverage;
+
+    memset(&coverage, 0, sizeof(coverage));
+
+    // Front to back: each cell takes the first thing drawn over it and is never written again
+    draw_sprite(terminal_display, &coverage, character, interpolation);
+    draw_obstacles(terminal_display, &coverage, obstacles, interpolation);
+    draw_particles(terminal_display, &coverage, &background->particles, interpolation);
+
+    for (int layer = NUM_LAYERS - 1; layer >= 0; layer--)
+    {
+        draw_layer_strip(terminal_display, &coverage, &background->layers[layer].strip,
+                         interpolation);
+    }
+
+    // Whatever is left shows the rows that never change: sky, ground and mountain base
+    fill_uncovered(terminal_display, &coverage,
+                   (const char (*)[TERMINAL_DISPLAY_WIDTH])background->static_frame);
+
+    if (stats != NULL)
+    {
+        stats->frames++;
+        stats->cells_written += coverage.cells_written;
+        stats->cells_hidden += coverage.cells_hidden;
     }
+}
 
-    draw_sprite(terminal_display, character);
+void render(sprite *character, background_system *background, const obstacle_system *obstacles,
+            float interpolation, frame_presenter *presenter, asciicast_recorder *recorder,
+            perf_hud *hud, spectator_server *spectators)
+{
+    char terminal_display[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH];
 
-    clear_terminal_screen();
+    int64_t stage_time = start_perf_stage(hud);
+    compose_frame(terminal_display, character, background, obstacles, interpolation, NULL);
+    end_perf_stage(hud, PERF_STAGE_COMPOSE, stage_time);
 
-    for (int y = 0; y < TERMINAL_DISPLAY_HEIGHT; y++)
+    // Recordings and viewers see the game, never the overlay
+    asciicast_recorder_push_frame(recorder, &terminal_display[0][0]);
+
+    if (spectators != NULL)
     {
-        for (int x = 0; x < TERMINAL_DISPLAY_WIDTH; x++)
-        {
-            putchar(terminal_display[y][x]);
-        }
-        putchar('\n');
+        publish_spectator_frame(spectators,
+                                (const char (*)[TERMINAL_DISPLAY_WIDTH])terminal_display);
+    }
+
+    if (hud != NULL && hud->visible)
+    {
+        draw_perf_hud(hud, terminal_display);
     }
 
-    printf("\nPress SPACE to jump | Press Q to quit\n");
-    fflush(stdout); // fflush stdout to ensure immediate display
+    stage_time = start_perf_stage(hud);
+    present_frame(presenter, (const char (*)[TERMINAL_DISPLAY_WIDTH])terminal_display);
+    end_perf_stage(hud, PERF_STAGE_OUTPUT, stage_time);
 }
 
-// End of render.c
\ No newline at end of file
+// End of render.c
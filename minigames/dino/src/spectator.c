@@ -0,0 +1,796 @@
+/**************************************************************************************************/
+/**
+ * @file spectator.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Streams the live game to viewers on a Unix domain socket. The game thread only hands
+ *        composed frames over; a server thread delta-encodes each one once and fans it out to
+ *        every viewer from an epoll loop.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef __linux__
+#define _GNU_SOURCE     // accept4
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#endif
+
+#include "spectator.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define SPECTATOR_LISTEN_BACKLOG    16
+#define SPECTATOR_MAX_EVENTS        32
+#define SPECTATOR_SOCKET_MODE       0666    // Any local user may watch
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Encoded frame, shared by every viewer it is queued for and freed when the last is done with it
+ * - references: queues holding it, plus one held by the fan-out that encoded it
+ * - length, bytes: terminal output
+ */
+typedef struct
+{
+    int references;
+    size_t length;
+    char bytes[];
+} spectator_frame;
+
+/**
+ * Connected viewer
+ * - descriptor: its socket, non-blocking; -1 once closed
+ * - queue, queue_head, queue_count: frames not fully sent yet, oldest first
+ * - sent: bytes of the oldest queued frame already sent
+ * - needs_keyframe: set until a full redraw is queued, when joining or after falling behind
+ * - waiting: whether epoll also watches for the socket becoming writable
+ * - previous, next: neighbours in the server's list of clients, or of closed clients
+ */
+struct spectator_client
+{
+    int descriptor;
+    spectator_frame *queue[SPECTATOR_CLIENT_QUEUE];
+    int queue_head;
+    int queue_count;
+    size_t sent;
+    bool needs_keyframe;
+    bool waiting;
+    spectator_client *previous;
+    spectator_client *next;
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef __linux__
+
+/**************************************************************************************************/
+/**
+ * @name    create_frame
+ * @brief   Copies encoded output into a new shared frame holding one reference.
+ *
+ * @param   bytes
+ * @param   length
+ *
+ * @return  spectator_frame*    NULL if memory ran out
+ */
+/**************************************************************************************************/
+static spectator_frame *create_frame(const char *bytes, size_t length);
+
+/**************************************************************************************************/
+/**
+ * @name    release_frame
+ * @brief   Drops one reference to a frame, freeing it with the last.
+ *
+ * @param   frame
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void release_frame(spectator_frame *frame);
+
+/**************************************************************************************************/
+/**
+ * @name    queue_frame
+ * @brief   Appends a frame to a viewer's queue, which must have room, taking a reference.
+ *
+ * @param   client
+ * @param   frame
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void queue_frame(spectator_client *client, spectator_frame *frame);
+
+/**************************************************************************************************/
+/**
+ * @name    drop_backlog
+ * @brief   Empties a viewer's queue except for a frame it is partway through, which must be
+ *          finished so the terminal is not left inside an escape sequence.
+ *
+ * @param   client
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void drop_backlog(spectator_client *client);
+
+/**************************************************************************************************/
+/**
+ * @name    watch_client
+ * @brief   Sets whether epoll reports the viewer's socket becoming writable.
+ *
+ * @param   server
+ * @param   client
+ * @param   writable
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void watch_client(spectator_server *server, spectator_client *client, bool writable);
+
+/**************************************************************************************************/
+/**
+ * @name    close_client
+ * @brief   Disconnects a viewer and releases its queue. The client moves to the closed list and
+ *          is freed after the current batch of events, which may still mention it.
+ *
+ * @param   server
+ * @param   client
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void close_client(spectator_server *server, spectator_client *client);
+
+/**************************************************************************************************/
+/**
+ * @name    free_closed_clients
+ * @brief   Frees the clients closed since the last call.
+ *
+ * @param   server
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void free_closed_clients(spectator_server *server);
+
+/**************************************************************************************************/
+/**
+ * @name    flush_client
+ * @brief   Sends as much of a viewer's queue as its socket takes, with one writev per attempt
+ *          covering every queued frame. When the socket is full, epoll watches for it to drain.
+ *
+ * @param   server
+ * @param   client
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void flush_client(spectator_server *server, spectator_client *client);
+
+/**************************************************************************************************/
+/**
+ * @name    accept_clients
+ * @brief   Accepts every pending connection. New viewers get a keyframe with the next frame.
+ *
+ * @param   server
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void accept_clients(spectator_server *server);
+
+/**************************************************************************************************/
+/**
+ * @name    broadcast_frame
+ * @brief   Encodes the delta to a frame once and queues it to every viewer in sync. Viewers that
+ *          are joining, or whose queue is full, get one shared keyframe instead.
+ *
+ * @param   server
+ * @param   frame
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void broadcast_frame(spectator_server *server,
+                            const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH]);
+
+/**************************************************************************************************/
+/**
+ * @name    take_frames
+ * @brief   Broadcasts the newest frame the game handed over and frees every slot of the ring.
+ *          Older frames are skipped: the next delta covers them.
+ *
+ * @param   server
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void take_frames(spectator_server *server);
+
+/**************************************************************************************************/
+/**
+ * @name    serve
+ * @brief   Server thread: waits on the listener, the wake eventfd and every viewer until stopped.
+ *
+ * @param   argument    The spectator_server
+ *
+ * @return  void*       NULL
+ */
+/**************************************************************************************************/
+static void *serve(void *argument);
+
+/**************************************************************************************************/
+/**
+ * @name    close_server_descriptors
+ * @brief   Closes whichever of the listener, epoll and eventfd are open, and removes the socket
+ *          if it was bound.
+ *
+ * @param   server
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void close_server_descriptors(spectator_server *server);
+
+#endif
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef __linux__
+
+static spectator_frame *create_frame(const char *bytes, size_t length)
+{
+    spectator_frame *frame = malloc(sizeof(spectator_frame) + length);
+
+    if (frame != NULL)
+    {
+        frame->references = 1;
+        frame->length = length;
+        memcpy(frame->bytes, bytes, length);
+    }
+
+    return frame;
+}
+
+static void release_frame(spectator_frame *frame)
+{
+    if (--frame->references == 0)
+    {
+        free(frame);
+    }
+}
+
+static void queue_frame(spectator_client *client, spectator_frame *frame)
+{
+    int slot = (client->queue_head + client->queue_count) % SPECTATOR_CLIENT_QUEUE;
+
+    client->queue[slot] = frame;
+    client->queue_count++;
+    frame->references++;
+}
+
+static void drop_backlog(spectator_client *client)
+{
+    int kept = client->sent > 0 ? 1 : 0;
+
+    for (int i = kept; i < client->queue_count; i++)
+    {
+        release_frame(client->queue[(client->queue_head + i) % SPECTATOR_CLIENT_QUEUE]);
+    }
+    client->queue_count = kept;
+}
+
+static void watch_client(spectator_server *server, spectator_client *client, bool writable)
+{
+    struct epoll_event event = {
+        .events = EPOLLIN | (writable ? EPOLLOUT : 0),
+        .data.ptr = client
+    };
+
+    if (epoll_ctl(server->epoll, EPOLL_CTL_MOD, client->descriptor, &event) == 0)
+    {
+        client->waiting = writable;
+    }
+}
+
+static void close_client(spectator_server *server, spectator_client *client)
+{
+    // Closing the socket also removes it from the epoll set
+    close(client->descriptor);
+    client->descriptor = -1;
+
+    client->sent = 0;
+    drop_backlog(client);
+
+    if (client->previous != NULL)
+    {
+        client->previous->next = client->next;
+    }
+    else
+    {
+        server->clients = client->next;
+    }
+    if (client->next != NULL)
+    {
+        client->next->previous = client->previous;
+    }
+
+    client->previous = NULL;
+    client->next = server->closed_clients;
+    server->closed_clients = client;
+}
+
+static void free_closed_clients(spectator_server *server)
+{
+    while (server->closed_clients != NULL)
+    {
+        spectator_client *client = server->closed_clients;
+
+        server->closed_clients = client->next;
+        free(client);
+    }
+}
+
+static void flush_client(spectator_server *server, spectator_client *client)
+{
+    while (client->queue_count > 0)
+    {
+        struct iovec parts[SPECTATOR_CLIENT_QUEUE];
+
+        for (int i = 0; i < client->queue_count; i++)
+        {
+            spectator_frame *frame = client->queue[(client->queue_head + i) %
+                                                   SPECTATOR_CLIENT_QUEUE];
+            size_t skipped = i == 0 ? client->sent : 0;
+
+            parts[i].iov_base = frame->bytes + skipped;
+            parts[i].iov_len = frame->length - skipped;
+        }
+
+        ssize_t written = writev(client->descriptor, parts, client->queue_count);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                if (!client->waiting)
+                {
+                    watch_client(server, client, true);
+                }
+                return;
+            }
+
+            close_client(server, client);   // Viewer went away
+            return;
+        }
+
+        // Release every frame sent in full, and remember how far into the next one it got
+        size_t remaining = (size_t)written;
+        while (remaining > 0)
+        {
+            spectator_frame *frame = client->queue[client->queue_head];
+            size_t unsent = frame->length - client->sent;
+
+            if (remaining < unsent)
+            {
+                client->sent += remaining;
+                break;
+            }
+
+            remaining -= unsent;
+            release_frame(frame);
+            client->queue_head = (client->queue_head + 1) % SPECTATOR_CLIENT_QUEUE;
+            client->queue_count--;
+            client->sent = 0;
+        }
+    }
+
+    if (client->waiting)
+    {
+        watch_client(server, client, false);
+    }
+}
+
+static void accept_clients(spectator_server *server)
+{
+    for (;;)
+    {
+        int descriptor = accept4(server->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (descriptor < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return; // EAGAIN once every pending connection is accepted
+        }
+
+        spectator_client *client = calloc(1, sizeof(spectator_client));
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+
+        if (client == NULL ||
+            epoll_ctl(server->epoll, EPOLL_CTL_ADD, descriptor, &event) != 0)
+        {
+            free(client);
+            close(descriptor);
+            continue;
+        }
+
+        client->descriptor = descriptor;
+        client->needs_keyframe = true;
+        client->next = server->clients;
+        if (server->clients != NULL)
+        {
+            server->clients->previous = client;
+        }
+        server->clients = client;
+        server->viewers++;
+    }
+}
+
+static void broadcast_frame(spectator_server *server,
+                            const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    // With nobody watching there is no shared state to keep; the next viewer starts from a
+    // keyframe and the delta after it is taken from a full redraw
+    if (server->clients == NULL)
+    {
+        invalidate_presenter(&server->delta);
+        return;
+    }
+
+    size_t length = encode_frame_delta(&server->delta, frame);
+    spectator_frame *delta = length > 0 ? create_frame(server->delta.output, length) : NULL;
+    spectator_frame *keyframe = NULL;
+    spectator_client *next;
+
+    for (spectator_client *client = server->clients; client != NULL; client = next)
+    {
+        next = client->next;
+
+        // Queueing more would grow without bound; the backlog is replaced by one full redraw
+        if (client->queue_count == SPECTATOR_CLIENT_QUEUE)
+        {
+            drop_backlog(client);
+            server->resyncs += client->needs_keyframe ? 0 : 1;
+            client->needs_keyframe = true;
+        }
+
+        // A delta that could not be allocated is missed by everyone, who then resync
+        if (length > 0 && delta == NULL)
+        {
+            client->needs_keyframe = true;
+        }
+
+        if (client->needs_keyframe)
+        {
+            if (keyframe == NULL)
+            {
+                initialize_presenter(&server->keyframe, SPECTATOR_FOOTER);
+                size_t keyframe_length = encode_frame_delta(&server->keyframe, frame);
+                keyframe = create_frame(server->keyframe.output, keyframe_length);
+            }
+            if (keyframe != NULL)
+            {
+                queue_frame(client, keyframe);
+                client->needs_keyframe = false;
+            }
+        }
+        else if (delta != NULL)
+        {
+            queue_frame(client, delta);
+        }
+
+        flush_client(server, client);
+    }
+
+    if (delta != NULL)
+    {
+        release_frame(delta);
+    }
+    if (keyframe != NULL)
+    {
+        release_frame(keyframe);
+    }
+}
+
+static void take_frames(spectator_server *server)
+{
+    spectator_ring *ring = &server->ring;
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head == tail)
+    {
+        return;
+    }
+
+    broadcast_frame(server, (const char (*)[TERMINAL_DISPLAY_WIDTH])
+                            ring->frames[(tail - 1) & (SPECTATOR_RING_FRAMES - 1)]);
+
+    // Hands the slots back: the game's acquire load of head sees them free only after the
+    // last read of them
+    atomic_store_explicit(&ring->head, tail, memory_order_release);
+}
+
+static void *serve(void *argument)
+{
+    spectator_server *server = argument;
+    struct epoll_event events[SPECTATOR_MAX_EVENTS];
+
+    while (!atomic_load(&server->stopping))
+    {
+        int count = epoll_wait(server->epoll, events, SPECTATOR_MAX_EVENTS, -1);
+
+        if (count < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            void *owner = events[i].data.ptr;
+
+            if (owner == &server->listener)
+            {
+                accept_clients(server);
+                continue;
+            }
+
+            if (owner == &server->wake)
+            {
+                uint64_t signals;
+                ssize_t length = read(server->wake, &signals, sizeof(signals));
+                (void)length;
+
+                take_frames(server);
+                continue;
+            }
+
+            spectator_client *client = owner;
+
+            // Closed earlier in this batch
+            if (client->descriptor < 0)
+            {
+                continue;
+            }
+
+            // Viewers never send anything, so readable means hung up
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                char discarded[64];
+                ssize_t length = read(client->descriptor, discarded, sizeof(discarded));
+
+                if (length == 0 || (length < 0 && errno != EAGAIN && errno != EINTR) ||
+                    (events[i].events & (EPOLLHUP | EPOLLERR)))
+                {
+                    close_client(server, client);
+                    continue;
+                }
+            }
+
+            if (events[i].events & EPOLLOUT)
+            {
+                flush_client(server, client);
+            }
+        }
+
+        free_closed_clients(server);
+    }
+
+    return NULL;
+}
+
+static void close_server_descriptors(spectator_server *server)
+{
+    if (server->listener >= 0)
+    {
+        close(server->listener);
+        unlink(server->path);
+        server->listener = -1;
+    }
+    if (server->epoll >= 0)
+    {
+        close(server->epoll);
+        server->epoll = -1;
+    }
+    if (server->wake >= 0)
+    {
+        close(server->wake);
+        server->wake = -1;
+    }
+}
+
+int start_spectator_server(spectator_server *server, const char *path)
+{
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    struct stat status;
+
+    server->listener = -1;
+    server->epoll = -1;
+    server->wake = -1;
+    server->clients = NULL;
+    server->closed_clients = NULL;
+    server->dropped_frames = 0;
+    server->viewers = 0;
+    server->resyncs = 0;
+    atomic_init(&server->ring.head, 0);
+    atomic_init(&server->ring.tail, 0);
+    atomic_init(&server->stopping, false);
+    initialize_presenter(&server->delta, SPECTATOR_FOOTER);
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+    strcpy(server->path, path);
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (descriptor < 0)
+    {
+        return -1;
+    }
+
+    // A socket left behind by a crashed run is replaced, but not one a running game still
+    // serves, and never a file that is not a socket
+    if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool in_use = probe >= 0 &&
+                      connect(probe, (struct sockaddr *)&address, sizeof(address)) == 0;
+
+        if (probe >= 0)
+        {
+            close(probe);
+        }
+        if (in_use)
+        {
+            close(descriptor);
+            errno = EADDRINUSE;
+            return -1;
+        }
+        unlink(path);
+    }
+
+    if (bind(descriptor, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        int error = errno;
+        close(descriptor);
+        errno = error;
+        return -1;
+    }
+    server->listener = descriptor;
+
+    server->epoll = epoll_create1(EPOLL_CLOEXEC);
+    server->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    struct epoll_event listener_event = { .events = EPOLLIN, .data.ptr = &server->listener };
+    struct epoll_event wake_event = { .events = EPOLLIN, .data.ptr = &server->wake };
+
+    if (chmod(path, SPECTATOR_SOCKET_MODE) != 0 ||
+        listen(server->listener, SPECTATOR_LISTEN_BACKLOG) != 0 ||
+        server->epoll < 0 || server->wake < 0 ||
+        epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->listener, &listener_event) != 0 ||
+        epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->wake, &wake_event) != 0)
+    {
+        int error = errno;
+        close_server_descriptors(server);
+        errno = error;
+        return -1;
+    }
+
+    int error = pthread_create(&server->thread, NULL, serve, server);
+    if (error != 0)
+    {
+        close_server_descriptors(server);
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+void publish_spectator_frame(spectator_server *server,
+                             const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    spectator_ring *ring = &server->ring;
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (tail - head == SPECTATOR_RING_FRAMES)
+    {
+        server->dropped_frames++;
+        return;
+    }
+
+    memcpy(ring->frames[tail & (SPECTATOR_RING_FRAMES - 1)], frame,
+           sizeof(ring->frames[0]));
+
+    // Publishes the frame: the server's acquire load of tail sees it complete
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    // The server resets the eventfd counter on every wake, so this never blocks
+    uint64_t signal = 1;
+    ssize_t written = write(server->wake, &signal, sizeof(signal));
+    (void)written;
+}
+
+void stop_spectator_server(spectator_server *server)
+{
+    uint64_t signal = 1;
+
+    atomic_store(&server->stopping, true);
+    ssize_t written = write(server->wake, &signal, sizeof(signal));
+    (void)written;
+    pthread_join(server->thread, NULL);
+
+    while (server->clients != NULL)
+    {
+        close_client(server, server->clients);
+    }
+    free_closed_clients(server);
+    close_server_descriptors(server);
+}
+
+#else
+
+int start_spectator_server(spectator_server *server, const char *path)
+{
+    (void)server;
+    (void)path;
+    errno = ENOSYS;
+    return -1;
+}
+
+void publish_spectator_frame(spectator_server *server,
+                             const char frame[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH])
+{
+    (void)server;
+    (void)frame;
+}
+
+void stop_spectator_server(spectator_server *server)
+{
+    (void)server;
+}
+
+#endif
+
+// End of spectator.c
@@ -46,12 +46,15 @@ void initialize_sprite(sprite *character)
 {
     character->x = 10;
     character->y = TERMINAL_DISPLAY_HEIGHT - 4;
+    character->previous_y = character->y;
     character->velocity_y = 0;
     character->is_jumping = false;
 }
 
 void update_sprite_position(sprite *character)
 {
+    character->previous_y = character->y;
+
     if (character->y < TERMINAL_DISPLAY_HEIGHT - 4 || character->velocity_y < 0)
     {
         character->velocity_y += 1;
@@ -49,9 +49,11 @@ struct termios original_terminal_settings;
 void enter_alternate_screen(void) {
     printf("\033[?1049h"); // Switch to alternate screen buffer
     printf("\033[H");      // Move cursor to top-left
+    fflush(stdout);        // Frames are written with write(2), so flush before the first one
 }
 
 void exit_alternate_screen(void) {
+    printf("\033[?25h");   // Show the cursor hidden by the frame presenter
     printf("\033[?1049l"); // Switch back to main screen buffer
 }
 
@@ -0,0 +1,658 @@
+/**************************************************************************************************/
+/**
+ * @file texture_cache.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Texture identifiers and the table of compiled textures used for drawing. Textures come
+ *        from an atlas file when one is given, hot reloaded when the file changes,
+ *        and from the built-in textures compiled at build time otherwise.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include "terminal.h"
+#include "texture_cache.h"
+#include "textures.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define TEXTURE_ATLAS_PATH_LENGTH   4096
+
+// Room for a burst of inotify events; each is a header plus a NUL-padded file name
+#define TEXTURE_WATCH_BUFFER_LENGTH 4096
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * One complete set of compiled textures
+ * - textures: every texture, indexed by texture_id
+ * - owned: textures compiled from the atlas and freed with the set; the others are built-in
+ * - atlas, atlas_length: the atlas file as read when the set was loaded; the spans of the owned
+ *   textures point into its rows. NULL for the built-in set.
+ */
+typedef struct
+{
+    compiled_ascii_object textures[TEXTURE_COUNT];
+    bool owned[TEXTURE_COUNT];
+    char *atlas;
+    size_t atlas_length;
+} texture_set;
+
+// Built-in textures; always loaded, and current until an atlas replaces them
+static texture_set fallback_set;
+
+// Set get_texture reads from. Only the drawing thread touches it.
+static texture_set *current_set = &fallback_set;
+
+// Set built by the watcher and not yet made current. Ownership moves with the pointer: whoever
+// exchanges it out of here is responsible for releasing it.
+static _Atomic(texture_set *) pending_set = NULL;
+
+/**
+ * Atlas watcher thread
+ * - running: the thread has been started and not yet joined
+ * - stop_pipe: writing end is closed to wake the thread up and make it exit
+ * - directory, name: the atlas is watched through its directory, so replacing the file by rename
+ *   is seen as well as writing to it
+ */
+static struct
+{
+    bool running;
+    pthread_t thread;
+    int stop_pipe[2];
+    char directory[TEXTURE_ATLAS_PATH_LENGTH];
+    char name[TEXTURE_ATLAS_PATH_LENGTH];
+} watcher;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    store_little_endian
+ * @brief   Stores the low length bytes of value, least significant first.
+ *
+ * @param   bytes
+ * @param   value
+ * @param   length
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void store_little_endian(unsigned char *bytes, uint32_t value, int length);
+
+/**************************************************************************************************/
+/**
+ * @name    load_little_endian
+ * @brief   Loads a length-byte little-endian integer.
+ *
+ * @param   bytes
+ * @param   length
+ *
+ * @return  uint32_t
+ */
+/**************************************************************************************************/
+static uint32_t load_little_endian(const unsigned char *bytes, int length);
+
+/**************************************************************************************************/
+/**
+ * @name    release_texture_set
+ * @brief   Frees the textures a set compiled and their rows. The set itself is freed too
+ *          unless it is the built-in one.
+ *
+ * @param   set
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void release_texture_set(texture_set *set);
+
+/**************************************************************************************************/
+/**
+ * @name    get_max_texture_width
+ * @brief   Returns how wide a texture may be: scenery up to the screen width, but the player and
+ *          obstacles only up to ASCII_MASK_MAX_WIDTH, since collisions need their masks.
+ *
+ * @param   texture
+ *
+ * @return  int
+ */
+/**************************************************************************************************/
+static int get_max_texture_width(texture_id texture);
+
+/**************************************************************************************************/
+/**
+ * @name    compile_atlas_entry
+ * @brief   Checks one atlas entry against the set's copy of the file and compiles its rows in
+ *          place. Rows must be exactly width printable characters followed by '\n'. Textures
+ *          must fit the screen, and the ones that collide must also fit the collision masks.
+ *
+ * @param   set
+ * @param   entry       The entry's 16 bytes
+ *
+ * @return  int     0 on success, -1 if the entry is invalid or memory could not be allocated
+ */
+/**************************************************************************************************/
+static int compile_atlas_entry(texture_set *set, const unsigned char *entry);
+
+/**************************************************************************************************/
+/**
+ * @name    read_texture_atlas
+ * @brief   Reads an atlas file into memory the new set owns and compiles the set from it, with
+ *          the built-in texture for any texture the atlas does not have. Drawing never reads the
+ *          file, and a save that truncates it while it is read only makes the read come up short,
+ *          which fails validation like any other broken atlas.
+ *
+ * @param   path
+ *
+ * @return  texture_set*    The new set, or NULL if the atlas could not be loaded
+ */
+/**************************************************************************************************/
+static texture_set *read_texture_atlas(const char *path);
+
+#ifdef __linux__
+/**************************************************************************************************/
+/**
+ * @name    watch_texture_atlas
+ * @brief   Watcher thread body: waits for the atlas to change, builds a new set from it and hands
+ *          it to refresh_textures. An atlas that fails to load is ignored, so a half-saved file
+ *          leaves the current textures in place.
+ *
+ * @param   argument    inotify descriptor, cast to a pointer
+ *
+ * @return  void*
+ */
+/**************************************************************************************************/
+static void *watch_texture_atlas(void *argument);
+#endif
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static void store_little_endian(unsigned char *bytes, uint32_t value, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint32_t load_little_endian(const unsigned char *bytes, int length)
+{
+    uint32_t value = 0;
+
+    for (int i = length - 1; i >= 0; i--)
+    {
+        value = (value << 8) | bytes[i];
+    }
+
+    return value;
+}
+
+static void release_texture_set(texture_set *set)
+{
+    if (set == NULL)
+    {
+        return;
+    }
+
+    for (int texture = 0; texture < TEXTURE_COUNT; texture++)
+    {
+        if (set->owned[texture])
+        {
+            free_compiled_ascii_object(&set->textures[texture]);
+        }
+    }
+
+    free(set->atlas);
+
+    if (set != &fallback_set)
+    {
+        free(set);
+    }
+}
+
+static int get_max_texture_width(texture_id texture)
+{
+    switch (texture)
+    {
+    case TEXTURE_PLAYER:
+    case TEXTURE_CACTUS_SMALL:
+    case TEXTURE_CACTUS_LARGE:
+    case TEXTURE_BIRD:
+        return ASCII_MASK_MAX_WIDTH;
+    default:
+        return TERMINAL_DISPLAY_WIDTH;
+    }
+}
+
+static int compile_atlas_entry(texture_set *set, const unsigned char *entry)
+{
+    uint32_t texture = load_little_endian(entry, 4);
+    int width = (int)load_little_endian(entry + 4, 2);
+    int height = (int)load_little_endian(entry + 6, 2);
+    size_t offset = load_little_endian(entry + 8, 4);
+    const char *lines[TERMINAL_DISPLAY_HEIGHT];
+
+    if (texture >= TEXTURE_COUNT || set->owned[texture] ||
+        width <= 0 || width > get_max_texture_width((texture_id)texture) ||
+        height <= 0 || height > TERMINAL_DISPLAY_HEIGHT ||
+        offset > set->atlas_length ||
+        (size_t)height * (size_t)(width + 1) > set->atlas_length - offset)
+    {
+        return -1;
+    }
+
+    for (int row = 0; row < height; row++)
+    {
+        const char *source = set->atlas + offset + (size_t)row * (size_t)(width + 1);
+
+        for (int column = 0; column < width; column++)
+        {
+            if (source[column] < ' ' || source[column] > '~')
+            {
+                return -1;
+            }
+        }
+        if (source[width] != '\n')
+        {
+            return -1;
+        }
+
+        lines[row] = source;
+    }
+
+    // Spans keep pointers into the set's copy of the file, which nothing writes to, so entries
+    // may share rows; the line array is only needed while compiling
+    ascii_object object = {
+        .width = width,
+        .height = height,
+        .lines = lines,
+        .opaque_spaces = (entry[12] & TEXTURE_ATLAS_OPAQUE_SPACES) != 0
+    };
+
+    if (compile_ascii_object(&object, &set->textures[texture]) != 0)
+    {
+        return -1;
+    }
+
+    set->owned[texture] = true;
+    return 0;
+}
+
+static texture_set *read_texture_atlas(const char *path)
+{
+    struct stat status;
+    int file = open(path, O_RDONLY);
+
+    if (file < 0)
+    {
+        return NULL;
+    }
+
+    if (fstat(file, &status) != 0 || status.st_size < TEXTURE_ATLAS_HEADER_LENGTH)
+    {
+        close(file);
+        return NULL;
+    }
+
+    texture_set *set = calloc(1, sizeof(*set));
+    if (set != NULL)
+    {
+        set->atlas = malloc((size_t)status.st_size);
+    }
+    if (set == NULL || set->atlas == NULL)
+    {
+        close(file);
+        release_texture_set(set);
+        return NULL;
+    }
+
+    // A file cut short while it is read leaves atlas_length short, and the checks below reject
+    // whatever entries no longer fit
+    while (set->atlas_length < (size_t)status.st_size)
+    {
+        ssize_t length = pread(file, set->atlas + set->atlas_length,
+                               (size_t)status.st_size - set->atlas_length,
+                               (off_t)set->atlas_length);
+        if (length < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (length <= 0)
+        {
+            break;
+        }
+        set->atlas_length += (size_t)length;
+    }
+    close(file);
+
+    const unsigned char *header = (const unsigned char *)set->atlas;
+    bool valid = set->atlas_length >= TEXTURE_ATLAS_HEADER_LENGTH;
+    size_t entry_count = valid ? load_little_endian(header + TEXTURE_ATLAS_MAGIC_LENGTH, 4) : 0;
+
+    valid = valid && memcmp(header, TEXTURE_ATLAS_MAGIC, TEXTURE_ATLAS_MAGIC_LENGTH) == 0 &&
+            entry_count <= TEXTURE_COUNT &&
+            entry_count * TEXTURE_ATLAS_ENTRY_LENGTH <=
+            set->atlas_length - TEXTURE_ATLAS_HEADER_LENGTH;
+
+    for (size_t entry = 0; entry < entry_count && valid; entry++)
+    {
+        valid = compile_atlas_entry(set, header + TEXTURE_ATLAS_HEADER_LENGTH +
+                                         entry * TEXTURE_ATLAS_ENTRY_LENGTH) == 0;
+    }
+
+    if (!valid)
+    {
+        release_texture_set(set);
+        return NULL;
+    }
+
+    for (int texture = 0; texture < TEXTURE_COUNT; texture++)
+    {
+        if (!set->owned[texture])
+        {
+            set->textures[texture] = builtin_textures[texture].compiled;
+        }
+    }
+
+    return set;
+}
+
+#ifdef __linux__
+static void *watch_texture_atlas(void *argument)
+{
+    int notify = (int)(intptr_t)argument;
+    _Alignas(struct inotify_event) char events[TEXTURE_WATCH_BUFFER_LENGTH];
+    char path[2 * TEXTURE_ATLAS_PATH_LENGTH];
+
+    snprintf(path, sizeof(path), "%s/%s", watcher.directory, watcher.name);
+
+    for (;;)
+    {
+        struct pollfd descriptors[2] = {
+            { .fd = notify, .events = POLLIN },
+            { .fd = watcher.stop_pipe[0], .events = POLLIN }
+        };
+
+        if (poll(descriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (descriptors[1].revents != 0)
+        {
+            break;
+        }
+
+        ssize_t length = read(notify, events, sizeof(events));
+        if (length <= 0)
+        {
+            continue;
+        }
+
+        // Several writes can land in one read; one reload covers them all
+        bool changed = false;
+        for (char *event = events; event < events + length; )
+        {
+            const struct inotify_event *notice = (const struct inotify_event *)event;
+
+            if (notice->len > 0 && strcmp(notice->name, watcher.name) == 0)
+            {
+                changed = true;
+            }
+            event += sizeof(struct inotify_event) + notice->len;
+        }
+
+        if (changed)
+        {
+            texture_set *set = read_texture_atlas(path);
+
+            if (set != NULL)
+            {
+                // Replaces a set the drawing thread never picked up, which nobody else can see
+                release_texture_set(atomic_exchange(&pending_set, set));
+            }
+        }
+    }
+
+    close(notify);
+    return NULL;
+}
+#endif
+
+void load_textures(void)
+{
+    for (int texture = 0; texture < TEXTURE_COUNT; texture++)
+    {
+        fallback_set.textures[texture] = builtin_textures[texture].compiled;
+    }
+
+    current_set = &fallback_set;
+}
+
+void unload_textures(void)
+{
+    stop_texture_watcher();
+
+    release_texture_set(atomic_exchange(&pending_set, NULL));
+    if (current_set != &fallback_set)
+    {
+        release_texture_set(current_set);
+        current_set = &fallback_set;
+    }
+    release_texture_set(&fallback_set);
+}
+
+const compiled_ascii_object *get_texture(texture_id texture)
+{
+    return &current_set->textures[texture];
+}
+
+int load_texture_atlas(const char *path)
+{
+    texture_set *set = read_texture_atlas(path);
+
+    if (set == NULL)
+    {
+        return -1;
+    }
+
+    if (current_set != &fallback_set)
+    {
+        release_texture_set(current_set);
+    }
+    current_set = set;
+
+    return 0;
+}
+
+int start_texture_watcher(const char *path)
+{
+#ifdef __linux__
+    if (watcher.running)
+    {
+        errno = EBUSY;
+        return -1;
+    }
+
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL)
+    {
+        snprintf(watcher.directory, sizeof(watcher.directory), ".");
+        snprintf(watcher.name, sizeof(watcher.name), "%s", path);
+    }
+    else
+    {
+        snprintf(watcher.directory, sizeof(watcher.directory), "%.*s",
+                 slash == path ? 1 : (int)(slash - path), path);
+        snprintf(watcher.name, sizeof(watcher.name), "%s", slash + 1);
+    }
+
+    int notify = inotify_init1(IN_CLOEXEC);
+    if (notify < 0)
+    {
+        return -1;
+    }
+
+    // IN_CLOSE_WRITE catches editors that save in place, IN_MOVED_TO the ones that rename
+    if (inotify_add_watch(notify, watcher.directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        pipe(watcher.stop_pipe) != 0)
+    {
+        int saved_errno = errno;
+        close(notify);
+        errno = saved_errno;
+        return -1;
+    }
+
+    int error = pthread_create(&watcher.thread, NULL, watch_texture_atlas,
+                               (void *)(intptr_t)notify);
+    if (error != 0)
+    {
+        close(notify);
+        close(watcher.stop_pipe[0]);
+        close(watcher.stop_pipe[1]);
+        errno = error;
+        return -1;
+    }
+
+    watcher.running = true;
+    return 0;
+#else
+    (void)path;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+void stop_texture_watcher(void)
+{
+    if (!watcher.running)
+    {
+        return;
+    }
+
+    close(watcher.stop_pipe[1]);
+    pthread_join(watcher.thread, NULL);
+    close(watcher.stop_pipe[0]);
+    watcher.running = false;
+}
+
+bool refresh_textures(void)
+{
+    texture_set *set = atomic_exchange(&pending_set, NULL);
+
+    if (set == NULL)
+    {
+        return false;
+    }
+
+    if (current_set != &fallback_set)
+    {
+        release_texture_set(current_set);
+    }
+    current_set = set;
+
+    return true;
+}
+
+int export_texture_atlas(const char *path)
+{
+    unsigned char header[TEXTURE_ATLAS_HEADER_LENGTH] = { 0 };
+    unsigned char entries[TEXTURE_COUNT][TEXTURE_ATLAS_ENTRY_LENGTH] = { { 0 } };
+    char temporary_path[TEXTURE_ATLAS_PATH_LENGTH];
+    uint32_t offset = TEXTURE_ATLAS_HEADER_LENGTH + sizeof(entries);
+
+    if (snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path) >=
+        (int)sizeof(temporary_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    memcpy(header, TEXTURE_ATLAS_MAGIC, TEXTURE_ATLAS_MAGIC_LENGTH);
+    store_little_endian(header + TEXTURE_ATLAS_MAGIC_LENGTH, TEXTURE_COUNT, 4);
+
+    for (int texture = 0; texture < TEXTURE_COUNT; texture++)
+    {
+        const builtin_texture *source = &builtin_textures[texture];
+        int width = source->compiled.width;
+        int height = source->compiled.height;
+
+        store_little_endian(entries[texture], (uint32_t)texture, 4);
+        store_little_endian(entries[texture] + 4, (uint32_t)width, 2);
+        store_little_endian(entries[texture] + 6, (uint32_t)height, 2);
+        store_little_endian(entries[texture] + 8, offset, 4);
+        entries[texture][12] = source->opaque_spaces ? TEXTURE_ATLAS_OPAQUE_SPACES : 0;
+
+        offset += (uint32_t)(height * (width + 1));
+    }
+
+    FILE *file = fopen(temporary_path, "wb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    int failed = fwrite(header, sizeof(header), 1, file) != 1;
+    failed |= fwrite(entries, sizeof(entries), 1, file) != 1;
+
+    for (int texture = 0; texture < TEXTURE_COUNT && !failed; texture++)
+    {
+        const builtin_texture *source = &builtin_textures[texture];
+        int width = source->compiled.width;
+
+        for (int row = 0; row < source->compiled.height; row++)
+        {
+            fprintf(file, "%.*s\n", width, source->rows + row * width);
+        }
+    }
+
+    failed |= ferror(file);
+    failed |= fclose(file);
+
+    if (failed || rename(temporary_path, path) != 0)
+    {
+        int saved_errno = errno;
+        remove(temporary_path);
+        errno = saved_errno;
+        return -1;
+    }
+
+    return 0;
+}
+
+// End of texture_cache.c
@@ -0,0 +1,396 @@
+/**************************************************************************************************/
+/**
+ * @file world.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Procedural generator for the scenery and obstacles ahead of the camera, producing fixed
+ *        width chunks either on demand or ahead of time on a worker thread
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "obstacles.h"
+#include "world.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define WORLD_WAIT_NANOSECONDS      100000  // Poll interval while the worker catches up
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * What each background layer spawns, and how far apart. Gaps are in ground columns, drawn
+ * uniformly from [minimum, minimum + range), and keep about as many elements of each layer on
+ * screen as the game starts with; slow layers need long gaps because they scroll so little.
+ */
+static const struct
+{
+    int minimum_gap;
+    int gap_range;
+    int count;
+    texture_id textures[3];
+} layer_spawns[NUM_LAYERS] = {
+    [LAYER_CLOUDS]      = { 290, 580, 2, { TEXTURE_CLOUD_LARGE, TEXTURE_CLOUD_SMALL } },
+    [LAYER_MOUNTAINS]   = { 145, 290, 3, { TEXTURE_MOUNTAIN_SMALL, TEXTURE_MOUNTAIN_LARGE,
+                                           TEXTURE_MOUNTAIN_TWIN_PEAKS } },
+    [LAYER_HOUSES]      = { 175, 350, 2, { TEXTURE_BUSH, TEXTURE_BUSH } }, // Second will be HOUSE
+    [LAYER_TREES]       = {  50, 100, 1, { TEXTURE_TREE } }
+};
+
+// Obstacle kinds a spawn picks from, uniformly
+static const texture_id obstacle_textures[] = {
+    TEXTURE_CACTUS_SMALL,
+    TEXTURE_CACTUS_LARGE,
+    TEXTURE_BIRD
+};
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    draw_gap
+ * @brief   Returns the ground distance from one event of a source to its next.
+ *
+ * @param   generator
+ * @param   source
+ *
+ * @return  float
+ */
+/**************************************************************************************************/
+static float draw_gap(world_generator *generator, int source);
+
+/**************************************************************************************************/
+/**
+ * @name    draw_texture
+ * @brief   Picks what the next event of a source is.
+ *
+ * @param   generator
+ * @param   source
+ *
+ * @return  texture_id
+ */
+/**************************************************************************************************/
+static texture_id draw_texture(world_generator *generator, int source);
+
+/**************************************************************************************************/
+/**
+ * @name    generate_chunk
+ * @brief   Generates the next chunk in order. Each source emits its events falling inside the
+ *          chunk, then the events are sorted by distance.
+ *
+ * @param   generator
+ * @param   chunk
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void generate_chunk(world_generator *generator, world_chunk *chunk);
+
+/**************************************************************************************************/
+/**
+ * @name    generate_ahead
+ * @brief   Worker thread: keeps the ring full, sleeping on the wake pipe while it is.
+ *
+ * @param   argument    The world_stream
+ *
+ * @return  void*       NULL
+ */
+/**************************************************************************************************/
+static void *generate_ahead(void *argument);
+
+/**************************************************************************************************/
+/**
+ * @name    next_chunk
+ * @brief   Releases the current chunk, if any, and makes the next one current.
+ *
+ * @param   world
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void next_chunk(world_stream *world);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+static float draw_gap(world_generator *generator, int source)
+{
+    if (source == WORLD_SOURCE_OBSTACLES)
+    {
+        float gap = generator->scroll_speed *
+                    (float)(OBSTACLE_MIN_SPAWN_TICKS +
+                            prng_below(&generator->obstacle_random, OBSTACLE_SPAWN_TICK_RANGE));
+
+        // A stopped or crawling world must still move on to the next event
+        return gap >= 1.0f ? gap : 1.0f;
+    }
+
+    return (float)(layer_spawns[source].minimum_gap +
+                   prng_below(&generator->scenery_random, layer_spawns[source].gap_range));
+}
+
+static texture_id draw_texture(world_generator *generator, int source)
+{
+    if (source == WORLD_SOURCE_OBSTACLES)
+    {
+        int kind_count = (int)(sizeof(obstacle_textures) / sizeof(obstacle_textures[0]));
+
+        return obstacle_textures[prng_below(&generator->obstacle_random, kind_count)];
+    }
+
+    int choice = 0;
+    if (layer_spawns[source].count > 1)
+    {
+        choice = prng_below(&generator->scenery_random, layer_spawns[source].count);
+    }
+
+    return layer_spawns[source].textures[choice];
+}
+
+static void generate_chunk(world_generator *generator, world_chunk *chunk)
+{
+    float end = (float)(generator->next_chunk + 1) * WORLD_CHUNK_DISTANCE;
+
+    chunk->index = generator->next_chunk++;
+    chunk->event_count = 0;
+
+    for (int source = 0; source < WORLD_SOURCE_COUNT; source++)
+    {
+        while (generator->next_spawn[source] < end)
+        {
+            world_event event = {
+                .distance = generator->next_spawn[source],
+                .x = (float)TERMINAL_DISPLAY_WIDTH,
+                .texture = (uint16_t)draw_texture(generator, source),
+                .source = (uint8_t)source
+            };
+
+            // Scenery enters anywhere in the spawn band; obstacles enter at the edge, so their
+            // gaps stay as long as drawn and the player can always land between them
+            if (source != WORLD_SOURCE_OBSTACLES)
+            {
+                event.x += (float)prng_below(&generator->scenery_random,
+                                             BACKGROUND_SPAWN_DISTANCE);
+            }
+
+            // Dropping the event still consumes its random numbers, so the rest of the world
+            // is the same whether or not the chunk overflowed
+            if (chunk->event_count < WORLD_CHUNK_MAX_EVENTS)
+            {
+                chunk->events[chunk->event_count++] = event;
+            }
+
+            generator->next_spawn[source] += draw_gap(generator, source);
+        }
+    }
+
+    // Insertion sort: a chunk holds a handful of events, already sorted within each source
+    for (int i = 1; i < chunk->event_count; i++)
+    {
+        world_event event = chunk->events[i];
+        int j = i;
+
+        for (; j > 0 && chunk->events[j - 1].distance > event.distance; j--)
+        {
+            chunk->events[j] = chunk->events[j - 1];
+        }
+        chunk->events[j] = event;
+    }
+}
+
+static void *generate_ahead(void *argument)
+{
+    world_stream *world = argument;
+    world_ring *ring = world->ring;
+
+    for (;;)
+    {
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        if (tail - head < WORLD_LOOKAHEAD_CHUNKS)
+        {
+            generate_chunk(&world->generator, &ring->chunks[tail & (WORLD_LOOKAHEAD_CHUNKS - 1)]);
+
+            // Publishes the chunk: the game thread's acquire load of tail sees it complete
+            atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+            continue;
+        }
+
+        // Full. Every freed slot is followed by a byte, so a byte written after the check above
+        // still wakes this read; 0 means the game closed the pipe to stop the worker.
+        char wake[16];
+        ssize_t length = read(world->wake_pipe[0], wake, sizeof(wake));
+
+        if (length == 0 || (length < 0 && errno != EINTR))
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void next_chunk(world_stream *world)
+{
+    world_ring *ring = world->ring;
+
+    if (ring == NULL)
+    {
+        generate_chunk(&world->generator, &world->chunk);
+        world->current = &world->chunk;
+        world->next_event = 0;
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    if (world->current != NULL)
+    {
+        // Hands the slot back: the worker's acquire load of head sees it free only after the
+        // last read of it
+        atomic_store_explicit(&ring->head, ++head, memory_order_release);
+
+        // The pipe is non-blocking; if it is full the worker has wake-ups pending anyway
+        ssize_t written = write(world->wake_pipe[1], "", 1);
+        (void)written;
+    }
+
+    // Only reached if the worker fell a whole lookahead behind. Waiting keeps the world
+    // identical to on-demand generation instead of inventing a stand-in chunk.
+    while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head)
+    {
+        struct timespec wait = { 0, WORLD_WAIT_NANOSECONDS };
+        nanosleep(&wait, NULL);
+    }
+
+    world->current = &ring->chunks[head & (WORLD_LOOKAHEAD_CHUNKS - 1)];
+    world->next_event = 0;
+}
+
+void initialize_world(world_stream *world, uint64_t seed, float scroll_speed)
+{
+    world_generator *generator = &world->generator;
+
+    seed_prng(&generator->scenery_random, seed, PRNG_STREAM_BACKGROUND);
+    seed_prng(&generator->obstacle_random, seed, PRNG_STREAM_OBSTACLES);
+    generator->scroll_speed = scroll_speed;
+    generator->next_chunk = 0;
+
+    // The starting scenery is placed by initialize_background, so every layer starts a gap in.
+    // The first obstacle comes after the minimum gap.
+    for (int layer = 0; layer < NUM_LAYERS; layer++)
+    {
+        generator->next_spawn[layer] = draw_gap(generator, layer);
+    }
+    generator->next_spawn[WORLD_SOURCE_OBSTACLES] = scroll_speed * OBSTACLE_MIN_SPAWN_TICKS;
+
+    world->current = NULL;
+    world->next_event = 0;
+    world->ring = NULL;
+}
+
+int start_world_generator(world_stream *world)
+{
+    world_ring *ring = aligned_alloc(WORLD_CACHE_LINE, sizeof(world_ring));
+
+    if (ring == NULL)
+    {
+        return -1;
+    }
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    if (pipe(world->wake_pipe) != 0)
+    {
+        free(ring);
+        return -1;
+    }
+    fcntl(world->wake_pipe[1], F_SETFL, fcntl(world->wake_pipe[1], F_GETFL) | O_NONBLOCK);
+
+    world->ring = ring;
+
+    int error = pthread_create(&world->thread, NULL, generate_ahead, world);
+    if (error != 0)
+    {
+        close(world->wake_pipe[0]);
+        close(world->wake_pipe[1]);
+        world->ring = NULL;
+        free(ring);
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+void free_world(world_stream *world)
+{
+    if (world->ring == NULL)
+    {
+        return;
+    }
+
+    close(world->wake_pipe[1]);
+    pthread_join(world->thread, NULL);
+    close(world->wake_pipe[0]);
+    free(world->ring);
+    world->ring = NULL;
+    world->current = NULL;
+}
+
+bool take_world_event(world_stream *world, float distance, world_event *event)
+{
+    for (;;)
+    {
+        if (world->current != NULL)
+        {
+            if (world->next_event < world->current->event_count)
+            {
+                const world_event *next = &world->current->events[world->next_event];
+
+                if (next->distance > distance)
+                {
+                    return false;
+                }
+
+                *event = *next;
+                world->next_event++;
+                return true;
+            }
+
+            // Nothing in the next chunk can be due before the ground reaches it
+            if ((float)(world->current->index + 1) * WORLD_CHUNK_DISTANCE > distance)
+            {
+                return false;
+            }
+        }
+
+        next_chunk(world);
+    }
+}
+
+// End of world.c
@@ -0,0 +1,508 @@
+/**************************************************************************************************/
+/**
+ * @file texture_compiler.c
+ * @author Ryan Jing (r5jing@uwaterloo.ca)
+ * @brief Build-time tool that compiles the texture art file into a C file defining
+ *        builtin_textures (see textures.h). Dimensions are measured from the art, and the spans
+ *        and collision masks are built with the game's own compile_ascii_object, so the tables
+ *        match what compiling at run time would give.
+ *
+ *        Usage: texture_compiler ART OUTPUT
+ *
+ *        Any malformed texture fails the build with the art file's name and line number.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+/**************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------*/
+/* HEADERS                                                                                        */
+/*------------------------------------------------------------------------------------------------*/
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ascii.h"
+#include "terminal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+/* MACROS                                                                                         */
+/*------------------------------------------------------------------------------------------------*/
+
+#define COMPILER_MAX_TEXTURES       64
+#define COMPILER_NAME_LENGTH        64
+#define COMPILER_LINE_LENGTH        256
+#define COMPILER_OPAQUE_SPACES_FLAG "opaque_spaces"
+
+/*------------------------------------------------------------------------------------------------*/
+/* GLOBAL VARIABLES                                                                               */
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Texture read from the art file
+ * - name: name between the brackets, which also names its tables and TEXTURE_* identifier
+ * - line: art file line the texture starts on, for error messages
+ * - rows, lines: the rows read so far, each NUL-terminated and all of one width, and pointers
+ *   to them
+ * - object: the texture as compile_ascii_object takes it, grown a row at a time
+ */
+typedef struct
+{
+    char name[COMPILER_NAME_LENGTH];
+    int line;
+    char rows[TERMINAL_DISPLAY_HEIGHT][TERMINAL_DISPLAY_WIDTH + 1];
+    const char *lines[TERMINAL_DISPLAY_HEIGHT];
+    ascii_object object;
+} art_texture;
+
+static art_texture textures[COMPILER_MAX_TEXTURES];
+static int texture_count = 0;
+
+static const char *art_path;
+static int art_line = 0;
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION PROTOTYPES                                                                            */
+/*------------------------------------------------------------------------------------------------*/
+
+/**************************************************************************************************/
+/**
+ * @name    fail
+ * @brief   Reports an error at the current art file line and exits with status 1.
+ *
+ * @param   format  printf format of the message
+ *
+ * @return  void    Never returns
+ */
+/**************************************************************************************************/
+_Noreturn static void fail(const char *format, ...);
+
+/**************************************************************************************************/
+/**
+ * @name    start_texture
+ * @brief   Parses a "[name flags]" line and starts a new texture.
+ *
+ * @param   line    The line, without its newline
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void start_texture(const char *line);
+
+/**************************************************************************************************/
+/**
+ * @name    add_row
+ * @brief   Parses a "|row|" line and appends the row to the current texture, checking that it is
+ *          printable and as wide as the texture's first row.
+ *
+ * @param   line    The line, without its newline
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void add_row(const char *line);
+
+/**************************************************************************************************/
+/**
+ * @name    read_art
+ * @brief   Reads every texture from the art file.
+ *
+ * @param   file
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void read_art(FILE *file);
+
+/**************************************************************************************************/
+/**
+ * @name    write_string
+ * @brief   Writes characters as the body of a C string literal, escaping what needs it.
+ *
+ * @param   output
+ * @param   characters
+ * @param   length
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void write_string(FILE *output, const char *characters, int length);
+
+/**************************************************************************************************/
+/**
+ * @name    write_texture_tables
+ * @brief   Writes the packed rows, span table, span list and collision masks of one texture.
+ *
+ * @param   output
+ * @param   texture
+ * @param   compiled    The texture compiled by compile_ascii_object
+ *
+ * @return  void
+ */
+/**************************************************************************************************/
+static void write_texture_tables(FILE *output, const art_texture *texture,
+                                 const compiled_ascii_object *compiled);
+
+/**************************************************************************************************/
+/**
+ * @name    write_textures
+ * @brief   Writes the whole generated C file.
+ *
+ * @param   output
+ *
+ * @return  int     0 on success, -1 if memory ran out compiling a texture
+ */
+/**************************************************************************************************/
+static int write_textures(FILE *output);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+_Noreturn static void fail(const char *format, ...)
+{
+    va_list arguments;
+
+    fprintf(stderr, "%s:%d: ", art_path, art_line);
+    va_start(arguments, format);
+    vfprintf(stderr, format, arguments);
+    va_end(arguments);
+    fputc('\n', stderr);
+
+    exit(1);
+}
+
+static void start_texture(const char *line)
+{
+    const char *end = strchr(line, ']');
+    char flags[COMPILER_LINE_LENGTH] = "";
+    int name_length = 0;
+
+    if (texture_count == COMPILER_MAX_TEXTURES)
+    {
+        fail("more than %d textures", COMPILER_MAX_TEXTURES);
+    }
+    if (end == NULL || end[1] != '\0')
+    {
+        fail("texture header must end with ']'");
+    }
+
+    while (line[1 + name_length] == '_' || islower((unsigned char)line[1 + name_length]) ||
+           isdigit((unsigned char)line[1 + name_length]))
+    {
+        name_length++;
+    }
+    if (name_length == 0 || name_length >= COMPILER_NAME_LENGTH)
+    {
+        fail("texture name must be 1 to %d of a-z, 0-9 and '_'", COMPILER_NAME_LENGTH - 1);
+    }
+
+    // Anything between the name and the bracket is flags
+    const char *rest = line + 1 + name_length;
+    while (*rest == ' ')
+    {
+        rest++;
+    }
+    snprintf(flags, sizeof(flags), "%.*s", (int)(end - rest), rest);
+
+    art_texture *texture = &textures[texture_count++];
+    snprintf(texture->name, sizeof(texture->name), "%.*s", name_length, line + 1);
+    texture->line = art_line;
+    texture->object.opaque_spaces = strcmp(flags, COMPILER_OPAQUE_SPACES_FLAG) == 0;
+
+    if (flags[0] != '\0' && !texture->object.opaque_spaces)
+    {
+        fail("unknown flag \"%s\"", flags);
+    }
+
+    for (int i = 0; i < texture_count - 1; i++)
+    {
+        if (strcmp(textures[i].name, texture->name) == 0)
+        {
+            fail("%s is already defined on line %d", texture->name, textures[i].line);
+        }
+    }
+}
+
+static void add_row(const char *line)
+{
+    int width = (int)strlen(line) - 2;
+
+    if (texture_count == 0)
+    {
+        fail("row before the first texture header");
+    }
+
+    art_texture *texture = &textures[texture_count - 1];
+    ascii_object *object = &texture->object;
+
+    if (width < 1 || line[width + 1] != '|')
+    {
+        fail("row must be written between two '|'");
+    }
+    if (width > TERMINAL_DISPLAY_WIDTH)
+    {
+        fail("row is %d characters, wider than the screen", width);
+    }
+    if (object->height == TERMINAL_DISPLAY_HEIGHT)
+    {
+        fail("%s is taller than the screen", texture->name);
+    }
+    if (object->height > 0 && width != object->width)
+    {
+        fail("row is %d characters, but %s's first row is %d", width, texture->name,
+             object->width);
+    }
+
+    for (int column = 0; column < width; column++)
+    {
+        if (line[1 + column] < ' ' || line[1 + column] > '~')
+        {
+            fail("column %d is not a printable ASCII character", column + 1);
+        }
+    }
+
+    memcpy(texture->rows[object->height], line + 1, (size_t)width);
+    texture->rows[object->height][width] = '\0';
+    texture->lines[object->height] = texture->rows[object->height];
+    object->lines = texture->lines;
+    object->width = width;
+    object->height++;
+}
+
+static void read_art(FILE *file)
+{
+    char line[COMPILER_LINE_LENGTH];
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        size_t length = strlen(line);
+
+        art_line++;
+        if (length > 0 && line[length - 1] == '\n')
+        {
+            line[--length] = '\0';
+        }
+        else if (!feof(file))
+        {
+            fail("line is longer than %d characters", COMPILER_LINE_LENGTH - 2);
+        }
+        if (length > 0 && line[length - 1] == '\r')
+        {
+            line[--length] = '\0';
+        }
+
+        if (length == 0 || line[0] == '#')
+        {
+            continue;
+        }
+        else if (line[0] == '[')
+        {
+            if (texture_count > 0 && textures[texture_count - 1].object.height == 0)
+            {
+                fail("%s has no rows", textures[texture_count - 1].name);
+            }
+            start_texture(line);
+        }
+        else if (line[0] == '|')
+        {
+            add_row(line);
+        }
+        else
+        {
+            fail("expected a texture header, a row, a comment or a blank line");
+        }
+    }
+
+    if (texture_count == 0)
+    {
+        fail("no textures");
+    }
+    if (textures[texture_count - 1].object.height == 0)
+    {
+        fail("%s has no rows", textures[texture_count - 1].name);
+    }
+}
+
+static void write_string(FILE *output, const char *characters, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        // '?' is escaped too, so no pair of them can form a trigraph
+        if (characters[i] == '\\' || characters[i] == '"' || characters[i] == '?')
+        {
+            fputc('\\', output);
+        }
+        fputc(characters[i], output);
+    }
+}
+
+static void write_texture_tables(FILE *output, const art_texture *texture,
+                                 const compiled_ascii_object *compiled)
+{
+    const char *name = texture->name;
+    int span_count = compiled->row_first_span[compiled->height];
+
+    fprintf(output, "// %s: %d x %d, from line %d\n", name, compiled->width, compiled->height,
+            texture->line);
+
+    fprintf(output, "static const char %s_rows[] =", name);
+    for (int row = 0; row < compiled->height; row++)
+    {
+        fprintf(output, "\n    \"");
+        write_string(output, texture->rows[row], compiled->width);
+        fprintf(output, "\"");
+    }
+    fprintf(output, ";\n\n");
+
+    fprintf(output, "static const int %s_row_first_span[] = {", name);
+    for (int row = 0; row <= compiled->height; row++)
+    {
+        fprintf(output, "%s %d", row > 0 ? "," : "", compiled->row_first_span[row]);
+    }
+    fprintf(output, " };\n\n");
+
+    // An all-transparent texture has no spans; C does not allow an empty array
+    fprintf(output, "static const ascii_span %s_spans[] = {\n", name);
+    for (int span = 0; span < span_count; span++)
+    {
+        const ascii_span *current = &compiled->spans[span];
+        int row = 0;
+
+        while (compiled->row_first_span[row + 1] <= span)
+        {
+            row++;
+        }
+
+        // Spans point into the packed rows instead of the art's NUL-terminated ones
+        fprintf(output, "    { %2d, %2d, %s_rows + %d }%s\n", current->offset, current->length,
+                name, row * compiled->width + current->offset, span + 1 < span_count ? "," : "");
+    }
+    if (span_count == 0)
+    {
+        fprintf(output, "    { 0, 0, %s_rows }\n", name);
+    }
+    fprintf(output, "};\n\n");
+
+    if (compiled->row_masks != NULL)
+    {
+        fprintf(output, "static const uint64_t %s_row_masks[] = {\n", name);
+        for (int row = 0; row < compiled->height; row++)
+        {
+            fprintf(output, "    UINT64_C(0x%016llx)%s\n",
+                    (unsigned long long)compiled->row_masks[row],
+                    row + 1 < compiled->height ? "," : "");
+        }
+        fprintf(output, "};\n\n");
+    }
+}
+
+static int write_textures(FILE *output)
+{
+    compiled_ascii_object compiled[COMPILER_MAX_TEXTURES];
+
+    for (int i = 0; i < texture_count; i++)
+    {
+        if (compile_ascii_object(&textures[i].object, &compiled[i]) != 0)
+        {
+            return -1;
+        }
+    }
+
+    fprintf(output, "// Generated by texture_compiler from %s. Do not edit.\n\n", art_path);
+    fprintf(output, "#include <stddef.h>\n#include <stdint.h>\n\n#include \"textures.h\"\n\n");
+    fprintf(output, "_Static_assert(TEXTURE_COUNT == %d, "
+                    "\"texture_id and the art file must list the same textures\");\n\n",
+            texture_count);
+
+    for (int i = 0; i < texture_count; i++)
+    {
+        write_texture_tables(output, &textures[i], &compiled[i]);
+    }
+
+    fprintf(output, "const builtin_texture builtin_textures[TEXTURE_COUNT] = {\n");
+    for (int i = 0; i < texture_count; i++)
+    {
+        const char *name = textures[i].name;
+        char identifier[COMPILER_NAME_LENGTH];
+
+        for (int c = 0; c == 0 || name[c - 1] != '\0'; c++)
+        {
+            identifier[c] = (char)toupper((unsigned char)name[c]);
+        }
+
+        fprintf(output, "    [TEXTURE_%s] = {\n", identifier);
+        fprintf(output, "        .compiled = {\n");
+        fprintf(output, "            .width = %d,\n", compiled[i].width);
+        fprintf(output, "            .height = %d,\n", compiled[i].height);
+        fprintf(output, "            .row_first_span = %s_row_first_span,\n", name);
+        fprintf(output, "            .spans = %s_spans,\n", name);
+        if (compiled[i].row_masks != NULL)
+        {
+            fprintf(output, "            .row_masks = %s_row_masks\n", name);
+        }
+        else
+        {
+            fprintf(output, "            .row_masks = NULL    // Wider than ASCII_MASK_MAX_WIDTH\n");
+        }
+        fprintf(output, "        },\n");
+        fprintf(output, "        .rows = %s_rows,\n", name);
+        fprintf(output, "        .opaque_spaces = %s\n", textures[i].object.opaque_spaces ? "true"
+                                                                                      : "false");
+        fprintf(output, "    }%s\n", i + 1 < texture_count ? "," : "");
+
+        free_compiled_ascii_object(&compiled[i]);
+    }
+    fprintf(output, "};\n");
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s ART OUTPUT\n", argv[0]);
+        return 2;
+    }
+    art_path = argv[1];
+
+    FILE *art = fopen(art_path, "r");
+    if (art == NULL)
+    {
+        perror(art_path);
+        return 1;
+    }
+    read_art(art);
+    fclose(art);
+
+    FILE *output = fopen(argv[2], "w");
+    if (output == NULL)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+
+    int failed = write_textures(output) != 0;
+    failed |= ferror(output);
+    failed |= fclose(output);
+
+    // A half-written file must not look up to date to the build
+    if (failed)
+    {
+        perror(argv[2]);
+        remove(argv[2]);
+        return 1;
+    }
+
+    return 0;
+}
+
+// End of texture_compiler.c
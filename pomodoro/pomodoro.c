@@ -16,12 +16,33 @@
 /* HEADERS                                                                                        */
 /*------------------------------------------------------------------------------------------------*/
 
+#ifdef __linux__
+#define _GNU_SOURCE     // accept4
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
 #include <time.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#endif
+
 /*------------------------------------------------------------------------------------------------*/
 /* MACROS                                                                                         */
 /*------------------------------------------------------------------------------------------------*/
@@ -29,6 +50,38 @@
 #define WORK_TIMER_DEFAULT_MINUTES 25
 #define BREAK_TIMER_DEFAULT_MINUTES 5
 
+#define NANOSECONDS_PER_SECOND 1000000000LL
+#define SECONDS_PER_MINUTE 60
+
+#define STATUS_SINK_MAX 4
+#define STATUS_TEXT_LENGTH 64
+#define STATUS_PATH_LENGTH 1024
+
+// Monocraft Nerd Font icons: hourglass ⌛ (U+231B), anchor ⚓ (U+2693), pause ⏸ (U+23F8)
+#define WORK_TIMER_ICON "\u231B"
+#define BREAK_TIMER_ICON "\u2693"
+#define PAUSED_TIMER_ICON "\u23F8"
+
+#define TIMER_MINUTES_MAX 1440
+
+#define CONTROL_CLIENT_MAX 16
+#define CONTROL_REQUEST_LENGTH 128
+#define CONTROL_REPLY_LENGTH 128
+#define DAEMON_EVENT_MAX 16
+
+#define JOURNAL_MAGIC "POMOJRNL"
+#define JOURNAL_INDEX_MAGIC "POMOINDX"
+#define JOURNAL_VERSION 1
+#define JOURNAL_SYNC_RECORDS 8      // Records appended between fdatasync calls
+#define JOURNAL_INDEX_BLOCK 512     // Records summarised by one index entry
+
+// macOS declares no fdatasync; its fsync does no more than flush the data to the drive
+#ifdef __APPLE__
+#define JOURNAL_SYNC(descriptor) fsync(descriptor)
+#else
+#define JOURNAL_SYNC(descriptor) fdatasync(descriptor)
+#endif
+
 /*------------------------------------------------------------------------------------------------*/
 /* GLOBAL VARIABLES                                                                               */
 /*------------------------------------------------------------------------------------------------*/
@@ -39,6 +92,202 @@ typedef enum
     timer_break
 } timer_type_t;
 
+// How finely the remaining time is shown, and so how often the timer wakes up to update it
+typedef enum
+{
+    display_seconds,    // MM:SS, one wakeup per second
+    display_minutes     // Whole minutes, one wakeup per minute
+} timer_display_t;
+
+typedef struct status_sink status_sink_t;
+
+/**
+ * One way of showing the timer's status. open and close may be NULL when there is nothing to
+ * set up; update returns 0 once the status is shown, -1 if it could not be.
+ */
+typedef struct
+{
+    const char *name;
+    bool needs_target;
+    int (*open)(status_sink_t *sink);
+    int (*update)(status_sink_t *sink, const char *label, const char *icon);
+    void (*close)(status_sink_t *sink);
+} status_backend_t;
+
+/**
+ * A backend in use
+ * - target: path of the file or FIFO written to
+ * - descriptor: the FIFO while a reader has it open, -1 otherwise
+ * - last_label, last_icon: the status last shown, so an unchanged status is never sent again
+ */
+struct status_sink
+{
+    const status_backend_t *backend;
+    char target[STATUS_PATH_LENGTH];
+    int descriptor;
+    char last_label[STATUS_TEXT_LENGTH];
+    char last_icon[STATUS_TEXT_LENGTH];
+};
+
+typedef enum
+{
+    session_completed,
+    session_skipped,
+    session_interrupted
+} session_outcome_t;
+
+/**
+ * Start of a journal, and of its index: which file it is, its version, and the size of the
+ * records (or of the records each index entry covers) that follow. Both files are in the
+ * machine's own byte order.
+ * - journal_device, journal_inode: in the index, the journal it summarises, so an index left
+ *   behind by a replaced journal is rebuilt; 0 in the journal itself
+ */
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t size;
+    uint64_t journal_device;
+    uint64_t journal_inode;
+} journal_header_t;
+
+/**
+ * One session in the journal, appended when it ends
+ * - start_time: Unix time it started, in seconds
+ * - planned_seconds: length it was set to
+ * - focused_seconds: time counted down, pauses left out
+ * - type, outcome: a timer_type_t and a session_outcome_t
+ */
+typedef struct
+{
+    int64_t start_time;
+    uint32_t planned_seconds;
+    uint32_t focused_seconds;
+    uint8_t type;
+    uint8_t outcome;
+    uint8_t reserved[14];
+} journal_record_t;
+
+/**
+ * Summary of JOURNAL_INDEX_BLOCK consecutive records, kept in the index file next to the
+ * journal. Queries add up whole entries for the blocks inside their range, skip the blocks
+ * outside it, and only read the records of the few blocks straddling its ends.
+ * - min_start, max_start: earliest and latest start_time in the block, whatever their order
+ * - focused_seconds: focused time of the block's work sessions
+ * - pomodoros: work sessions in the block that were completed
+ * - last_record_check: get_record_check of the block's last record, so an entry saved for a
+ *   journal rewritten in place, which keeps its inode, is not trusted
+ */
+typedef struct
+{
+    int64_t min_start;
+    int64_t max_start;
+    uint64_t focused_seconds;
+    uint32_t pomodoros;
+    uint32_t last_record_check;
+} journal_index_entry_t;
+
+_Static_assert(sizeof(journal_header_t) == 32, "journal header layout");
+_Static_assert(sizeof(journal_record_t) == 32, "journal record layout");
+_Static_assert(sizeof(journal_index_entry_t) == 32, "journal index layout");
+
+/**
+ * The journal being written
+ * - descriptor: opened with O_APPEND, or -1 when no journal is kept
+ * - unsynced: records appended since the last fdatasync
+ */
+typedef struct
+{
+    int descriptor;
+    int unsynced;
+} session_journal_t;
+
+/**
+ * The journal mapped for queries
+ * - mapping, mapping_length: the whole file, mapped read-only
+ * - records, record_count: the complete records in it; a torn last record is left out
+ * - index, index_count: summaries of the first index_count * JOURNAL_INDEX_BLOCK records
+ */
+typedef struct
+{
+    void *mapping;
+    size_t mapping_length;
+    const journal_record_t *records;
+    size_t record_count;
+    journal_index_entry_t *index;
+    size_t index_count;
+} journal_view_t;
+
+/**
+ * Work done over a time range
+ * - focused_seconds: focused time of work sessions, whatever their outcome
+ * - pomodoros: completed work sessions
+ */
+typedef struct
+{
+    uint64_t focused_seconds;
+    uint32_t pomodoros;
+} session_totals_t;
+
+/**
+ * A connection to the daemon's control socket, reading one request line
+ * - descriptor: the connection, -1 while the slot is free
+ * - length: bytes of the request read so far
+ */
+typedef struct
+{
+    int descriptor;
+    size_t length;
+    char request[CONTROL_REQUEST_LENGTH];
+} control_client_t;
+
+/**
+ * The timer run as a daemon. Every descriptor is watched by the one epoll instance, with a
+ * pointer to the field holding it (or to the client) as the event's data.
+ * - epoll, timer, signals, listener: epoll instance, timerfd armed for the next display change,
+ *   signalfd for SIGINT, SIGTERM and SIGCHLD, and the listening control socket
+ * - path: where the control socket is bound, unlinked when the daemon exits
+ * - phase: the timer running, work or break
+ * - phase_length, phase_start: length of the phase, and the Unix time it started, for the
+ *   journal
+ * - paused: whether the countdown is stopped
+ * - end_time: CLOCK_MONOTONIC end of the phase, while running
+ * - remaining_time: time left in the phase, while paused
+ * - minutes: length of each phase, indexed by timer_type_t; a change applies from the next phase
+ * - display, sinks, sink_count: how and where the remaining time is shown
+ * - journal: where finished phases are recorded
+ * - clients: control connections being served
+ * - stopping: set by SIGINT or SIGTERM to leave the event loop
+ */
+typedef struct
+{
+    int epoll;
+    int timer;
+    int signals;
+    int listener;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    timer_type_t phase;
+    int64_t phase_length;
+    int64_t phase_start;
+    bool paused;
+    int64_t end_time;
+    int64_t remaining_time;
+    int minutes[2];
+    timer_display_t display;
+    status_sink_t *sinks;
+    int sink_count;
+    session_journal_t *journal;
+    control_client_t clients[CONTROL_CLIENT_MAX];
+    bool stopping;
+} pomodoro_daemon_t;
+
+// Set by SIGINT or SIGTERM in the plain timer, so the session is recorded before exiting
+static volatile sig_atomic_t timer_interrupted = 0;
+
+// posix_spawnp passes the timer's own environment on, so sketchybar and afplay are found on PATH
+extern char **environ;
+
 /*------------------------------------------------------------------------------------------------*/
 /* FUNCTION PROTOTYPES                                                                            */
 /*------------------------------------------------------------------------------------------------*/
@@ -46,21 +295,163 @@ typedef enum
 // While not necessary to declare prototypes for these functions, these are defined here for clarity
 // and my own learning purposes.
 
+/**************************************************************************************************/
+/**
+ * @name    spawn_program
+ * @brief   Starts a program straight from its argument list, found on PATH, without a shell in
+ *          between: one process instead of system()'s two.
+ *
+ * @param argv      Program name and arguments, NULL-terminated
+ *
+ * @return pid_t    The child, or -1 if it could not be started
+ */
+/**************************************************************************************************/
+pid_t spawn_program(char *const argv[]);
+
+/**************************************************************************************************/
+/**
+ * @name    reap_children
+ * @brief   Collects every child that has exited, such as finished sounds, without waiting for the
+ *          ones still running.
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void reap_children(void);
+
 /**************************************************************************************************/
 /**
  * @name    update_sketchybar
  * @brief   Updates the sketchybar pomodoro item with the given label and icon.
  *
- *          This function calls the sketchybar command line tool to set the label and icon
- *          using the --set option. It also ensures the divider is shown when updating.
+ *          This function runs the sketchybar command line tool to set the label and icon
+ *          using the --set option. It also ensures the divider is shown when updating. The
+ *          command line is the only interface sketchybar offers outside of macOS's own IPC, so
+ *          each update is one spawn, with no shell, waited for so updates never overlap.
  *
+ * @param sink
  * @param label     "label" of the sketchybar widget item
  * @param icon      "icon" of the sketchybar widget item
  *
+ * @return int      0 if sketchybar ran and succeeded, -1 otherwise
+ */
+/**************************************************************************************************/
+int update_sketchybar(status_sink_t *sink, const char *label, const char *icon);
+
+/**************************************************************************************************/
+/**
+ * @name    format_status_line
+ * @brief   Formats the line protocol shared by the stdout, file and FIFO sinks: the icon, a tab,
+ *          the label and a newline.
+ *
+ * @param line
+ * @param length
+ * @param label
+ * @param icon
+ *
+ * @return int      Length of the line, or -1 if it does not fit
+ */
+/**************************************************************************************************/
+int format_status_line(char *line, size_t length, const char *label, const char *icon);
+
+/**************************************************************************************************/
+/**
+ * @name    write_stdout_status
+ * @brief   Writes the status as one line to stdout, flushed so a pipe reader sees it at once.
+ *
+ * @param sink
+ * @param label
+ * @param icon
+ *
+ * @return int      0 on success, -1 on failure
+ */
+/**************************************************************************************************/
+int write_stdout_status(status_sink_t *sink, const char *label, const char *icon);
+
+/**************************************************************************************************/
+/**
+ * @name    write_file_status
+ * @brief   Replaces the target file with the current status line. The line is written to a
+ *          temporary file that is renamed over the target, so readers never see half of it.
+ *
+ * @param sink
+ * @param label
+ * @param icon
+ *
+ * @return int      0 on success, -1 on failure
+ */
+/**************************************************************************************************/
+int write_file_status(status_sink_t *sink, const char *label, const char *icon);
+
+/**************************************************************************************************/
+/**
+ * @name    open_fifo_sink
+ * @brief   Creates the target FIFO if it does not exist yet. Readers may come and go; the FIFO is
+ *          only opened for writing while one is attached.
+ *
+ * @param sink
+ *
+ * @return int      0 on success, -1 if the target exists and is not a FIFO or cannot be made
+ */
+/**************************************************************************************************/
+int open_fifo_sink(status_sink_t *sink);
+
+/**************************************************************************************************/
+/**
+ * @name    write_fifo_status
+ * @brief   Writes the status line to the FIFO, keeping it open between updates. Without a reader
+ *          the update is dropped rather than blocking the timer; a reader that attaches gets
+ *          the next update.
+ *
+ * @param sink
+ * @param label
+ * @param icon
+ *
+ * @return int      0 if written or no reader is attached, -1 on failure
+ */
+/**************************************************************************************************/
+int write_fifo_status(status_sink_t *sink, const char *label, const char *icon);
+
+/**************************************************************************************************/
+/**
+ * @name    close_fifo_sink
+ * @brief   Closes the FIFO if a reader has it open. The FIFO itself is left for the next run.
+ *
+ * @param sink
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void close_fifo_sink(status_sink_t *sink);
+
+/**************************************************************************************************/
+/**
+ * @name    open_status_sink
+ * @brief   Sets up a sink from a "--sink" argument: a backend name, followed by ":" and a path
+ *          for the file and fifo backends. Backends: sketchybar, stdout, file:PATH, fifo:PATH.
+ *
+ * @param sink
+ * @param specification
+ *
+ * @return int      0 on success, -1 if the argument names no backend or the backend failed
+ */
+/**************************************************************************************************/
+int open_status_sink(status_sink_t *sink, const char *specification);
+
+/**************************************************************************************************/
+/**
+ * @name    update_status
+ * @brief   Shows a status on every sink whose last shown status differs from it.
+ *
+ * @param sinks
+ * @param sink_count
+ * @param label
+ * @param icon
+ *
  * @return void
  */
 /**************************************************************************************************/
-void update_sketchybar(const char *label, const char *icon);
+void update_status(status_sink_t *sinks, int sink_count, const char *label, const char *icon);
 
 /**************************************************************************************************/
 /**
@@ -86,114 +477,1855 @@ void play_break_sound_notification();
 
 /**************************************************************************************************/
 /**
- * @name    run_timer
- * @brief   Runs a countdown timer for the specified number of minutes, updating sketchybar
- *          each second.
+ * @name    get_monotonic_nanoseconds
+ * @brief   Returns the CLOCK_MONOTONIC time, which wall clock changes never move.
  *
+ * @return int64_t  Nanoseconds
+ */
+/**************************************************************************************************/
+int64_t get_monotonic_nanoseconds(void);
+
+/**************************************************************************************************/
+/**
+ * @name    sleep_until
+ * @brief   Sleeps until a CLOCK_MONOTONIC deadline, returning at once if it has passed.
  *
- * @param timer_minutes
- * @param icon
- * @param timer_type
+ *          On Linux this is one clock_nanosleep with TIMER_ABSTIME, so time spent getting to the
+ *          call is not slept again. macOS has no clock_nanosleep; there the time left is slept
+ *          with nanosleep and checked again on waking, in case it woke early. Either way it
+ *          returns early once SIGINT or SIGTERM has interrupted the timer.
  *
+ * @param deadline  In nanoseconds
+ *
+ * @return void
  */
 /**************************************************************************************************/
-void run_timer(int timer_minutes, const char *icon, timer_type_t timer_type);
-
-/*------------------------------------------------------------------------------------------------*/
-/* FUNCTION DEFINITIONS                                                                           */
-/*------------------------------------------------------------------------------------------------*/
-
-void update_sketchybar(const char *label, const char *icon)
-{
-    char sketchybar_command[512];
+void sleep_until(int64_t deadline);
 
-    snprintf(sketchybar_command, sizeof(sketchybar_command),
-             "sketchybar --set pomodoro label=\"%s\" icon=\"%s\" drawing=on "
-             "--set pomodoro.divider drawing=on",
-             label, icon);
+/**************************************************************************************************/
+/**
+ * @name    handle_interrupt
+ * @brief   Makes the plain timer stop sleeping, record its session and exit.
+ *
+ * @param signal_number
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void handle_interrupt(int signal_number);
 
-    // System is a C function that passes a command to the host operating system. Very useful!
-    system(sketchybar_command);
-}
+/**************************************************************************************************/
+/**
+ * @name    open_session_journal
+ * @brief   Opens a journal for appending, creating it with its header if it does not exist.
+ *
+ * @param journal
+ * @param path
+ *
+ * @return int      0 on success, -1 with errno set if it cannot be opened or is not a journal
+ */
+/**************************************************************************************************/
+int open_session_journal(session_journal_t *journal, const char *path);
 
-void play_work_sound_notification()
-{
-    // Play a built in Apple library chime sound
-    system("afplay /System/Library/Sounds/Pop.aiff &");
-}
+/**************************************************************************************************/
+/**
+ * @name    append_session
+ * @brief   Appends one session to the journal in a single O_APPEND write, so it lands whole
+ *          even with another timer writing the same journal. Every JOURNAL_SYNC_RECORDS
+ *          records it is flushed to disk with fdatasync; in between, records survive the timer
+ *          being killed but not the machine losing power.
+ *
+ * @param journal           Nothing is written when no journal is kept
+ * @param type
+ * @param outcome
+ * @param start_time        Unix time, in seconds
+ * @param planned_seconds
+ * @param focused_seconds
+ *
+ * @return int      0 on success, -1 on failure
+ */
+/**************************************************************************************************/
+int append_session(session_journal_t *journal, timer_type_t type, session_outcome_t outcome,
+                   int64_t start_time, int64_t planned_seconds, int64_t focused_seconds);
 
-void play_break_sound_notification()
-{
-    // Play a built in Apple library chime sound
-    system("afplay /System/Library/Sounds/Purr.aiff &");
-}
+/**************************************************************************************************/
+/**
+ * @name    close_session_journal
+ * @brief   Flushes the records not yet synced to disk and closes the journal.
+ *
+ * @param journal
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void close_session_journal(session_journal_t *journal);
 
-void run_timer(int timer_minutes, const char *icon, timer_type_t timer_type)
-{
-    time_t start_time = time(NULL);
-    time_t end_time = start_time + (timer_minutes * 60);
-    int last_remaining_timestamp = -1;
+/**************************************************************************************************/
+/**
+ * @name    get_record_check
+ * @brief   Returns a 32-bit FNV-1a hash of a record's bytes, for telling whether an index entry
+ *          still describes the records it was computed from.
+ *
+ * @param record
+ *
+ * @return uint32_t
+ */
+/**************************************************************************************************/
+uint32_t get_record_check(const journal_record_t *record);
 
-    if (timer_type == timer_work)
-    {
-        play_work_sound_notification();
-    }
-    else if (timer_type == timer_break)
-    {
-        play_break_sound_notification();
-    }
+/**************************************************************************************************/
+/**
+ * @name    open_journal_view
+ * @brief   Maps a journal read-only and loads its index, summarising any blocks of records
+ *          appended since the index was last written and saving it back. An index written for
+ *          another journal, or for an earlier journal at the same path, is rebuilt. When the
+ *          index cannot be saved it is still used, kept in memory only.
+ *
+ * @param view
+ * @param path
+ *
+ * @return int      0 on success, -1 with errno set on failure
+ */
+/**************************************************************************************************/
+int open_journal_view(journal_view_t *view, const char *path);
 
-    while (1)
-    {
-        time_t current_time = time(NULL);
-        int remaining_time = (int)difftime(end_time, current_time);
+/**************************************************************************************************/
+/**
+ * @name    close_journal_view
+ * @brief   Unmaps the journal and frees the index.
+ *
+ * @param view
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void close_journal_view(journal_view_t *view);
 
-        if (remaining_time < 0)
-        {
-            break;
-        }
+/**************************************************************************************************/
+/**
+ * @name    sum_sessions
+ * @brief   Adds up the work of the sessions started in [from, to): whole index entries where a
+ *          block lies inside the range, records only where one straddles an end of it.
+ *
+ * @param view
+ * @param from      Unix time, in seconds
+ * @param to
+ * @param totals
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void sum_sessions(const journal_view_t *view, int64_t from, int64_t to,
+                  session_totals_t *totals);
 
-        // Since we are checking the time every ten seconds, and the remaining_time is a seconds
-        // value, we only update when the remaining_time changes by the whole second.
-        if (remaining_time != last_remaining_timestamp)
-        {
-            char time_stamp_string[16];
+/**************************************************************************************************/
+/**
+ * @name    sum_records
+ * @brief   Adds the work of the records started in [from, to) to totals, one record at a time.
+ *
+ * @param records
+ * @param count
+ * @param from
+ * @param to
+ * @param totals
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void sum_records(const journal_record_t *records, size_t count, int64_t from, int64_t to,
+                 session_totals_t *totals);
 
-            snprintf(time_stamp_string, sizeof(time_stamp_string), "%02d:%02d",
-                     remaining_time / 60, remaining_time % 60);
-            update_sketchybar(time_stamp_string, icon);
+/**************************************************************************************************/
+/**
+ * @name    get_local_day_start
+ * @brief   Returns local midnight at the start of the day day_offset days from the one time
+ *          falls in. Days are counted on the calendar, so one across a daylight saving change
+ *          is 23 or 25 hours long.
+ *
+ * @param time
+ * @param day_offset
+ *
+ * @return int64_t  Unix time, in seconds
+ */
+/**************************************************************************************************/
+int64_t get_local_day_start(int64_t time, int day_offset);
 
-            last_remaining_timestamp = remaining_time;
-        }
+/**************************************************************************************************/
+/**
+ * @name    format_duration
+ * @brief   Formats seconds as hours and minutes, such as "1h 15m" or "25m".
+ *
+ * @param text
+ * @param length
+ * @param seconds
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void format_duration(char *text, size_t length, uint64_t seconds);
 
-        // Check timer 10 times per second to ensure accuracy
-        usleep(100000);
-    }
-}
+/**************************************************************************************************/
+/**
+ * @name    count_streak
+ * @brief   Counts the days in a row, up to today, with at least one completed pomodoro. A
+ *          streak reaching yesterday is still running when today has none yet.
+ *
+ * @param view
+ * @param now       Unix time, in seconds
+ *
+ * @return int      Days
+ */
+/**************************************************************************************************/
+int count_streak(const journal_view_t *view, int64_t now);
 
-int main(int argc, char *argv[])
+/**************************************************************************************************/
+/**
+ * @name    run_stats
+ * @brief   Answers a query on a journal. With no query it shows today, this week and the
+ *          streak; "days N" and "weeks N" show the focused time of each of the last N days or
+ *          weeks, weeks starting on Monday.
+ *
+ * @param path
+ * @param word_count
+ * @param words
+ *
+ * @return int      Exit status: 0 if answered, 1 otherwise
+ */
+/**************************************************************************************************/
+int run_stats(const char *path, int word_count, char *words[]);
+
+/**************************************************************************************************/
+/**
+ * @name    format_remaining_time
+ * @brief   Formats a remaining time, already rounded up to whole display units, as MM:SS or as
+ *          whole minutes such as "25m".
+ *
+ * @param label
+ * @param length
+ * @param remaining_units   Seconds or minutes, as display says
+ * @param display
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void format_remaining_time(char *label, size_t length, int64_t remaining_units,
+                           timer_display_t display);
+
+/**************************************************************************************************/
+/**
+ * @name    run_timer
+ * @brief   Runs a countdown timer for the specified number of minutes, updating the status
+ *          sinks each time the displayed remaining time changes.
+ *
+ *          The timer only wakes up at those changes: it sleeps until the exact moment one fewer
+ *          second (or minute) remains, measured on CLOCK_MONOTONIC from the start.
+ *
+ * @param timer_minutes
+ * @param icon
+ * @param timer_type
+ * @param display       Whether to show seconds or whole minutes
+ * @param sinks         Where the remaining time is shown
+ * @param sink_count
+ * @param journal       Where the session is recorded, completed or interrupted
+ *
+ */
+/**************************************************************************************************/
+void run_timer(int timer_minutes, const char *icon, timer_type_t timer_type,
+               timer_display_t display, status_sink_t *sinks, int sink_count,
+               session_journal_t *journal);
+
+/**************************************************************************************************/
+/**
+ * @name    start_daemon_phase
+ * @brief   Starts a work or break phase of the daemon's full length, with its chime. A paused
+ *          daemon stays paused, with the whole phase left.
+ *
+ * @param pomodoro
+ * @param phase
+ * @param start_time    CLOCK_MONOTONIC start of the phase
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void start_daemon_phase(pomodoro_daemon_t *pomodoro, timer_type_t phase, int64_t start_time);
+
+/**************************************************************************************************/
+/**
+ * @name    record_daemon_phase
+ * @brief   Appends the current phase to the journal as it ends, however it ends.
+ *
+ * @param pomodoro
+ * @param outcome
+ * @param now       CLOCK_MONOTONIC time it ended
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void record_daemon_phase(pomodoro_daemon_t *pomodoro, session_outcome_t outcome, int64_t now);
+
+/**************************************************************************************************/
+/**
+ * @name    refresh_daemon
+ * @brief   Moves on to the next phase if the current one has ended, shows the remaining time on
+ *          the sinks, and arms the timerfd for the moment the displayed time next changes. A
+ *          paused daemon disarms it: nothing wakes the daemon until a request comes in.
+ *
+ * @param pomodoro
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void refresh_daemon(pomodoro_daemon_t *pomodoro);
+
+/**************************************************************************************************/
+/**
+ * @name    handle_control_request
+ * @brief   Carries out one control request and formats the reply. Requests: status, pause,
+ *          resume, skip, and set WORK [BREAK] with lengths in minutes. Every reply is one line,
+ *          "ok" and the status after the request, or "error" and the reason.
+ *
+ * @param pomodoro
+ * @param request   NUL-terminated, without the newline
+ * @param reply
+ * @param length
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void handle_control_request(pomodoro_daemon_t *pomodoro, char *request, char *reply,
+                            size_t length);
+
+/**************************************************************************************************/
+/**
+ * @name    accept_control_clients
+ * @brief   Accepts every pending connection on the control socket. When all the slots are in
+ *          use the connection is told so and closed.
+ *
+ * @param pomodoro
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void accept_control_clients(pomodoro_daemon_t *pomodoro);
+
+/**************************************************************************************************/
+/**
+ * @name    read_control_client
+ * @brief   Reads what a control connection has sent. Once a whole line (or the end of the
+ *          connection) is in, the request is carried out, answered and the connection closed.
+ *
+ * @param pomodoro
+ * @param client
+ *
+ * @return void
+ */
+/**************************************************************************************************/
+void read_control_client(pomodoro_daemon_t *pomodoro, control_client_t *client);
+
+/**************************************************************************************************/
+/**
+ * @name    open_control_socket
+ * @brief   Binds and listens on a Unix domain socket at path, usable by its owner only. A stale
+ *          socket left at path by an earlier run is replaced; a live one, or anything at path
+ *          that is not a socket, fails with EADDRINUSE.
+ *
+ * @param path
+ *
+ * @return int      The non-blocking listening socket, or -1 with errno set
+ */
+/**************************************************************************************************/
+int open_control_socket(const char *path);
+
+/**************************************************************************************************/
+/**
+ * @name    run_daemon
+ * @brief   Runs the timer as a daemon controlled through a Unix domain socket at path, until
+ *          SIGINT or SIGTERM. One thread waits in epoll_wait on the timerfd, the signalfd, the
+ *          control socket and its connections, so between events it uses no CPU at all.
+ *
+ *          Linux only; elsewhere it fails at once with ENOSYS.
+ *
+ * @param path
+ * @param work_minutes
+ * @param break_minutes
+ * @param display
+ * @param sinks
+ * @param sink_count
+ * @param journal
+ *
+ * @return int      Exit status: 0 after a signal, 1 if the daemon could not start
+ */
+/**************************************************************************************************/
+int run_daemon(const char *path, int work_minutes, int break_minutes, timer_display_t display,
+               status_sink_t *sinks, int sink_count, session_journal_t *journal);
+
+/**************************************************************************************************/
+/**
+ * @name    send_control_request
+ * @brief   Sends one request, made of the words given, to a daemon's control socket and prints
+ *          its reply.
+ *
+ * @param path
+ * @param word_count
+ * @param words
+ *
+ * @return int      Exit status: 0 if the daemon replied "ok", 1 otherwise
+ */
+/**************************************************************************************************/
+int send_control_request(const char *path, int word_count, char *words[]);
+
+/*------------------------------------------------------------------------------------------------*/
+/* FUNCTION DEFINITIONS                                                                           */
+/*------------------------------------------------------------------------------------------------*/
+
+pid_t spawn_program(char *const argv[])
+{
+    posix_spawnattr_t attributes;
+    sigset_t signals;
+    pid_t child;
+
+    // Signals the timer blocks (the daemon's) or ignores (SIGPIPE, for FIFOs) are its own
+    // business; the child starts with every signal unblocked and SIGPIPE back to its default
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attributes, &signals);
+    sigaddset(&signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &signals);
+
+    // Unlike most calls, posix_spawnp returns the error instead of setting errno
+    int error = posix_spawnp(&child, argv[0], NULL, &attributes, argv, environ);
+    posix_spawnattr_destroy(&attributes);
+    if (error != 0)
+    {
+        errno = error;
+        return -1;
+    }
+
+    return child;
+}
+
+void reap_children(void)
+{
+    while (waitpid(-1, NULL, WNOHANG) > 0)
+    {
+    }
+}
+
+int update_sketchybar(status_sink_t *sink, const char *label, const char *icon)
+{
+    char label_argument[STATUS_TEXT_LENGTH + sizeof("label=")];
+    char icon_argument[STATUS_TEXT_LENGTH + sizeof("icon=")];
+    int status;
+
+    (void)sink;
+    snprintf(label_argument, sizeof(label_argument), "label=%s", label);
+    snprintf(icon_argument, sizeof(icon_argument), "icon=%s", icon);
+
+    // Arguments reach sketchybar as they are, so nothing needs quoting
+    char *const argv[] = {
+        "sketchybar",
+        "--set", "pomodoro", label_argument, icon_argument, "drawing=on",
+        "--set", "pomodoro.divider", "drawing=on",
+        NULL
+    };
+
+    pid_t child = spawn_program(argv);
+    if (child < 0)
+    {
+        return -1;
+    }
+
+    while (waitpid(child, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+int format_status_line(char *line, size_t length, const char *label, const char *icon)
+{
+    int line_length = snprintf(line, length, "%s\t%s\n", icon, label);
+
+    return line_length < 0 || (size_t)line_length >= length ? -1 : line_length;
+}
+
+int write_stdout_status(status_sink_t *sink, const char *label, const char *icon)
+{
+    (void)sink;
+
+    if (printf("%s\t%s\n", icon, label) < 0 || fflush(stdout) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int write_file_status(status_sink_t *sink, const char *label, const char *icon)
+{
+    char temporary_path[STATUS_PATH_LENGTH + sizeof(".tmp")];
+    char line[2 * STATUS_TEXT_LENGTH];
+    int line_length = format_status_line(line, sizeof(line), label, icon);
+
+    if (line_length < 0)
+    {
+        return -1;
+    }
+
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", sink->target);
+
+    int descriptor = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0)
+    {
+        return -1;
+    }
+
+    bool failed = write(descriptor, line, (size_t)line_length) != line_length;
+    failed |= close(descriptor) != 0;
+
+    if (failed || rename(temporary_path, sink->target) != 0)
+    {
+        remove(temporary_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+int open_fifo_sink(status_sink_t *sink)
+{
+    struct stat status;
+
+    if (mkfifo(sink->target, 0644) != 0 && errno != EEXIST)
+    {
+        return -1;
+    }
+    if (stat(sink->target, &status) != 0 || !S_ISFIFO(status.st_mode))
+    {
+        errno = EEXIST;
+        return -1;
+    }
+
+    // A reader that goes away mid-write must not kill the timer
+    signal(SIGPIPE, SIG_IGN);
+    sink->descriptor = -1;
+
+    return 0;
+}
+
+int write_fifo_status(status_sink_t *sink, const char *label, const char *icon)
+{
+    char line[2 * STATUS_TEXT_LENGTH];
+    int line_length = format_status_line(line, sizeof(line), label, icon);
+
+    if (line_length < 0)
+    {
+        return -1;
+    }
+
+    if (sink->descriptor < 0)
+    {
+        // Non-blocking, so with no reader this fails with ENXIO instead of waiting for one
+        sink->descriptor = open(sink->target, O_WRONLY | O_NONBLOCK);
+        if (sink->descriptor < 0)
+        {
+            return errno == ENXIO ? 0 : -1;
+        }
+    }
+
+    // A line is shorter than PIPE_BUF, so it is written whole or not at all
+    if (write(sink->descriptor, line, (size_t)line_length) != line_length)
+    {
+        // EPIPE once the reader has gone, EAGAIN while it is not keeping up; either way the FIFO
+        // is reopened for whichever reader comes next
+        close_fifo_sink(sink);
+    }
+
+    return 0;
+}
+
+void close_fifo_sink(status_sink_t *sink)
+{
+    if (sink->descriptor >= 0)
+    {
+        close(sink->descriptor);
+        sink->descriptor = -1;
+    }
+}
+
+int open_status_sink(status_sink_t *sink, const char *specification)
+{
+    static const status_backend_t backends[] = {
+        { "sketchybar", false, NULL, update_sketchybar, NULL },
+        { "stdout", false, NULL, write_stdout_status, NULL },
+        { "file", true, NULL, write_file_status, NULL },
+        { "fifo", true, open_fifo_sink, write_fifo_status, close_fifo_sink }
+    };
+    const char *separator = strchr(specification, ':');
+    size_t name_length = separator != NULL ? (size_t)(separator - specification)
+                                           : strlen(specification);
+
+    memset(sink, 0, sizeof(*sink));
+    sink->descriptor = -1;
+
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+    {
+        if (strlen(backends[i].name) == name_length &&
+            strncmp(backends[i].name, specification, name_length) == 0)
+        {
+            sink->backend = &backends[i];
+        }
+    }
+
+    if (sink->backend == NULL ||
+        sink->backend->needs_target != (separator != NULL && separator[1] != '\0') ||
+        (separator != NULL && strlen(separator + 1) >= sizeof(sink->target)))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (separator != NULL)
+    {
+        strcpy(sink->target, separator + 1);
+    }
+
+    return sink->backend->open != NULL ? sink->backend->open(sink) : 0;
+}
+
+void update_status(status_sink_t *sinks, int sink_count, const char *label, const char *icon)
+{
+    for (int i = 0; i < sink_count; i++)
+    {
+        status_sink_t *sink = &sinks[i];
+
+        if (strcmp(sink->last_label, label) == 0 && strcmp(sink->last_icon, icon) == 0)
+        {
+            continue;
+        }
+
+        // Only a status that was shown counts as sent; a failed one is retried on the next update
+        if (sink->backend->update(sink, label, icon) == 0)
+        {
+            snprintf(sink->last_label, sizeof(sink->last_label), "%s", label);
+            snprintf(sink->last_icon, sizeof(sink->last_icon), "%s", icon);
+        }
+    }
+}
+
+void play_work_sound_notification()
+{
+    // Play a built in Apple library chime sound, without waiting for it to finish
+    char *const argv[] = { "afplay", "/System/Library/Sounds/Pop.aiff", NULL };
+    spawn_program(argv);
+}
+
+void play_break_sound_notification()
+{
+    // Play a built in Apple library chime sound, without waiting for it to finish
+    char *const argv[] = { "afplay", "/System/Library/Sounds/Purr.aiff", NULL };
+    spawn_program(argv);
+}
+
+int64_t get_monotonic_nanoseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+void sleep_until(int64_t deadline)
+{
+#ifdef __linux__
+    struct timespec wakeup = {
+        .tv_sec = (time_t)(deadline / NANOSECONDS_PER_SECOND),
+        .tv_nsec = (long)(deadline % NANOSECONDS_PER_SECOND)
+    };
+
+    // Returns the error instead of setting errno; EINTR means a signal cut the sleep short
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL) == EINTR &&
+           !timer_interrupted)
+    {
+    }
+#else
+    int64_t remaining = deadline - get_monotonic_nanoseconds();
+
+    while (remaining > 0 && !timer_interrupted)
+    {
+        struct timespec duration = {
+            .tv_sec = (time_t)(remaining / NANOSECONDS_PER_SECOND),
+            .tv_nsec = (long)(remaining % NANOSECONDS_PER_SECOND)
+        };
+
+        nanosleep(&duration, NULL);
+        remaining = deadline - get_monotonic_nanoseconds();
+    }
+#endif
+}
+
+void handle_interrupt(int signal_number)
+{
+    (void)signal_number;
+    timer_interrupted = 1;
+}
+
+int open_session_journal(session_journal_t *journal, const char *path)
+{
+    journal_header_t header;
+    struct stat status;
+
+    journal->unsynced = 0;
+    journal->descriptor = open(path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (journal->descriptor < 0)
+    {
+        return -1;
+    }
+
+    if (fstat(journal->descriptor, &status) != 0)
+    {
+        close_session_journal(journal);
+        return -1;
+    }
+
+    if (status.st_size == 0)
+    {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.size = sizeof(journal_record_t);
+
+        if (write(journal->descriptor, &header, sizeof(header)) != (ssize_t)sizeof(header))
+        {
+            close_session_journal(journal);
+            return -1;
+        }
+    }
+    else if (pread(journal->descriptor, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+             memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+             header.version != JOURNAL_VERSION || header.size != sizeof(journal_record_t))
+    {
+        close_session_journal(journal);
+        errno = EINVAL;
+        return -1;
+    }
+    else if ((status.st_size - (off_t)sizeof(header)) % (off_t)sizeof(journal_record_t) != 0)
+    {
+        // A record torn by a crash would shift every record appended after it
+        off_t torn = (status.st_size - (off_t)sizeof(header)) % (off_t)sizeof(journal_record_t);
+
+        if (ftruncate(journal->descriptor, status.st_size - torn) != 0)
+        {
+            close_session_journal(journal);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int append_session(session_journal_t *journal, timer_type_t type, session_outcome_t outcome,
+                   int64_t start_time, int64_t planned_seconds, int64_t focused_seconds)
+{
+    journal_record_t record;
+
+    if (journal->descriptor < 0)
+    {
+        return 0;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.start_time = start_time;
+    record.planned_seconds = (uint32_t)(planned_seconds > 0 ? planned_seconds : 0);
+    record.focused_seconds = (uint32_t)(focused_seconds > 0 ? focused_seconds : 0);
+    record.type = (uint8_t)type;
+    record.outcome = (uint8_t)outcome;
+
+    if (write(journal->descriptor, &record, sizeof(record)) != (ssize_t)sizeof(record))
+    {
+        return -1;
+    }
+
+    if (++journal->unsynced >= JOURNAL_SYNC_RECORDS)
+    {
+        journal->unsynced = 0;
+        return JOURNAL_SYNC(journal->descriptor);
+    }
+
+    return 0;
+}
+
+void close_session_journal(session_journal_t *journal)
+{
+    if (journal->descriptor < 0)
+    {
+        return;
+    }
+
+    if (journal->unsynced > 0)
+    {
+        JOURNAL_SYNC(journal->descriptor);
+    }
+    close(journal->descriptor);
+    journal->descriptor = -1;
+}
+
+void format_remaining_time(char *label, size_t length, int64_t remaining_units,
+                           timer_display_t display)
+{
+    if (display == display_minutes)
+    {
+        snprintf(label, length, "%dm", (int)remaining_units);
+    }
+    else
+    {
+        snprintf(label, length, "%02d:%02d", (int)(remaining_units / 60),
+                 (int)(remaining_units % 60));
+    }
+}
+
+void run_timer(int timer_minutes, const char *icon, timer_type_t timer_type,
+               timer_display_t display, status_sink_t *sinks, int sink_count,
+               session_journal_t *journal)
+{
+    int64_t unit = (display == display_minutes ? SECONDS_PER_MINUTE : 1) * NANOSECONDS_PER_SECOND;
+    int64_t length = (int64_t)timer_minutes * SECONDS_PER_MINUTE * NANOSECONDS_PER_SECOND;
+    int64_t start_time = get_monotonic_nanoseconds();
+    int64_t end_time = start_time + length;
+    int64_t wall_start_time = (int64_t)time(NULL);
+    int64_t last_remaining_units = -1;
+
+    // The previous timer's chime has long finished
+    reap_children();
+
+    if (timer_type == timer_work)
+    {
+        play_work_sound_notification();
+    }
+    else if (timer_type == timer_break)
+    {
+        play_break_sound_notification();
+    }
+
+    while (!timer_interrupted)
+    {
+        int64_t remaining_time = end_time - get_monotonic_nanoseconds();
+
+        if (remaining_time <= 0)
+        {
+            break;
+        }
+
+        // Rounded up, so a 25 minute timer reads 25:00 for its first second and 00:01 for its
+        // last, and ends exactly 25 minutes after it started
+        int64_t remaining_units = (remaining_time + unit - 1) / unit;
+
+        // A sleep that ended a little early finds the same value; the sinks are already showing it
+        if (remaining_units != last_remaining_units)
+        {
+            char time_stamp_string[16];
+
+            format_remaining_time(time_stamp_string, sizeof(time_stamp_string), remaining_units,
+                                  display);
+            update_status(sinks, sink_count, time_stamp_string, icon);
+
+            last_remaining_units = remaining_units;
+        }
+
+        // Wake up exactly when the displayed value next changes
+        sleep_until(end_time - (remaining_units - 1) * unit);
+    }
+
+    int64_t focused_time = get_monotonic_nanoseconds() - start_time;
+    append_session(journal, timer_type, timer_interrupted ? session_interrupted : session_completed,
+                   wall_start_time, length / NANOSECONDS_PER_SECOND,
+                   (focused_time < length ? focused_time : length) / NANOSECONDS_PER_SECOND);
+}
+
+#ifdef __linux__
+void start_daemon_phase(pomodoro_daemon_t *pomodoro, timer_type_t phase, int64_t start_time)
+{
+    int64_t length = (int64_t)pomodoro->minutes[phase] * SECONDS_PER_MINUTE *
+                     NANOSECONDS_PER_SECOND;
+
+    pomodoro->phase = phase;
+    pomodoro->phase_length = length;
+    pomodoro->phase_start = (int64_t)time(NULL) -
+                            (get_monotonic_nanoseconds() - start_time) / NANOSECONDS_PER_SECOND;
+    pomodoro->end_time = start_time + length;
+    pomodoro->remaining_time = length;
+
+    if (phase == timer_work)
+    {
+        play_work_sound_notification();
+    }
+    else
+    {
+        play_break_sound_notification();
+    }
+}
+
+void record_daemon_phase(pomodoro_daemon_t *pomodoro, session_outcome_t outcome, int64_t now)
+{
+    int64_t remaining_time = pomodoro->paused ? pomodoro->remaining_time
+                                              : pomodoro->end_time - now;
+    int64_t focused_time = pomodoro->phase_length - (remaining_time > 0 ? remaining_time : 0);
+
+    append_session(pomodoro->journal, pomodoro->phase, outcome, pomodoro->phase_start,
+                   pomodoro->phase_length / NANOSECONDS_PER_SECOND,
+                   focused_time / NANOSECONDS_PER_SECOND);
+}
+
+void refresh_daemon(pomodoro_daemon_t *pomodoro)
+{
+    int64_t unit = (pomodoro->display == display_minutes ? SECONDS_PER_MINUTE : 1) *
+                   NANOSECONDS_PER_SECOND;
+    int64_t now = get_monotonic_nanoseconds();
+
+    // The next phase starts where the last one ended, however late the wakeup came
+    while (!pomodoro->paused && pomodoro->end_time <= now)
+    {
+        record_daemon_phase(pomodoro, session_completed, pomodoro->end_time);
+        start_daemon_phase(pomodoro, pomodoro->phase == timer_work ? timer_break : timer_work,
+                           pomodoro->end_time);
+    }
+
+    int64_t remaining_time = pomodoro->paused ? pomodoro->remaining_time
+                                              : pomodoro->end_time - now;
+    int64_t remaining_units = (remaining_time + unit - 1) / unit;
+    char label[16];
+
+    format_remaining_time(label, sizeof(label), remaining_units, pomodoro->display);
+    update_status(pomodoro->sinks, pomodoro->sink_count, label,
+                  pomodoro->paused ? PAUSED_TIMER_ICON
+                  : pomodoro->phase == timer_work ? WORK_TIMER_ICON : BREAK_TIMER_ICON);
+
+    // A zero it_value disarms the timer
+    struct itimerspec wakeup = { 0 };
+    if (!pomodoro->paused)
+    {
+        int64_t deadline = pomodoro->end_time - (remaining_units - 1) * unit;
+
+        wakeup.it_value.tv_sec = (time_t)(deadline / NANOSECONDS_PER_SECOND);
+        wakeup.it_value.tv_nsec = (long)(deadline % NANOSECONDS_PER_SECOND);
+    }
+    timerfd_settime(pomodoro->timer, TFD_TIMER_ABSTIME, &wakeup, NULL);
+}
+
+void handle_control_request(pomodoro_daemon_t *pomodoro, char *request, char *reply,
+                            size_t length)
+{
+    char *context = NULL;
+    char *command = strtok_r(request, " \t\r", &context);
+
+    // Catches up with a phase that ended after the timerfd last fired, so a pause never stops
+    // a phase with no time left
+    refresh_daemon(pomodoro);
+    int64_t now = get_monotonic_nanoseconds();
+
+    if (command == NULL)
+    {
+        snprintf(reply, length, "error empty request\n");
+        return;
+    }
+
+    if (strcmp(command, "pause") == 0)
+    {
+        if (!pomodoro->paused)
+        {
+            pomodoro->remaining_time = pomodoro->end_time - now;
+            pomodoro->paused = true;
+        }
+    }
+    else if (strcmp(command, "resume") == 0)
+    {
+        if (pomodoro->paused)
+        {
+            pomodoro->end_time = now + pomodoro->remaining_time;
+            pomodoro->paused = false;
+        }
+    }
+    else if (strcmp(command, "skip") == 0)
+    {
+        record_daemon_phase(pomodoro, session_skipped, now);
+        start_daemon_phase(pomodoro, pomodoro->phase == timer_work ? timer_break : timer_work,
+                           now);
+    }
+    else if (strcmp(command, "set") == 0)
+    {
+        int minutes[2] = { pomodoro->minutes[timer_work], pomodoro->minutes[timer_break] };
+        int count = 0;
+        char *word;
+
+        while ((word = strtok_r(NULL, " \t\r", &context)) != NULL)
+        {
+            char *end;
+            long value = strtol(word, &end, 10);
+
+            if (count == 2 || *end != '\0' || value < 1 || value > TIMER_MINUTES_MAX)
+            {
+                snprintf(reply, length, "error usage: set WORK [BREAK], 1 to %d minutes\n",
+                         TIMER_MINUTES_MAX);
+                return;
+            }
+            minutes[count++] = (int)value;
+        }
+        if (count == 0)
+        {
+            snprintf(reply, length, "error usage: set WORK [BREAK], 1 to %d minutes\n",
+                     TIMER_MINUTES_MAX);
+            return;
+        }
+
+        pomodoro->minutes[timer_work] = minutes[0];
+        pomodoro->minutes[timer_break] = minutes[1];
+    }
+    else if (strcmp(command, "status") != 0)
+    {
+        snprintf(reply, length, "error unknown request %s\n", command);
+        return;
+    }
+
+    refresh_daemon(pomodoro);
+
+    // Queries always get seconds, whatever the sinks show
+    int64_t remaining_time = pomodoro->paused ? pomodoro->remaining_time
+                                              : pomodoro->end_time - now;
+    int64_t remaining_seconds = (remaining_time + NANOSECONDS_PER_SECOND - 1) /
+                                NANOSECONDS_PER_SECOND;
+
+    snprintf(reply, length, "ok %s %s %02d:%02d work=%d break=%d\n",
+             pomodoro->phase == timer_work ? "work" : "break",
+             pomodoro->paused ? "paused" : "running",
+             (int)(remaining_seconds / 60), (int)(remaining_seconds % 60),
+             pomodoro->minutes[timer_work], pomodoro->minutes[timer_break]);
+}
+
+void accept_control_clients(pomodoro_daemon_t *pomodoro)
+{
+    int descriptor;
+
+    while ((descriptor = accept4(pomodoro->listener, NULL, NULL,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        control_client_t *client = NULL;
+
+        for (int i = 0; i < CONTROL_CLIENT_MAX && client == NULL; i++)
+        {
+            if (pomodoro->clients[i].descriptor < 0)
+            {
+                client = &pomodoro->clients[i];
+            }
+        }
+
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+        if (client == NULL || epoll_ctl(pomodoro->epoll, EPOLL_CTL_ADD, descriptor, &event) != 0)
+        {
+            const char busy[] = "error busy\n";
+
+            send(descriptor, busy, sizeof(busy) - 1, MSG_NOSIGNAL);
+            close(descriptor);
+            continue;
+        }
+
+        client->descriptor = descriptor;
+        client->length = 0;
+    }
+}
+
+void read_control_client(pomodoro_daemon_t *pomodoro, control_client_t *client)
+{
+    char reply[CONTROL_REPLY_LENGTH];
+    char *newline = NULL;
+
+    while (newline == NULL)
+    {
+        ssize_t length = recv(client->descriptor, client->request + client->length,
+                              sizeof(client->request) - 1 - client->length, 0);
+
+        if (length < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        if (length < 0 || (length == 0 && client->length == 0))
+        {
+            // Gone before asking anything; closing also takes it out of the epoll set
+            close(client->descriptor);
+            client->descriptor = -1;
+            return;
+        }
+
+        client->request[client->length + (size_t)length] = '\0';
+        newline = strchr(client->request + client->length, '\n');
+        client->length += (size_t)length;
+
+        // A request ended by closing the connection instead of a newline is still carried out
+        if (length == 0)
+        {
+            newline = client->request + client->length;
+        }
+        else if (newline == NULL && client->length == sizeof(client->request) - 1)
+        {
+            break;
+        }
+    }
+
+    if (newline == NULL)
+    {
+        snprintf(reply, sizeof(reply), "error request too long\n");
+    }
+    else
+    {
+        *newline = '\0';
+        handle_control_request(pomodoro, client->request, reply, sizeof(reply));
+    }
+
+    // The reply is far smaller than a fresh socket's buffer, so one send never blocks
+    send(client->descriptor, reply, strlen(reply), MSG_NOSIGNAL);
+    close(client->descriptor);
+    client->descriptor = -1;
+}
+#endif
+
+int open_control_socket(const char *path)
+{
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+
+    // Only a socket nobody answers on is stale; a running daemon keeps its socket, and a path
+    // that is not a socket is never removed (connect refuses a regular file too)
+    struct stat status;
+    if (lstat(path, &status) == 0)
+    {
+        int probe = S_ISSOCK(status.st_mode) ? socket(AF_UNIX, SOCK_STREAM, 0) : -1;
+        bool stale = probe >= 0 &&
+                     connect(probe, (struct sockaddr *)&address, sizeof(address)) != 0 &&
+                     errno == ECONNREFUSED;
+
+        if (probe >= 0)
+        {
+            close(probe);
+        }
+        if (!stale)
+        {
+            close(listener);
+            errno = EADDRINUSE;
+            return -1;
+        }
+        unlink(path);
+    }
+
+    mode_t mask = umask(077);
+    int bound = bind(listener, (struct sockaddr *)&address, sizeof(address));
+    umask(mask);
+
+    if (bound != 0 || listen(listener, CONTROL_CLIENT_MAX) != 0 ||
+        fcntl(listener, F_SETFL, O_NONBLOCK) != 0 || fcntl(listener, F_SETFD, FD_CLOEXEC) != 0)
+    {
+        int error = errno;
+
+        if (bound == 0)
+        {
+            unlink(path);
+        }
+        close(listener);
+        errno = error;
+        return -1;
+    }
+
+    return listener;
+}
+
+int run_daemon(const char *path, int work_minutes, int break_minutes, timer_display_t display,
+               status_sink_t *sinks, int sink_count, session_journal_t *journal)
+{
+#ifdef __linux__
+    static pomodoro_daemon_t pomodoro;
+    sigset_t signals;
+
+    pomodoro.minutes[timer_work] = work_minutes;
+    pomodoro.minutes[timer_break] = break_minutes;
+    pomodoro.display = display;
+    pomodoro.sinks = sinks;
+    pomodoro.sink_count = sink_count;
+    pomodoro.journal = journal;
+    snprintf(pomodoro.path, sizeof(pomodoro.path), "%s", path);
+    for (int i = 0; i < CONTROL_CLIENT_MAX; i++)
+    {
+        pomodoro.clients[i].descriptor = -1;
+    }
+
+    // Delivered through the signalfd instead of interrupting whatever the loop is doing
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &signals, NULL);
+
+    pomodoro.listener = open_control_socket(path);
+    if (pomodoro.listener < 0)
+    {
+        fprintf(stderr, "Unable to listen on %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    pomodoro.epoll = epoll_create1(EPOLL_CLOEXEC);
+    pomodoro.timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    pomodoro.signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    int *watched[] = { &pomodoro.timer, &pomodoro.signals, &pomodoro.listener };
+    for (size_t i = 0; i < sizeof(watched) / sizeof(watched[0]); i++)
+    {
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = watched[i] };
+
+        if (pomodoro.epoll < 0 || *watched[i] < 0 ||
+            epoll_ctl(pomodoro.epoll, EPOLL_CTL_ADD, *watched[i], &event) != 0)
+        {
+            fprintf(stderr, "Unable to start the daemon: %s\n", strerror(errno));
+            unlink(path);
+            return 1;
+        }
+    }
+
+    start_daemon_phase(&pomodoro, timer_work, get_monotonic_nanoseconds());
+    refresh_daemon(&pomodoro);
+
+    while (!pomodoro.stopping)
+    {
+        struct epoll_event events[DAEMON_EVENT_MAX];
+        int count = epoll_wait(pomodoro.epoll, events, DAEMON_EVENT_MAX, -1);
+
+        if (count < 0 && errno != EINTR)
+        {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            void *source = events[i].data.ptr;
+
+            if (source == &pomodoro.timer)
+            {
+                uint64_t expirations;
+
+                // Draining it; the time is read from the clock, not counted in expirations
+                if (read(pomodoro.timer, &expirations, sizeof(expirations)) > 0)
+                {
+                    refresh_daemon(&pomodoro);
+                }
+            }
+            else if (source == &pomodoro.signals)
+            {
+                struct signalfd_siginfo information;
+
+                while (read(pomodoro.signals, &information, sizeof(information)) ==
+                       sizeof(information))
+                {
+                    if (information.ssi_signo == SIGCHLD)
+                    {
+                        reap_children();
+                    }
+                    else
+                    {
+                        pomodoro.stopping = true;
+                    }
+                }
+            }
+            else if (source == &pomodoro.listener)
+            {
+                accept_control_clients(&pomodoro);
+            }
+            else
+            {
+                read_control_client(&pomodoro, source);
+            }
+        }
+    }
+
+    record_daemon_phase(&pomodoro, session_interrupted, get_monotonic_nanoseconds());
+
+    for (int i = 0; i < CONTROL_CLIENT_MAX; i++)
+    {
+        if (pomodoro.clients[i].descriptor >= 0)
+        {
+            close(pomodoro.clients[i].descriptor);
+        }
+    }
+    for (int i = 0; i < sink_count; i++)
+    {
+        if (sinks[i].backend->close != NULL)
+        {
+            sinks[i].backend->close(&sinks[i]);
+        }
+    }
+    close(pomodoro.signals);
+    close(pomodoro.timer);
+    close(pomodoro.epoll);
+    close(pomodoro.listener);
+    unlink(pomodoro.path);
+    sigprocmask(SIG_UNBLOCK, &signals, NULL);
+
+    return 0;
+#else
+    (void)path;
+    (void)work_minutes;
+    (void)break_minutes;
+    (void)display;
+    (void)sinks;
+    (void)sink_count;
+    (void)journal;
+
+    // epoll, timerfd and signalfd have no drop-in equivalent here
+    errno = ENOSYS;
+    fprintf(stderr, "Unable to run as a daemon: %s\n", strerror(errno));
+    return 1;
+#endif
+}
+
+int send_control_request(const char *path, int word_count, char *words[])
+{
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    char request[CONTROL_REQUEST_LENGTH];
+    size_t length = 0;
+
+    for (int i = 0; i < word_count; i++)
+    {
+        int written = snprintf(request + length, sizeof(request) - length, "%s%s",
+                               i == 0 ? "" : " ", words[i]);
+
+        if (written < 0 || (size_t)written >= sizeof(request) - length - 1)
+        {
+            fprintf(stderr, "Request too long\n");
+            return 1;
+        }
+        length += (size_t)written;
+    }
+    request[length++] = '\n';
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0 || connect(descriptor, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+        write(descriptor, request, length) != (ssize_t)length)
+    {
+        fprintf(stderr, "Unable to reach the daemon at %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    char reply[CONTROL_REPLY_LENGTH];
+    size_t reply_length = 0;
+    ssize_t received;
+
+    while (reply_length < sizeof(reply) - 1 &&
+           ((received = read(descriptor, reply + reply_length,
+                             sizeof(reply) - 1 - reply_length)) > 0 ||
+            (received < 0 && errno == EINTR)))
+    {
+        reply_length += received > 0 ? (size_t)received : 0;
+    }
+    reply[reply_length] = '\0';
+    close(descriptor);
+
+    fputs(reply, stdout);
+
+    return strncmp(reply, "ok", 2) == 0 ? 0 : 1;
+}
+
+uint32_t get_record_check(const journal_record_t *record)
+{
+    const unsigned char *bytes = (const unsigned char *)record;
+    uint32_t check = 2166136261u;
+
+    for (size_t i = 0; i < sizeof(*record); i++)
+    {
+        check = (check ^ bytes[i]) * 16777619u;
+    }
+
+    return check;
+}
+
+int open_journal_view(journal_view_t *view, const char *path)
+{
+    journal_header_t header;
+    struct stat status;
+
+    memset(view, 0, sizeof(*view));
+
+    int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        return -1;
+    }
+    if (fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        return -1;
+    }
+    if (status.st_size < (off_t)sizeof(header))
+    {
+        close(descriptor);
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint64_t journal_device = (uint64_t)status.st_dev;
+    uint64_t journal_inode = (uint64_t)status.st_ino;
+
+    // The mapping outlives the descriptor
+    view->mapping_length = (size_t)status.st_size;
+    view->mapping = mmap(NULL, view->mapping_length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (view->mapping == MAP_FAILED)
+    {
+        view->mapping = NULL;
+        return -1;
+    }
+
+    memcpy(&header, view->mapping, sizeof(header));
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != JOURNAL_VERSION || header.size != sizeof(journal_record_t))
+    {
+        close_journal_view(view);
+        errno = EINVAL;
+        return -1;
+    }
+
+    view->records = (const journal_record_t *)((const char *)view->mapping + sizeof(header));
+    view->record_count = (view->mapping_length - sizeof(header)) / sizeof(journal_record_t);
+
+    size_t block_count = view->record_count / JOURNAL_INDEX_BLOCK;
+    view->index = calloc(block_count > 0 ? block_count : 1, sizeof(journal_index_entry_t));
+    if (view->index == NULL)
+    {
+        close_journal_view(view);
+        return -1;
+    }
+
+    char index_path[STATUS_PATH_LENGTH + sizeof(".index")];
+    snprintf(index_path, sizeof(index_path), "%s.index", path);
+
+    // Without write access to the directory the index is only built in memory
+    int index_descriptor = open(index_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (index_descriptor < 0)
+    {
+        index_descriptor = open(index_path, O_RDONLY | O_CLOEXEC);
+    }
+
+    size_t saved_count = 0;
+    bool valid = false;
+
+    if (index_descriptor >= 0 && fstat(index_descriptor, &status) == 0 &&
+        pread(index_descriptor, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        memcmp(header.magic, JOURNAL_INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+        header.version == JOURNAL_VERSION && header.size == JOURNAL_INDEX_BLOCK &&
+        header.journal_device == journal_device && header.journal_inode == journal_inode)
+    {
+        saved_count = ((size_t)status.st_size - sizeof(header)) / sizeof(journal_index_entry_t);
+
+        // More entries than blocks means the journal was replaced; the index is rebuilt
+        valid = saved_count <= block_count;
+        if (!valid)
+        {
+            saved_count = 0;
+        }
+    }
+
+    if (saved_count > 0)
+    {
+        ssize_t length = pread(index_descriptor, view->index,
+                               saved_count * sizeof(journal_index_entry_t), sizeof(header));
+
+        saved_count = length > 0 ? (size_t)length / sizeof(journal_index_entry_t) : 0;
+    }
+
+    // A journal rewritten in place keeps its inode, so every saved entry is checked against the
+    // last record of its block: one record read per block, where a rebuild reads them all
+    for (size_t block = 0; block < saved_count; block++)
+    {
+        const journal_record_t *last = &view->records[(block + 1) * JOURNAL_INDEX_BLOCK - 1];
+
+        if (view->index[block].last_record_check != get_record_check(last))
+        {
+            memset(view->index, 0, saved_count * sizeof(journal_index_entry_t));
+            saved_count = 0;
+            valid = false;
+        }
+    }
+
+    for (size_t block = saved_count; block < block_count; block++)
+    {
+        const journal_record_t *record = &view->records[block * JOURNAL_INDEX_BLOCK];
+        journal_index_entry_t *entry = &view->index[block];
+
+        entry->min_start = record->start_time;
+        entry->max_start = record->start_time;
+        for (size_t i = 0; i < JOURNAL_INDEX_BLOCK; i++, record++)
+        {
+            if (record->start_time < entry->min_start)
+            {
+                entry->min_start = record->start_time;
+            }
+            if (record->start_time > entry->max_start)
+            {
+                entry->max_start = record->start_time;
+            }
+            if (record->type == timer_work)
+            {
+                entry->focused_seconds += record->focused_seconds;
+                entry->pomodoros += record->outcome == session_completed;
+            }
+        }
+        entry->last_record_check = get_record_check(record - 1);
+    }
+    view->index_count = block_count;
+
+    if (index_descriptor >= 0 && block_count > saved_count)
+    {
+        if (!valid)
+        {
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, JOURNAL_INDEX_MAGIC, sizeof(header.magic));
+            header.version = JOURNAL_VERSION;
+            header.size = JOURNAL_INDEX_BLOCK;
+            header.journal_device = journal_device;
+            header.journal_inode = journal_inode;
+
+            if (ftruncate(index_descriptor, 0) != 0 ||
+                pwrite(index_descriptor, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+            {
+                block_count = saved_count;
+            }
+        }
+
+        // Best effort: an index left short is extended by the next query
+        size_t length = (block_count - saved_count) * sizeof(journal_index_entry_t);
+        if (length > 0 &&
+            pwrite(index_descriptor, &view->index[saved_count], length,
+                   (off_t)(sizeof(header) + saved_count * sizeof(journal_index_entry_t))) < 0)
+        {
+            ftruncate(index_descriptor, (off_t)(sizeof(header) +
+                                                saved_count * sizeof(journal_index_entry_t)));
+        }
+    }
+    if (index_descriptor >= 0)
+    {
+        close(index_descriptor);
+    }
+
+    return 0;
+}
+
+void close_journal_view(journal_view_t *view)
+{
+    if (view->mapping != NULL)
+    {
+        munmap(view->mapping, view->mapping_length);
+    }
+    free(view->index);
+    memset(view, 0, sizeof(*view));
+}
+
+void sum_records(const journal_record_t *records, size_t count, int64_t from, int64_t to,
+                 session_totals_t *totals)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (records[i].type == timer_work && records[i].start_time >= from &&
+            records[i].start_time < to)
+        {
+            totals->focused_seconds += records[i].focused_seconds;
+            totals->pomodoros += records[i].outcome == session_completed;
+        }
+    }
+}
+
+void sum_sessions(const journal_view_t *view, int64_t from, int64_t to,
+                  session_totals_t *totals)
+{
+    totals->focused_seconds = 0;
+    totals->pomodoros = 0;
+
+    for (size_t block = 0; block < view->index_count; block++)
+    {
+        const journal_index_entry_t *entry = &view->index[block];
+
+        if (entry->max_start < from || entry->min_start >= to)
+        {
+            continue;
+        }
+
+        if (entry->min_start >= from && entry->max_start < to)
+        {
+            totals->focused_seconds += entry->focused_seconds;
+            totals->pomodoros += entry->pomodoros;
+        }
+        else
+        {
+            sum_records(&view->records[block * JOURNAL_INDEX_BLOCK], JOURNAL_INDEX_BLOCK, from,
+                        to, totals);
+        }
+    }
+
+    // Records after the last full block have no index entry yet
+    size_t indexed = view->index_count * JOURNAL_INDEX_BLOCK;
+    sum_records(&view->records[indexed], view->record_count - indexed, from, to, totals);
+}
+
+int64_t get_local_day_start(int64_t time, int day_offset)
+{
+    time_t seconds = (time_t)time;
+    struct tm day;
+
+    localtime_r(&seconds, &day);
+    day.tm_mday += day_offset;
+    day.tm_hour = 0;
+    day.tm_min = 0;
+    day.tm_sec = 0;
+    day.tm_isdst = -1;
+
+    // mktime carries an out of range day into the month and year
+    return (int64_t)mktime(&day);
+}
+
+void format_duration(char *text, size_t length, uint64_t seconds)
+{
+    uint64_t minutes = seconds / SECONDS_PER_MINUTE;
+
+    if (minutes >= 60)
+    {
+        snprintf(text, length, "%lluh %02llum", (unsigned long long)(minutes / 60),
+                 (unsigned long long)(minutes % 60));
+    }
+    else
+    {
+        snprintf(text, length, "%llum", (unsigned long long)minutes);
+    }
+}
+
+int count_streak(const journal_view_t *view, int64_t now)
+{
+    int streak = 0;
+
+    for (int offset = 0; ; offset--)
+    {
+        session_totals_t totals;
+
+        sum_sessions(view, get_local_day_start(now, offset), get_local_day_start(now, offset + 1),
+                     &totals);
+        if (totals.pomodoros > 0)
+        {
+            streak++;
+        }
+        else if (offset < 0)
+        {
+            break;
+        }
+    }
+
+    return streak;
+}
+
+int run_stats(const char *path, int word_count, char *words[])
+{
+    int64_t now = (int64_t)time(NULL);
+    time_t seconds = (time_t)now;
+    journal_view_t view;
+    struct tm today;
+    int periods = 0;
+    bool weeks = false;
+
+    // Usage: pomodoro stats JOURNAL [days N | weeks N]
+    if (word_count == 2 && (strcmp(words[0], "days") == 0 || strcmp(words[0], "weeks") == 0))
+    {
+        weeks = strcmp(words[0], "weeks") == 0;
+        periods = atoi(words[1]);
+    }
+    if (word_count != 0 && periods < 1)
+    {
+        fprintf(stderr, "Usage: pomodoro stats JOURNAL [days N | weeks N]\n");
+        return 1;
+    }
+
+    if (open_journal_view(&view, path) != 0)
+    {
+        fprintf(stderr, "Unable to read the journal %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    localtime_r(&seconds, &today);
+    int monday = -((today.tm_wday + 6) % 7);
+    session_totals_t totals;
+    char duration[32];
+
+    if (periods == 0)
+    {
+        sum_sessions(&view, get_local_day_start(now, 0), get_local_day_start(now, 1), &totals);
+        format_duration(duration, sizeof(duration), totals.focused_seconds);
+        printf("today      %s focused, %u pomodoros\n", duration, totals.pomodoros);
+
+        sum_sessions(&view, get_local_day_start(now, monday), get_local_day_start(now, 1),
+                     &totals);
+        format_duration(duration, sizeof(duration), totals.focused_seconds);
+        printf("this week  %s focused, %u pomodoros\n", duration, totals.pomodoros);
+
+        int streak = count_streak(&view, now);
+        printf("streak     %d day%s\n", streak, streak == 1 ? "" : "s");
+    }
+
+    // Oldest first, ending with the current day or week
+    for (int period = periods - 1; period >= 0; period--)
+    {
+        int first_day = weeks ? monday - 7 * period : -period;
+        int64_t from = get_local_day_start(now, first_day);
+        time_t from_seconds = (time_t)from;
+        struct tm day;
+        char date[16];
+
+        sum_sessions(&view, from, get_local_day_start(now, first_day + (weeks ? 7 : 1)),
+                     &totals);
+        format_duration(duration, sizeof(duration), totals.focused_seconds);
+        localtime_r(&from_seconds, &day);
+        strftime(date, sizeof(date), "%Y-%m-%d", &day);
+        printf("%s%s  %7s  %u pomodoros\n", weeks ? "week of " : "", date, duration,
+               totals.pomodoros);
+    }
+
+    close_journal_view(&view);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
 {
     int work_timer_minutes = WORK_TIMER_DEFAULT_MINUTES;
     int break_timer_minutes = BREAK_TIMER_DEFAULT_MINUTES;
-    // atoi is a C standard library function that converts a string to an integer
-    if (argc >= 2)
+    timer_display_t display = display_seconds;
+    int minute_arguments = 0;
+    status_sink_t sinks[STATUS_SINK_MAX];
+    int sink_count = 0;
+    const char *daemon_path = NULL;
+    session_journal_t journal = { .descriptor = -1, .unsynced = 0 };
+
+    // Usage: pomodoro --control SOCKET REQUEST...
+    if (argc >= 3 && strcmp(argv[1], "--control") == 0)
+    {
+        return send_control_request(argv[2], argc - 3, argv + 3);
+    }
+
+    // Usage: pomodoro stats JOURNAL [days N | weeks N]
+    if (argc >= 3 && strcmp(argv[1], "stats") == 0)
+    {
+        return run_stats(argv[2], argc - 3, argv + 3);
+    }
+
+    // Usage: pomodoro [--daemon SOCKET] [--journal JOURNAL] [--minutes] [--sink SINK]...
+    //                 [work minutes [break minutes]]
+    for (int i = 1; i < argc; i++)
     {
-        work_timer_minutes = atoi(argv[1]);
+        if (strcmp(argv[i], "--daemon") == 0 && i + 1 < argc)
+        {
+            daemon_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc)
+        {
+            if (open_session_journal(&journal, argv[++i]) != 0)
+            {
+                fprintf(stderr, "Unable to use journal %s: %s\n", argv[i], strerror(errno));
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--minutes") == 0)
+        {
+            display = display_minutes;
+        }
+        else if (strcmp(argv[i], "--sink") == 0 && i + 1 < argc)
+        {
+            if (sink_count == STATUS_SINK_MAX)
+            {
+                fprintf(stderr, "At most %d sinks can be used\n", STATUS_SINK_MAX);
+                return 1;
+            }
+            if (open_status_sink(&sinks[sink_count], argv[++i]) != 0)
+            {
+                fprintf(stderr, "Unable to use sink %s: %s\n", argv[i], strerror(errno));
+                return 1;
+            }
+            sink_count++;
+        }
+        // atoi is a C standard library function that converts a string to an integer
+        else if (minute_arguments == 0)
+        {
+            work_timer_minutes = atoi(argv[i]);
+            minute_arguments++;
+        }
+        else if (minute_arguments == 1)
+        {
+            break_timer_minutes = atoi(argv[i]);
+            minute_arguments++;
+        }
     }
 
-    if (argc >= 3)
+    // Without a --sink, the timer shows in sketchybar as it always has
+    if (sink_count == 0)
     {
-        break_timer_minutes = atoi(argv[2]);
+        open_status_sink(&sinks[sink_count++], "sketchybar");
     }
 
-    while (1)
+    if (daemon_path != NULL)
     {
-        // Monocraft Nerd Font hourglass icon: ⌛ (U+231B)
-        run_timer(work_timer_minutes, "\u231B", timer_work);
+        int status = run_daemon(daemon_path, work_timer_minutes, break_timer_minutes, display,
+                                sinks, sink_count, &journal);
+
+        close_session_journal(&journal);
+        return status;
+    }
+
+    // No SA_RESTART: the sleep must return so the interrupted session is recorded
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_interrupt;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
 
-        // Monocraft Nerd Font scissors icon: ⚓ (U+2693) | ✂ (U+2702)
-        run_timer(break_timer_minutes, "\u2693", timer_break);
+    while (!timer_interrupted)
+    {
+        run_timer(work_timer_minutes, WORK_TIMER_ICON, timer_work, display, sinks, sink_count,
+                  &journal);
+        if (!timer_interrupted)
+        {
+            run_timer(break_timer_minutes, BREAK_TIMER_ICON, timer_break, display, sinks,
+                      sink_count, &journal);
+        }
     }
 
+    close_session_journal(&journal);
+
     return 0;
 }
@@ -0,0 +1,58 @@
+#!/bin/sh
+# Runs a one minute work timer against the stub sketchybar and checks that sketchybar was spawned
+# exactly once per label change: 01:00 down to 00:01 for work, then 01:00 for the break. Takes a
+# little over a minute. Usage: tests/sketchybar_updates.sh, with CC picking the compiler.
+set -eu
+
+tests=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+timer=
+trap '[ -n "$timer" ] && kill "$timer" 2>/dev/null; rm -rf "$work"' EXIT
+
+${CC:-cc} -O2 -o "$work/pomodoro" "$tests/../pomodoro.c"
+
+# The stub comes first on PATH; the chimes go to true, so only sketchybar runs are logged
+mkdir "$work/bin"
+ln -s "$tests/stub-sketchybar" "$work/bin/sketchybar"
+ln -s "$(command -v true)" "$work/bin/afplay"
+STUB_SKETCHYBAR_LOG="$work/sketchybar.log"
+export STUB_SKETCHYBAR_LOG
+: > "$STUB_SKETCHYBAR_LOG"
+
+work_icon=$(printf '\342\214\233')     # U+231B, WORK_TIMER_ICON
+break_icon=$(printf '\342\232\223')    # U+2693, BREAK_TIMER_ICON
+expected_spawns=61
+
+seconds=60
+while [ "$seconds" -gt 0 ]
+do
+    printf -- '--set pomodoro label=%02d:%02d icon=%s drawing=on --set pomodoro.divider drawing=on\n' \
+        $((seconds / 60)) $((seconds % 60)) "$work_icon"
+    seconds=$((seconds - 1))
+done > "$work/expected.log"
+printf -- '--set pomodoro label=01:00 icon=%s drawing=on --set pomodoro.divider drawing=on\n' \
+    "$break_icon" >> "$work/expected.log"
+
+PATH="$work/bin:$PATH" "$work/pomodoro" --sink sketchybar 1 1 &
+timer=$!
+
+# Stop once the break has been shown, or give up well after it should have been
+waited=0
+while [ "$(wc -l < "$STUB_SKETCHYBAR_LOG")" -lt "$expected_spawns" ] && [ "$waited" -lt 75 ]
+do
+    sleep 1
+    waited=$((waited + 1))
+done
+kill "$timer"
+wait "$timer" || true
+timer=
+
+# The break's 00:59 may have been spawned before the timer stopped; it is not checked
+if ! head -n "$expected_spawns" "$STUB_SKETCHYBAR_LOG" | cmp -s - "$work/expected.log"
+then
+    echo "sketchybar updates differ from the expected sequence:" >&2
+    head -n "$expected_spawns" "$STUB_SKETCHYBAR_LOG" | diff "$work/expected.log" - >&2 || true
+    exit 1
+fi
+
+echo "sketchybar spawned $expected_spawns times, once per label change"